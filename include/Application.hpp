@@ -1,26 +1,188 @@
 #pragma once
 
+#include "Benchmark/BenchmarkReport.hpp"
+
+#include "Graphics/CameraPath.hpp"
+#include "Graphics/GpuProfiler.hpp"
 #include "Graphics/Model.hpp"
 #include "Graphics/OrbitCamera.hpp"
 #include "Graphics/Renderer.hpp"
+#include "Graphics/SyntheticSceneGenerator.hpp"
 
 #include "Graphics/Vulkan/VulkanImage.hpp"
 #include "Graphics/Vulkan/VulkanImageView.hpp"
 
+#include "Profiling/LatencyTracker.hpp"
+
 #include <GLFW/glfw3.h>
 
 #include <glm/glm.hpp>
 
+#include <string>
+
 /**
  * Application class
  */
 class Application
 {
+public:
+    /**
+     * Struct containing the options the application was launched with
+     */
+    struct LaunchOptions
+    {
+        /**
+         * Flag indicating whether to render into offscreen images without creating a window
+         */
+        bool headless = false;
+
+        /**
+         * Path of the model to load on startup. Empty if no model should be loaded.
+         */
+        std::string modelFilePath;
+
+        /**
+         * Flag indicating whether to generate a synthetic scene on startup instead of loading a model
+         */
+        bool useSyntheticScene = false;
+
+        /**
+         * Size of the synthetic scene to generate on startup
+         */
+        SyntheticSceneGenerator::Settings syntheticScene;
+
+        /**
+         * Number of frames to render before exiting in headless mode
+         */
+        uint32_t frameCount = 100;
+
+        /**
+         * Number of frames the CPU may record ahead of the GPU. Independent of the number of swapchain images.
+         */
+        uint32_t framesInFlight = 2;
+
+        /**
+         * Number of threads recording the draws. With more than one thread, the draws are split into chunks
+         * recorded into secondary command buffers.
+         */
+        uint32_t recordingThreads = 1;
+
+        /**
+         * Width of the offscreen images in headless mode
+         */
+        uint32_t width = 800;
+
+        /**
+         * Height of the offscreen images in headless mode
+         */
+        uint32_t height = 600;
+
+        /**
+         * Path of the PPM file to write the last rendered frame into in headless mode. Empty if nothing should be written.
+         */
+        std::string outputImagePath;
+
+        /**
+         * Path of the camera path to play back over the frames in headless mode. Empty if the camera should not
+         * follow a recorded path.
+         */
+        std::string cameraPathFilePath;
+
+        /**
+         * Path of the CSV or JSON file to write per-frame benchmark results into in headless mode. Empty if not benchmarking.
+         * When benchmarking without a recorded camera path, the camera orbits the model.
+         */
+        std::string benchmarkOutputPath;
+
+        /**
+         * Path of the file to record the camera path into while the viewer is running. Empty if nothing should be recorded.
+         */
+        std::string recordedCameraPathFilePath;
+
+        /**
+         * Path of the Chrome trace JSON file to write the CPU profiler zones into on exit. Empty if nothing should be written.
+         */
+        std::string cpuTraceOutputPath;
+
+        /**
+         * Path of the JSON file to write the renderer statistics into on exit. Empty if nothing should be written.
+         */
+        std::string statisticsOutputPath;
+
+        /**
+         * Number of frames between periodic writes of the renderer statistics. 0 means only on exit.
+         */
+        uint32_t statisticsInterval = 0;
+
+        /**
+         * Flag indicating whether every mesh should be drawn with the alpha test, instead of drawing
+         * the opaque meshes with discard-free pipelines first. Used to measure the split.
+         */
+        bool disableAlphaMaskSplit = false;
+
+        /**
+         * Flag indicating whether the viewer starts in idle mode, where frames are only rendered when input,
+         * window events, finished texture loads or camera movement change what would be shown
+         */
+        bool idleMode = false;
+
+        /**
+         * Flag indicating whether the viewer starts in low-latency mode, where it waits for the frame slot first
+         * and samples the input right before recording the frame
+         */
+        bool lowLatency = false;
+
+        /**
+         * Maximum number of frames rendered per second by the viewer. 0 means unlimited.
+         */
+        float frameRateLimit = 0.0f;
+
+        /**
+         * Present mode of the viewer's swapchain. Falls back to VK_PRESENT_MODE_FIFO_KHR, which every device supports,
+         * if the mode is not available.
+         */
+        VkPresentModeKHR presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+
+        /**
+         * Minimum number of images in the viewer's swapchain, clamped to the surface limits.
+         * 0 means one more than the surface minimum.
+         */
+        uint32_t swapchainImageCount = 0;
+
+        /**
+         * Flag indicating whether the viewer lowers the resolution of the model pass while the camera is moved,
+         * to hold the target frame time
+         */
+        bool dynamicResolution = false;
+
+        /**
+         * GPU frame time that dynamic resolution aims for (in milliseconds)
+         */
+        float targetFrameTime = 16.7f;
+
+        /**
+         * Lowest resolution scale dynamic resolution may render the model pass at, relative to the window size
+         */
+        float minRenderScale = 0.5f;
+
+        /**
+         * Highest resolution scale dynamic resolution may render the model pass at while the camera is moved
+         */
+        float maxRenderScale = 1.0f;
+
+        /**
+         * Function returning the number of heap allocations made so far, used to count the allocations
+         * of each benchmarked frame. Null if heap allocations are not tracked.
+         */
+        uint64_t (*allocationCounter)() = nullptr;
+    };
+
 public:
     /**
      * @brief Constructor
+     * @param[in] launchOptions Options the application was launched with
      */
-    Application();
+    Application(const LaunchOptions& launchOptions = {});
 
     /**
      * @brief Destructor
@@ -32,7 +194,144 @@ public:
      */
     void Run();
 
+    /**
+     * @brief Parses command line arguments into launch options.
+     * @param[in] argc Number of arguments
+     * @param[in] argv Arguments
+     * @param[in,out] outLaunchOptions Launch options. Options that are not specified keep their value.
+     * @return Returns true if all the arguments were valid. Returns false otherwise.
+     */
+    static bool ParseLaunchOptions(int argc, char** argv, LaunchOptions& outLaunchOptions);
+
+    /**
+     * @brief Prints the command line arguments understood by ParseLaunchOptions.
+     * @param[in] programName Name of the executable
+     */
+    static void PrintUsage(const std::string& programName);
+
+    /**
+     * @brief Parses a present mode name, as accepted on the command line.
+     * @param[in] name Present mode name (fifo, fifo-relaxed, mailbox or immediate)
+     * @param[out] outPresentMode Present mode
+     * @return Returns true if the name is a known present mode. Returns false otherwise.
+     */
+    static bool ParsePresentMode(const std::string& name, VkPresentModeKHR& outPresentMode);
+
+    /**
+     * @brief Gets the name of a present mode, as accepted on the command line.
+     * @param[in] presentMode Present mode
+     * @return Present mode name. Returns "unknown" for modes that cannot be selected.
+     */
+    static const char* GetPresentModeName(VkPresentModeKHR presentMode);
+
 private:
+    /**
+     * Struct containing the frame pacing measured with one swapchain configuration
+     */
+    struct PresentModeStatistics
+    {
+        /**
+         * Present mode of the swapchain
+         */
+        VkPresentModeKHR presentMode;
+
+        /**
+         * Number of images in the swapchain
+         */
+        uint32_t imageCount;
+
+        /**
+         * Number of measured frame times
+         */
+        uint64_t numFrames;
+
+        /**
+         * Mean of the times between consecutive presents (in milliseconds)
+         */
+        double frameTimeMean;
+
+        /**
+         * Sum of the squared differences of the frame times from their mean, used to compute the variance incrementally
+         */
+        double frameTimeSquaredDeviations;
+
+        /**
+         * Number of latency samples completed with the configuration
+         */
+        uint64_t numLatencySamples;
+
+        /**
+         * Sum of the input-to-submit latencies (in milliseconds)
+         */
+        double totalInputToSubmit;
+
+        /**
+         * Sum of the submit-to-present latencies (in milliseconds)
+         */
+        double totalSubmitToPresent;
+    };
+
+    /**
+     * Swapchain objects that were replaced by a recreation but may still be used by frames in flight
+     */
+    struct RetiredSwapchain
+    {
+        /**
+         * Replaced swapchain, which was passed as the old swapchain when creating its replacement
+         */
+        VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+
+        /**
+         * Image views of the replaced swapchain
+         */
+        std::vector<VulkanImageView> imageViews;
+
+        /**
+         * Framebuffers of the replaced swapchain
+         */
+        std::vector<VkFramebuffer> framebuffers;
+
+        /**
+         * Depth buffer image sized for the replaced swapchain
+         */
+        VulkanImage depthBufferImage;
+
+        /**
+         * Depth buffer image view sized for the replaced swapchain
+         */
+        VulkanImageView depthBufferImageView;
+
+        /**
+         * Render targets the model pass was rendered into at a reduced resolution for the replaced swapchain
+         */
+        std::vector<VulkanImage> renderTargetImages;
+
+        /**
+         * Image views of the reduced resolution render targets
+         */
+        std::vector<VulkanImageView> renderTargetImageViews;
+
+        /**
+         * Framebuffers of the reduced resolution render targets
+         */
+        std::vector<VkFramebuffer> renderTargetFramebuffers;
+
+        /**
+         * Render passes, if they had to be replaced because the image format changed. Empty otherwise.
+         */
+        std::vector<VkRenderPass> renderPasses;
+
+        /**
+         * Last graphics queue submission made before the swapchain was replaced
+         */
+        uint64_t submission = 0;
+    };
+
+    /**
+     * Options the application was launched with
+     */
+    LaunchOptions m_launchOptions;
+
     /**
      * Handle to the GLFW window
      */
@@ -54,14 +353,14 @@ private:
     std::vector<VkSemaphore> m_vkRenderFinishedSemaphores;
 
     /**
-     * Vulkan fences to indicate that the frame is currently in flight
+     * Graphics queue submission of the last frame recorded in each frame slot, used to wait for the slot to become free
      */
-    std::vector<VkFence> m_vkFrameInFlightFences;
+    std::vector<uint64_t> m_frameSubmissions;
 
     /**
-     * Vulkan fances to indicate that the image is currently associated with a frame that is currently in flight
+     * Graphics queue submission of the last frame rendered into each swapchain image
      */
-    std::vector<VkFence> m_vkImageInFlightFences;
+    std::vector<uint64_t> m_imageSubmissions;
 
     /**
      * Vulkan command pool
@@ -74,10 +373,15 @@ private:
     VkSwapchainKHR m_vkSwapchain;
 
     /**
-     * Vulkan swapchain images
+     * Vulkan swapchain images. In headless mode, these are the handles of the offscreen color images.
      */
     std::vector<VkImage> m_vkSwapchainImages;
 
+    /**
+     * Offscreen color images that are rendered into in place of the swapchain images in headless mode
+     */
+    std::vector<VulkanImage> m_offscreenColorImages;
+
     /**
      * Vulkan swapchain image views
      */
@@ -93,11 +397,36 @@ private:
      */
     VkExtent2D m_vkSwapchainImageExtent;
 
+    /**
+     * Present mode the swapchain was created with
+     */
+    VkPresentModeKHR m_vkSwapchainPresentMode;
+
+    /**
+     * Present modes supported by the surface
+     */
+    std::vector<VkPresentModeKHR> m_availablePresentModes;
+
+    /**
+     * Minimum number of swapchain images supported by the surface
+     */
+    uint32_t m_minSwapchainImageCount;
+
+    /**
+     * Maximum number of swapchain images supported by the surface. 0 means there is no maximum.
+     */
+    uint32_t m_maxSwapchainImageCount;
+
     /**
      * Vulkan command buffers
      */
     std::vector<VkCommandBuffer> m_vkCommandBuffers;
 
+    /**
+     * Secondary command buffers the ImGui overlay is recorded into when the draws are recorded in parallel (One per frame in flight)
+     */
+    std::vector<VkCommandBuffer> m_vkImGuiCommandBuffers;
+
     /**
      * Vulkan image for the depth buffer
      */
@@ -113,13 +442,46 @@ private:
      */
     VkRenderPass m_vkRenderPass;
 
+    /**
+     * Render pass that draws the model into a reduced resolution render target and leaves it ready to be upscaled.
+     * Compatible with the main render pass.
+     */
+    VkRenderPass m_vkScenePass;
+
+    /**
+     * Render pass that draws the overlay on top of an upscaled swapchain image, keeping its contents.
+     * Compatible with the main render pass.
+     */
+    VkRenderPass m_vkOverlayPass;
+
     /**
      * Vulkan swapchain framebuffers
      */
     std::vector<VkFramebuffer> m_vkSwapchainFramebuffers;
 
     /**
-     * Maximum number of frames in flight
+     * Swapchains replaced by recreations whose objects are destroyed once the frames using them have completed
+     */
+    std::vector<RetiredSwapchain> m_retiredSwapchains;
+
+    /**
+     * Window-sized color images the model pass is rendered into at a reduced resolution (One per frame in flight).
+     * Created the first time they are needed.
+     */
+    std::vector<VulkanImage> m_renderTargetImages;
+
+    /**
+     * Image views of the reduced resolution render targets
+     */
+    std::vector<VulkanImageView> m_renderTargetImageViews;
+
+    /**
+     * Framebuffers of the reduced resolution render targets, sharing the depth buffer
+     */
+    std::vector<VkFramebuffer> m_renderTargetFramebuffers;
+
+    /**
+     * Maximum number of frames in flight. Per-frame resources are indexed by frame slot, not by swapchain image.
      */
     uint32_t m_maxFramesInFlight;
 
@@ -140,8 +502,195 @@ private:
      */
     glm::mat4 m_currentModelTransform;
 
+    /**
+     * Transformation matrices of the instances of the current model, applied after the model transform.
+     * Empty if the model is drawn once.
+     */
+    std::vector<glm::mat4> m_instanceTransforms;
+
+    /**
+     * Import options applied to the next model that is dropped onto the window
+     */
+    Model::ImportOptions m_importOptions;
+
+    /**
+     * Camera path that is played back in headless mode, or recorded while the viewer is running
+     */
+    CameraPath m_cameraPath;
+
+    /**
+     * Longest time headless mode keeps rendering after the last frame for texture streaming to settle
+     * before it saves the output image (in seconds)
+     */
+    const double HEADLESS_STREAMING_TIMEOUT = 30.0;
+
+    /**
+     * Measures the GPU time of the upload, model and UI passes of each frame
+     */
+    GpuProfiler m_gpuProfiler;
+
     VkDescriptorPool m_vkImguiPool;
 
+    /**
+     * Number of frames rendered after the frame is invalidated in idle mode. ImGui only reacts
+     * to input in the frame after it arrives, so a single frame is not enough.
+     */
+    const uint32_t IDLE_SETTLE_FRAMES = 3;
+
+    /**
+     * Longest time to wait for events in idle mode (in seconds), which bounds how long
+     * changes that post no event can go unnoticed
+     */
+    const double IDLE_WAIT_TIMEOUT = 0.5;
+
+    /**
+     * Flag indicating whether frames are only rendered when something invalidates them
+     */
+    bool m_isIdleModeEnabled;
+
+    /**
+     * Number of frames that still have to be rendered before the viewer may go idle
+     */
+    uint32_t m_numFramesToRender;
+
+    /**
+     * Total time spent waiting for events in idle mode (in seconds)
+     */
+    double m_idleTime;
+
+    /**
+     * Duration of the last wait for events in idle mode (in seconds)
+     */
+    double m_lastIdleDuration;
+
+    /**
+     * Number of frames rendered by the viewer
+     */
+    uint64_t m_numRenderedFrames;
+
+    /**
+     * Number of times the viewer woke up in idle mode without having to render a frame
+     */
+    uint64_t m_numIdleWakeups;
+
+    /**
+     * Time at which the viewer started rendering (in seconds, as returned by glfwGetTime)
+     */
+    double m_runStartTime;
+
+    /**
+     * Time before a frame deadline (in seconds) from which the frame limiter spins instead of sleeping,
+     * since sleeps can overshoot by about a millisecond
+     */
+    const double FRAME_LIMITER_SPIN_TIME = 0.002;
+
+    /**
+     * Flag indicating whether the viewer waits for the frame slot before sampling the input, instead of
+     * sampling it at the end of the previous frame
+     */
+    bool m_isLowLatencyModeEnabled;
+
+    /**
+     * Maximum number of frames rendered per second. 0 means unlimited.
+     */
+    float m_frameRateLimit;
+
+    /**
+     * Time at which the frame limiter lets the next frame start (in seconds, as returned by glfwGetTime)
+     */
+    double m_nextFrameTime;
+
+    /**
+     * Time at which the input used by the next frame was last sampled (in seconds, as returned by glfwGetTime)
+     */
+    double m_inputSampleTime;
+
+    /**
+     * Estimates the input-to-submit and submit-to-present latency of each frame
+     */
+    LatencyTracker m_latencyTracker;
+
+    /**
+     * Present mode requested for the swapchain
+     */
+    VkPresentModeKHR m_requestedPresentMode;
+
+    /**
+     * Minimum number of images requested for the swapchain. 0 means one more than the surface minimum.
+     */
+    uint32_t m_requestedSwapchainImageCount;
+
+    /**
+     * Flag indicating whether the requested present mode or image count changed since the swapchain was created
+     */
+    bool m_wasSwapchainSettingChanged;
+
+    /**
+     * Frame pacing measured with each swapchain configuration used so far
+     */
+    std::vector<PresentModeStatistics> m_presentModeStatistics;
+
+    /**
+     * Time of the last present (in seconds, as returned by glfwGetTime). 0 if the next frame time should not be measured.
+     */
+    double m_lastPresentTime;
+
+    /**
+     * Number of latency samples already added to the present mode statistics
+     */
+    uint64_t m_numRecordedLatencySamples;
+
+    /**
+     * Fraction of the distance to the ideal resolution scale that the scale moves each frame,
+     * which keeps a single slow frame from making the resolution jump
+     */
+    const float RENDER_SCALE_DAMPING = 0.2f;
+
+    /**
+     * Flag indicating whether the swapchain images can be the destination of a filtered blit from a render target
+     */
+    bool m_isDynamicResolutionSupported;
+
+    /**
+     * Flag indicating whether the model pass is rendered at a reduced resolution while the camera is moved
+     */
+    bool m_isDynamicResolutionEnabled;
+
+    /**
+     * GPU frame time that dynamic resolution aims for (in milliseconds)
+     */
+    float m_targetFrameTime;
+
+    /**
+     * Lowest resolution scale of the model pass
+     */
+    float m_minRenderScale;
+
+    /**
+     * Highest resolution scale of the model pass while the camera is moved
+     */
+    float m_maxRenderScale;
+
+    /**
+     * Resolution scale chosen from the GPU frame times, used while the camera is moved
+     */
+    float m_renderScale;
+
+    /**
+     * Resolution scale the last frame recorded in each frame slot was rendered at
+     */
+    std::vector<float> m_frameRenderScales;
+
+    /**
+     * GPU time of the last frame used to choose the resolution scale (in milliseconds)
+     */
+    float m_lastGpuFrameTime;
+
+    /**
+     * View matrix of the last recorded frame, used to detect camera movement
+     */
+    glm::mat4 m_previousViewMatrix;
+
 private:
     /**
      * @brief Initializes the application.
@@ -150,6 +699,23 @@ private:
      */
     bool Initialize();
 
+    /**
+     * @brief Renders the requested number of frames into the offscreen images and reports the frame times.
+     */
+    void RunHeadless();
+
+    /**
+     * @brief Loads a model, replacing the current one, and scales it to fit the view.
+     * @param[in] filePath Model file path
+     */
+    void LoadModel(const std::string& filePath);
+
+    /**
+     * @brief Generates a synthetic scene, replacing the current model.
+     * @param[in] settings Scene size
+     */
+    void LoadSyntheticScene(const SyntheticSceneGenerator::Settings& settings);
+
     /**
      * @brief Updates the application's state.
      * @param[in] deltaTime Time elapsed since the previous frame.
@@ -157,11 +723,142 @@ private:
     void Update(float deltaTime);
 
     /**
-     * @brief Renders the next frame.
+     * @brief Renders the model.
+     * @param[in] commandBuffer Command buffer, inside the render pass
+     * @param[in] frameIndex Index of the frame in flight
+     * @param[in] extent Size of the area to render into
+     */
+    void Render(VkCommandBuffer commandBuffer, uint32_t frameIndex, const VkExtent2D& extent);
+
+    /**
+     * @brief Renders the ImGui overlay, through a secondary command buffer when the draws are recorded in parallel.
+     * Does nothing in headless mode.
+     * @param[in] commandBuffer Command buffer, inside the render pass
+     * @param[in] frameIndex Index of the frame in flight
+     */
+    void RenderOverlay(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+    /**
+     * @brief Records the model pass into the frame's reduced resolution render target, upscales it into a swapchain image
+     * and records the overlay on top.
      * @param[in] commandBuffer Command buffer
-     * @param[in] imageIndex Frame index
+     * @param[in] frameIndex Index of the frame in flight
+     * @param[in] imageIndex Index of the swapchain image
+     * @param[in] renderScale Resolution scale of the model pass
+     * @return Returns true if the passes were recorded. Returns false otherwise.
      */
-    void Render(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+    bool RecordScaledPasses(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t imageIndex, const float& renderScale);
+
+    /**
+     * @brief Updates the resolution scale from the GPU time of the frame slot's previous frame, and picks the scale of the next frame.
+     * The next frame is rendered at full resolution unless dynamic resolution is enabled and the camera is being moved.
+     * @param[in] frameIndex Index of the frame in flight
+     * @return Resolution scale of the next frame
+     */
+    float UpdateRenderScale(uint32_t frameIndex);
+
+    /**
+     * @brief Draws the overlay window with the dynamic resolution settings and the current resolution.
+     */
+    void DrawDynamicResolutionWindow();
+
+    /**
+     * @brief Builds the ImGui overlay and records its draws.
+     * @param[in] commandBuffer Command buffer, inside the render pass
+     */
+    void RenderImGui(VkCommandBuffer commandBuffer);
+
+    /**
+     * @brief Fills the renderer's batch with the current model and updates texture streaming.
+     * @param[in] frameIndex Index of the frame in flight
+     */
+    void PrepareRenderBatch(uint32_t frameIndex);
+
+    /**
+     * @brief Draws the overlay window with the GPU time of each profiled pass.
+     */
+    void DrawGpuProfilerWindow();
+
+    /**
+     * @brief Draws the overlay window with a flame chart of the CPU zones of the last frame.
+     */
+    void DrawCpuProfilerWindow();
+
+    /**
+     * @brief Draws the overlay window with the renderer's frame and memory statistics.
+     */
+    void DrawRendererStatisticsWindow();
+
+    /**
+     * @brief Draws the overlay window with the idle mode toggle and the time spent idle.
+     */
+    void DrawIdleModeWindow();
+
+    /**
+     * @brief Draws the overlay window with the low-latency mode toggle, the frame rate limit and the frame latencies.
+     */
+    void DrawLatencyWindow();
+
+    /**
+     * @brief Draws the overlay window with the present mode and image count controls and the frame pacing measured with each.
+     */
+    void DrawSwapchainWindow();
+
+    /**
+     * @brief Adds the time since the previous present and the newly completed latency samples to the statistics
+     * of the current swapchain configuration.
+     */
+    void RecordPresentModeStatistics();
+
+    /**
+     * @brief Polls the window events, which updates the input used by the next frame.
+     */
+    void SampleInput();
+
+    /**
+     * @brief Blocks until the frame rate limit lets the next frame start. Returns immediately if there is no limit.
+     */
+    void WaitForFrameLimit();
+
+    /**
+     * @brief Makes the viewer render the next few frames in idle mode.
+     */
+    void InvalidateFrame();
+
+    /**
+     * @brief Invalidates the frame if input was received, a key is held down (e.g., moving the camera),
+     * or texture streaming needs more frames.
+     */
+    void CheckFrameInvalidation();
+
+    /**
+     * @brief Writes the renderer statistics into the statistics output file, or a default file if none was specified.
+     */
+    void WriteRendererStatistics();
+
+    /**
+     * @brief Records the commands for rendering the next frame.
+     * @param[in] commandBuffer Command buffer
+     * @param[in] frameIndex Index of the frame in flight, which selects the per-frame resources
+     * @param[in] imageIndex Index of the image to render into
+     * @return Returns true if the commands were recorded successfully. Returns false otherwise.
+     */
+    bool RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t imageIndex);
+
+    /**
+     * @brief Copies the GPU times of the last collected use of a command buffer into a benchmark sample.
+     * @param[in] frameIndex Index of the frame in flight the command buffer belongs to
+     * @param[out] outSample Benchmark sample. The GPU time is set to -1 if it is unavailable.
+     */
+    void GetFrameGpuTimes(uint32_t frameIndex, BenchmarkReport::FrameSample& outSample);
+
+    /**
+     * @brief Copies an offscreen color image to the CPU and writes it into a PPM file.
+     * @param[in] imageIndex Index of the offscreen color image
+     * @param[in] filePath Output file path
+     * @return Returns true if the image was written successfully. Returns false otherwise.
+     */
+    bool SaveOffscreenImage(uint32_t imageIndex, const std::string& filePath);
 
     /**
      * @brief Cleans up resources used by the application.
@@ -222,6 +919,12 @@ private:
      */
     bool InitSwapchain();
 
+    /**
+     * @brief Initializes the offscreen color images used in place of the swapchain in headless mode.
+     * @return Returns true if the initialization was successful. Returns false otherwise.
+     */
+    bool InitOffscreenTargets();
+
     /**
      * @brief Initializes the Vulkan synchronization tools.
      * @return Returns true if the initialization was successful. Returns false otherwise.
@@ -258,6 +961,12 @@ private:
      */
     bool InitFramebuffers();
 
+    /**
+     * @brief Initializes the render targets the model pass is rendered into at a reduced resolution.
+     * @return Returns true if the initialization was successful. Returns false otherwise.
+     */
+    bool InitRenderTargets();
+
     /**
      * @brief Recreates the Vulkan swapchain and the related objects.
      * @return Returns true if the swapchain was successfully recreated. Returns false otherwise.
@@ -269,6 +978,28 @@ private:
      */
     void CleanupSwapchain();
 
+    /**
+     * @brief Destroys the objects of retired swapchains that are no longer used by any frame.
+     * @param[in] isDeviceIdle Flag indicating whether the device is idle, in which case every retired swapchain is destroyed
+     */
+    void DestroyRetiredSwapchains(const bool& isDeviceIdle);
+
+    /**
+     * @brief Parses a command line value as an unsigned 32-bit integer.
+     * @param[in] text Value text. Must consist of decimal digits only.
+     * @param[out] outValue Parsed value. Left unchanged if the text is not valid.
+     * @return Returns true if the whole text is a number that fits in 32 bits. Returns false otherwise.
+     */
+    static bool ParseUnsigned(const char* text, uint32_t& outValue);
+
+    /**
+     * @brief Parses a command line value as a finite floating-point number.
+     * @param[in] text Value text
+     * @param[out] outValue Parsed value. Left unchanged if the text is not valid.
+     * @return Returns true if the whole text is a finite number. Returns false otherwise.
+     */
+    static bool ParseFloat(const char* text, float& outValue);
+
     /**
      * @brief Callback function for when the framebuffer was resized.
      * @param[in] window Reference to the window that was resized
@@ -277,6 +1008,12 @@ private:
      */
     static void FramebufferResizeCallback(GLFWwindow* window, int width, int height);
 
+    /**
+     * @brief Callback function for when the contents of the window need to be redrawn (e.g., after being uncovered).
+     * @param[in] window Reference to the window that needs to be redrawn
+     */
+    static void WindowRefreshCallback(GLFWwindow* window);
+
     /**
      * @brief Callback function for when a key event was generated.
      * @param[in] window Reference to the window that generated the event
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Collects per-frame measurements of a rendering benchmark and writes them out with percentile summaries
+ */
+class BenchmarkReport
+{
+public:
+    /**
+     * Struct containing the measurements of a single frame
+     */
+    struct FrameSample
+    {
+        /**
+         * Wall time between the start of this frame and the start of the next one (in milliseconds)
+         */
+        double frameTime;
+
+        /**
+         * CPU time spent updating and recording the frame (in milliseconds)
+         */
+        double cpuTime;
+
+        /**
+         * GPU time spent executing the frame's command buffer (in milliseconds). Negative if unavailable.
+         */
+        double gpuTime;
+
+        /**
+         * Number of draw calls
+         */
+        uint32_t drawCount;
+
+        /**
+         * Number of triangles submitted
+         */
+        uint32_t triangleCount;
+
+        /**
+         * Number of visible meshes that were not drawn because they did not fit in the per-frame buffers
+         */
+        uint32_t droppedDrawCount;
+
+        /**
+         * Number of heap allocations made while recording the frame. 0 if allocations are not tracked.
+         */
+        uint64_t allocationCount;
+
+        /**
+         * Name and GPU time (in milliseconds) of each profiled region of the frame, in the order the regions began
+         */
+        std::vector<std::pair<std::string, double>> gpuScopeTimes;
+    };
+
+public:
+    /**
+     * @brief Constructor
+     * @param[in] name Name of the benchmark (e.g., the model file path)
+     */
+    BenchmarkReport(const std::string& name);
+
+    /**
+     * @brief Destructor
+     */
+    ~BenchmarkReport();
+
+    /**
+     * @brief Resizes the report to hold the specified number of frames. New frames are zeroed.
+     * @param[in] numFrames Number of frames
+     */
+    void SetFrameCount(const size_t& numFrames);
+
+    /**
+     * @brief Gets the measurements of a frame so that they can be filled in.
+     * @param[in] frameIndex Frame index
+     * @return Reference to the measurements of the frame
+     */
+    FrameSample& GetFrame(const size_t& frameIndex);
+
+    /**
+     * @brief Prints the percentile summaries to the standard output.
+     */
+    void PrintSummary() const;
+
+    /**
+     * @brief Writes the per-frame measurements and the summaries into a file. Files ending with ".json" are
+     * written as JSON, anything else as CSV.
+     * @param[in] filePath Output file path
+     * @return Returns true if the file was written successfully. Returns false otherwise.
+     */
+    bool WriteToFile(const std::string& filePath) const;
+
+    /**
+     * @brief Computes a percentile of a set of values using linear interpolation between the closest ranks.
+     * @param[in] values Values. Does not need to be sorted.
+     * @param[in] percentile Percentile to compute, from 0 to 100
+     * @return Value at the percentile. Returns 0 if there are no values.
+     */
+    static double ComputePercentile(std::vector<double> values, const double& percentile);
+
+    /**
+     * @brief Escapes a string for use inside a JSON string literal.
+     * @param[in] text Text to escape
+     * @return Escaped text
+     */
+    static std::string EscapeJSON(const std::string& text);
+
+private:
+    /**
+     * Struct containing the summary of one measured quantity
+     */
+    struct Summary
+    {
+        /**
+         * Average value
+         */
+        double average;
+
+        /**
+         * 50th percentile (median)
+         */
+        double p50;
+
+        /**
+         * 95th percentile
+         */
+        double p95;
+
+        /**
+         * 99th percentile
+         */
+        double p99;
+
+        /**
+         * Maximum value
+         */
+        double max;
+    };
+
+    /**
+     * Name of the benchmark
+     */
+    std::string m_name;
+
+    /**
+     * Measurements of each frame
+     */
+    std::vector<FrameSample> m_frames;
+
+private:
+    /**
+     * @brief Summarizes one measured quantity over all frames. Negative values are treated as missing.
+     * @param[in] member Pointer to the measured quantity in FrameSample
+     * @return Summary of the quantity
+     */
+    Summary Summarize(double FrameSample::* member) const;
+
+    /**
+     * @brief Summarizes the GPU time of one profiled region over all frames. Frames without the region are skipped.
+     * @param[in] scopeName Name of the profiled region
+     * @return Summary of the region's GPU time
+     */
+    Summary SummarizeGpuScope(const std::string& scopeName) const;
+
+    /**
+     * @brief Summarizes a set of values.
+     * @param[in] values Values
+     * @return Summary of the values
+     */
+    static Summary SummarizeValues(const std::vector<double>& values);
+
+    /**
+     * @brief Gets the names of the profiled regions that appear in any frame.
+     * @return Region names, in the order they were first seen
+     */
+    std::vector<std::string> GetGpuScopeNames() const;
+
+    /**
+     * @brief Finds the GPU time of a profiled region in a frame.
+     * @param[in] frame Frame measurements
+     * @param[in] scopeName Name of the profiled region
+     * @return GPU time of the region (in milliseconds). Returns -1 if the frame does not have the region.
+     */
+    static double FindGpuScopeTime(const FrameSample& frame, const std::string& scopeName);
+
+    /**
+     * @brief Writes the report in CSV format.
+     * @param[in] filePath Output file path
+     * @return Returns true if the file was written successfully. Returns false otherwise.
+     */
+    bool WriteCSV(const std::string& filePath) const;
+
+    /**
+     * @brief Writes the report in JSON format.
+     * @param[in] filePath Output file path
+     * @return Returns true if the file was written successfully. Returns false otherwise.
+     */
+    bool WriteJSON(const std::string& filePath) const;
+};
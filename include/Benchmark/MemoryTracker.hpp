@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Tracks heap allocations made through operator new, and the peak resident set size of the process.
+ * Allocation tracking is only active in executables that link MemoryTracker.cpp, since it replaces the
+ * global operator new and operator delete.
+ */
+namespace MemoryTracker
+{
+    /**
+     * Struct containing heap allocation counters
+     */
+    struct AllocationCounters
+    {
+        /**
+         * Number of allocations
+         */
+        uint64_t numAllocations;
+
+        /**
+         * Total number of bytes allocated
+         */
+        uint64_t allocatedBytes;
+
+        /**
+         * Highest number of bytes that were allocated at the same time
+         */
+        uint64_t peakBytes;
+    };
+
+    /**
+     * @brief Resets the allocation counters. The peak starts from the number of bytes that are currently allocated.
+     */
+    extern void ResetAllocationCounters();
+
+    /**
+     * @brief Gets the allocation counters accumulated since the last reset.
+     * @return Allocation counters
+     */
+    extern AllocationCounters GetAllocationCounters();
+
+    /**
+     * @brief Resets the peak resident set size of the process to its current resident set size.
+     * @return Returns true if the peak was reset. Returns false if the platform does not support it.
+     */
+    extern bool ResetPeakResidentSetSize();
+
+    /**
+     * @brief Gets the peak resident set size of the process since the last reset.
+     * @return Peak resident set size (in bytes). Returns 0 if the platform does not support it.
+     */
+    extern uint64_t GetPeakResidentSetSize();
+}
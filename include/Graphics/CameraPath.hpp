@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Graphics/OrbitCamera.hpp"
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+/**
+ * Sequence of orbit camera keyframes that can be recorded, saved, loaded and played back
+ */
+class CameraPath
+{
+public:
+    /**
+     * Struct containing the state of the orbit camera at one point of the path
+     */
+    struct Keyframe
+    {
+        /**
+         * Yaw (in degrees)
+         */
+        float yaw;
+
+        /**
+         * Pitch (in degrees)
+         */
+        float pitch;
+
+        /**
+         * Distance from the look target to the camera
+         */
+        float orbitDistance;
+
+        /**
+         * Look target
+         */
+        glm::vec3 lookTarget;
+    };
+
+public:
+    /**
+     * @brief Constructor
+     */
+    CameraPath();
+
+    /**
+     * @brief Destructor
+     */
+    ~CameraPath();
+
+    /**
+     * @brief Appends the current state of an orbit camera to the end of the path.
+     * @param[in] camera Orbit camera
+     */
+    void AddKeyframe(OrbitCamera& camera);
+
+    /**
+     * @brief Replaces the path with a procedurally generated orbit: one full turn around the look target
+     * while the pitch and orbit distance sway back and forth.
+     * @param[in] numKeyframes Number of keyframes to generate
+     */
+    void GenerateOrbit(const uint32_t& numKeyframes);
+
+    /**
+     * @brief Applies the state at a point of the path to an orbit camera, interpolating between keyframes.
+     * @param[in] t Point of the path, from 0 (first keyframe) to 1 (last keyframe)
+     * @param[out] outCamera Orbit camera
+     */
+    void Apply(const float& t, OrbitCamera& outCamera) const;
+
+    /**
+     * @brief Checks whether the path has no keyframes.
+     * @return Returns true if the path has no keyframes. Returns false otherwise.
+     */
+    bool IsEmpty() const;
+
+    /**
+     * @brief Loads a path from a text file with one "yaw pitch orbitDistance lookTargetX lookTargetY lookTargetZ" keyframe per line.
+     * @param[in] filePath File path
+     * @return Returns true if the path was loaded successfully. Returns false otherwise.
+     */
+    bool LoadFromFile(const std::string& filePath);
+
+    /**
+     * @brief Saves the path into a text file in the format read by LoadFromFile.
+     * @param[in] filePath File path
+     * @return Returns true if the path was saved successfully. Returns false otherwise.
+     */
+    bool SaveToFile(const std::string& filePath) const;
+
+private:
+    /**
+     * Keyframes of the path, in playback order
+     */
+    std::vector<Keyframe> m_keyframes;
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Linear allocator for transient CPU-side data that lives for one frame. Allocations bump a pointer
+ * through a single block and are all released at once by Reset, so steady-state frames do not touch the heap.
+ * When a frame needs more than the block holds, the extra allocations come from overflow blocks,
+ * and the next Reset grows the block to cover the whole frame.
+ */
+class FrameArena
+{
+public:
+    /**
+     * @brief Constructor
+     */
+    FrameArena();
+
+    /**
+     * @brief Destructor
+     */
+    ~FrameArena();
+
+    /**
+     * @brief Releases all allocations. Grows the block if the previous frame needed overflow blocks.
+     */
+    void Reset();
+
+    /**
+     * @brief Allocates an array of value-initialized objects. The objects are never destroyed,
+     * so only trivially destructible types are allowed.
+     * @param[in] count Number of objects
+     * @return Pointer to the first object
+     */
+    template <typename T>
+    T* Allocate(const size_t& count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena allocations are released without running destructors");
+
+        T* objects = static_cast<T*>(AllocateBytes(sizeof(T) * count, alignof(T)));
+        std::uninitialized_value_construct_n(objects, count);
+        return objects;
+    }
+
+    /**
+     * @brief Gets the number of bytes allocated since the last reset, including overflow blocks.
+     * @return Number of allocated bytes
+     */
+    size_t GetUsedBytes() const;
+
+    /**
+     * @brief Gets the size of the block.
+     * @return Capacity in bytes
+     */
+    size_t GetCapacity() const;
+
+private:
+    /**
+     * Block that allocations are made from
+     */
+    std::unique_ptr<uint8_t[]> m_block;
+
+    /**
+     * Size of the block in bytes
+     */
+    size_t m_capacity;
+
+    /**
+     * Offset of the next free byte in the block
+     */
+    size_t m_head;
+
+    /**
+     * Blocks holding the allocations that did not fit in the block since the last reset
+     */
+    std::vector<std::unique_ptr<uint8_t[]>> m_overflowBlocks;
+
+    /**
+     * Number of bytes allocated from overflow blocks since the last reset
+     */
+    size_t m_overflowBytes;
+
+private:
+    /**
+     * @brief Allocates uninitialized memory.
+     * @param[in] size Size in bytes
+     * @param[in] alignment Required alignment, which must be a power of two
+     * @return Pointer to the memory
+     */
+    void* AllocateBytes(const size_t& size, const size_t& alignment);
+};
@@ -0,0 +1,262 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Measures the GPU time of named regions of a command buffer using timestamp queries.
+ * Each frame in flight has its own query pool, and its results are read back the next time the frame is recorded,
+ * once its fence has been waited on, so reading them never stalls.
+ */
+class GpuProfiler
+{
+public:
+    /**
+     * Struct containing the measured GPU time of a scope
+     */
+    struct ScopeTiming
+    {
+        /**
+         * Scope name
+         */
+        std::string name;
+
+        /**
+         * Number of scopes the scope is nested in
+         */
+        uint32_t depth;
+
+        /**
+         * GPU time (in milliseconds)
+         */
+        double time;
+    };
+
+    /**
+     * Struct containing the recent GPU times of a scope, for plotting
+     */
+    struct ScopeHistory
+    {
+        /**
+         * Scope name
+         */
+        std::string name;
+
+        /**
+         * GPU times of the most recent frames (in milliseconds), used as a ring buffer
+         */
+        std::vector<float> times;
+
+        /**
+         * Index of the oldest time in the ring buffer
+         */
+        uint32_t offset;
+
+        /**
+         * Number of times recorded in the ring buffer, up to its length
+         */
+        uint32_t numTimes;
+
+        /**
+         * Average of the recorded times in the ring buffer (in milliseconds)
+         */
+        float average;
+    };
+
+public:
+    /**
+     * @brief Constructor
+     */
+    GpuProfiler();
+
+    /**
+     * @brief Destructor
+     */
+    ~GpuProfiler();
+
+    /**
+     * @brief Creates one query pool per frame in flight. If the device does not support timestamps,
+     * no query pool is created and scopes are ignored.
+     * @param[in] numFramesInFlight Number of frames in flight
+     * @return Returns true if the initialization was successful. Returns false otherwise.
+     */
+    bool Initialize(const uint32_t& numFramesInFlight);
+
+    /**
+     * @brief Checks whether the device supports timestamps.
+     * @return Returns true if timestamps are supported. Returns false otherwise.
+     */
+    bool IsSupported() const;
+
+    /**
+     * @brief Reads back the results of the previous use of a frame in flight and resets its queries.
+     * Must be called right after beginning the frame's command buffer, once its fence has been waited on.
+     * @param[in] commandBuffer Command buffer of the frame
+     * @param[in] frameIndex Index of the frame in flight
+     */
+    void BeginFrame(VkCommandBuffer commandBuffer, const uint32_t& frameIndex);
+
+    /**
+     * @brief Writes the start timestamp of a scope. Scopes can be nested.
+     * @param[in] commandBuffer Command buffer of the frame
+     * @param[in] name Scope name. Only the pointer is stored, so it must stay valid until the frame is collected
+     * (e.g., a string literal).
+     * @return Index of the scope, to pass to EndScope
+     */
+    uint32_t BeginScope(VkCommandBuffer commandBuffer, const char* name);
+
+    /**
+     * @brief Writes the end timestamp of a scope.
+     * @param[in] commandBuffer Command buffer of the frame
+     * @param[in] scopeIndex Index returned by BeginScope
+     */
+    void EndScope(VkCommandBuffer commandBuffer, const uint32_t& scopeIndex);
+
+    /**
+     * @brief Reads back the results of a frame in flight without waiting. Called by BeginFrame, and can be called
+     * directly once the device is idle to collect the frames that are still in flight.
+     * @param[in] frameIndex Index of the frame in flight
+     * @return Returns true if new results were read. Returns false otherwise.
+     */
+    bool CollectResults(const uint32_t& frameIndex);
+
+    /**
+     * @brief Gets the scope times of the last collected use of a frame in flight.
+     * @param[in] frameIndex Index of the frame in flight
+     * @return Scope times, in the order the scopes began
+     */
+    const std::vector<ScopeTiming>& GetFrameTimings(const uint32_t& frameIndex) const;
+
+    /**
+     * @brief Gets the scope times of the most recently collected frame.
+     * @return Scope times, in the order the scopes began
+     */
+    const std::vector<ScopeTiming>& GetLatestTimings() const;
+
+    /**
+     * @brief Gets the recent times of every scope seen so far.
+     * @return Scope histories, in the order the scopes were first seen
+     */
+    const std::vector<ScopeHistory>& GetScopeHistories() const;
+
+    /**
+     * @brief Destroys the query pools.
+     */
+    void Cleanup();
+
+private:
+    /**
+     * Maximum number of scopes per frame
+     */
+    const uint32_t MAX_SCOPES = 32;
+
+    /**
+     * Number of frames kept in the history of each scope
+     */
+    const uint32_t HISTORY_LENGTH = 240;
+
+    /**
+     * Struct describing a scope recorded in a frame
+     */
+    struct Scope
+    {
+        /**
+         * Scope name, not copied so that beginning a scope never allocates
+         */
+        const char* name;
+
+        /**
+         * Number of scopes the scope is nested in
+         */
+        uint32_t depth;
+    };
+
+    /**
+     * Struct containing the queries of a frame in flight
+     */
+    struct FrameQueries
+    {
+        /**
+         * Vulkan query pool holding the start and end timestamps of each scope
+         */
+        VkQueryPool queryPool;
+
+        /**
+         * Scopes recorded in the frame. Scope i uses queries 2i and 2i + 1.
+         */
+        std::vector<Scope> scopes;
+
+        /**
+         * Flag indicating whether the frame has timestamps that were not read back yet
+         */
+        bool hasPendingResults;
+
+        /**
+         * Scope times of the last collected use of the frame
+         */
+        std::vector<ScopeTiming> timings;
+
+        /**
+         * Index of the history of each scope in timings
+         */
+        std::vector<uint32_t> historyIndices;
+    };
+
+    /**
+     * Queries of each frame in flight
+     */
+    std::vector<FrameQueries> m_frames;
+
+    /**
+     * Index of the frame in flight being recorded
+     */
+    uint32_t m_currentFrame;
+
+    /**
+     * Indices of the scopes that have begun but not ended yet
+     */
+    std::vector<uint32_t> m_openScopes;
+
+    /**
+     * Index of the most recently collected frame in flight
+     */
+    uint32_t m_latestFrame;
+
+    /**
+     * Recent times of every scope seen so far
+     */
+    std::vector<ScopeHistory> m_scopeHistories;
+
+    /**
+     * Buffer the timestamps of a frame are read back into (MAX_SCOPES * 2 entries)
+     */
+    std::vector<uint64_t> m_timestamps;
+
+    /**
+     * Number of nanoseconds per timestamp tick
+     */
+    double m_timestampPeriod;
+
+    /**
+     * Mask of the timestamp bits that are valid on the graphics queue
+     */
+    uint64_t m_timestampMask;
+
+private:
+    /**
+     * @brief Finds the history of a scope, adding an empty one if the scope has not been seen before.
+     * @param[in] name Scope name
+     * @return Index of the scope history
+     */
+    uint32_t FindScopeHistory(const std::string& name);
+
+    /**
+     * @brief Adds the scope times of a collected frame to the scope histories.
+     * @param[in] timings Scope times
+     * @param[in] historyIndices Index of the history of each scope
+     */
+    void AddToHistory(const std::vector<ScopeTiming>& timings, const std::vector<uint32_t>& historyIndices);
+};
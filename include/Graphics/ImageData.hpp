@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+/**
+ * Struct containing decoded pixel data that lives in memory rather than in a file
+ */
+struct ImageData
+{
+    /**
+     * Image width
+     */
+    uint32_t width;
+
+    /**
+     * Image height
+     */
+    uint32_t height;
+
+    /**
+     * Number of channels per pixel
+     */
+    uint32_t numChannels;
+
+    /**
+     * Number of bytes per channel (1 for 8-bit images, 2 for 16-bit images).
+     * The color channels of 8-bit images are sRGB, and those of 16-bit images are linear.
+     */
+    uint32_t bytesPerChannel;
+
+    /**
+     * Flag indicating whether the pixels are stored in BGRA order instead of RGBA
+     */
+    bool isBGRA;
+
+    /**
+     * Maximum number of mip levels to generate for the image. 0 means the full mip chain.
+     */
+    uint32_t maxMipLevels;
+
+    /**
+     * Pixel data. The pointer keeps whatever owns the pixels alive (e.g., the decoder output or the Assimp scene).
+     */
+    std::shared_ptr<const uint8_t> pixels;
+};
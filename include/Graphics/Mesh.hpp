@@ -23,6 +23,16 @@ struct Mesh
      */
     std::vector<uint32_t> indices;
 
+    /**
+     * Center of the mesh's bounding sphere
+     */
+    glm::vec3 boundsCenter;
+
+    /**
+     * Radius of the mesh's bounding sphere
+     */
+    float boundsRadius;
+
     /**
      * File paths to the mesh's diffuse maps
      */
@@ -32,4 +42,10 @@ struct Mesh
      * File paths to the mesh's emissive maps
      */
     std::vector<std::string> emissiveMapFilePaths;
+
+    /**
+     * Flag indicating whether the mesh's textures may have transparent texels, so that it needs the alpha test.
+     * Set when the model is loaded.
+     */
+    bool isAlphaMasked;
 };
@@ -1,14 +1,76 @@
 #pragma once
 
+#include "Graphics/ImageData.hpp"
 #include "Graphics/Mesh.hpp"
 
 #include <assimp/scene.h>
 
+#include <chrono>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class Model
 {
+public:
+    /**
+     * Struct containing options that control how a model is imported
+     */
+    struct ImportOptions
+    {
+        /**
+         * Flag indicating whether small diffuse textures should be packed into shared texture atlases
+         */
+        bool packTextureAtlases;
+    };
+
+    /**
+     * Struct containing the wall time spent in each stage of the last import (in milliseconds)
+     */
+    struct LoadStatistics
+    {
+        /**
+         * Time spent in Assimp's ReadFile, including its post-processing steps
+         */
+        double readFileTime;
+
+        /**
+         * Time spent traversing the node hierarchy, excluding mesh processing
+         */
+        double nodeTraversalTime;
+
+        /**
+         * Time spent converting Assimp meshes into our own meshes
+         */
+        double processMeshTime;
+
+        /**
+         * Time spent resolving material texture paths
+         */
+        double texturePathResolutionTime;
+
+        /**
+         * Time spent waiting for the embedded textures to finish decoding after the meshes were processed
+         */
+        double embeddedTextureWaitTime;
+
+        /**
+         * Time spent packing textures into atlases
+         */
+        double textureAtlasPackingTime;
+
+        /**
+         * Time spent classifying the materials as opaque or alpha-masked
+         */
+        double materialClassificationTime;
+
+        /**
+         * Total time of the import
+         */
+        double totalTime;
+    };
+
 public:
     /**
      * @brief Constructor
@@ -23,9 +85,24 @@ public:
     /**
      * @brief Loads the 3D model located in the specified file path.
      * @param[in] modelFilePath Model file path
+     * @param[in] options Import options
      * @return Returns true if the operation was successful. Returns false otherwise.
      */
-    bool Load(const std::string& modelFilePath);
+    bool Load(const std::string& modelFilePath, const ImportOptions& options = {});
+
+    /**
+     * @brief Adds a mesh that was built in memory rather than imported. The model takes ownership of the mesh.
+     * @param[in] mesh Mesh
+     */
+    void AddMesh(Mesh* mesh);
+
+    /**
+     * @brief Adds a texture that was built in memory rather than imported. Meshes refer to it by its key,
+     * the same way as textures embedded in a model file.
+     * @param[in] textureKey Texture key
+     * @param[in] image Decoded image
+     */
+    void AddEmbeddedTexture(const std::string& textureKey, const ImageData& image);
 
     /**
      * @brief Gets all the meshes in the model.
@@ -45,12 +122,93 @@ public:
      */
     uint32_t GetTotalTriangleCount() const;
 
+    /**
+     * @brief Gets the decoded pixels of a texture embedded in the model file.
+     * @param[in] textureKey Texture key, as stored in the mesh texture paths
+     * @return Pointer to the embedded texture image. Returns nullptr if the key does not refer to an embedded texture.
+     */
+    const ImageData* GetEmbeddedTexture(const std::string& textureKey) const;
+
+    /**
+     * @brief Gets the number of texture atlases created during the import.
+     * @return Texture atlas count
+     */
+    uint32_t GetTextureAtlasCount() const;
+
+    /**
+     * @brief Gets the number of textures that were packed into texture atlases during the import.
+     * @return Packed texture count
+     */
+    uint32_t GetAtlasPackedTextureCount() const;
+
+    /**
+     * @brief Gets the time spent in each stage of the last import.
+     * @return Load statistics
+     */
+    const LoadStatistics& GetLoadStatistics() const;
+
+private:
+    /**
+     * Only textures whose width and height are within this size are packed into atlases
+     */
+    const uint32_t TEXTURE_ATLAS_MAX_TILE_SIZE = 256;
+
+    /**
+     * Maximum width and height of a texture atlas
+     */
+    const uint32_t TEXTURE_ATLAS_SIZE = 2048;
+
+    /**
+     * Number of pixels replicated around each texture in an atlas, so that filtering does not bleed between neighbors
+     */
+    const uint32_t TEXTURE_ATLAS_PADDING = 8;
+
+    /**
+     * Number of mip levels of an atlas. At the coarsest level, the padding is still one pixel wide.
+     */
+    const uint32_t TEXTURE_ATLAS_MAX_MIP_LEVELS = 4;
+
 private:
     /**
      * List of meshes in the model
      */
     std::vector<Mesh*> m_meshes;
 
+    /**
+     * Decoded textures that were embedded in the model file, keyed by texture key
+     */
+    std::unordered_map<std::string, ImageData> m_embeddedTextures;
+
+    /**
+     * Number of texture atlases created during the import
+     */
+    uint32_t m_numTextureAtlases;
+
+    /**
+     * Number of textures packed into texture atlases during the import
+     */
+    uint32_t m_numAtlasPackedTextures;
+
+    /**
+     * Total number of vertices in the model, updated as meshes are added
+     */
+    uint32_t m_totalVertexCount;
+
+    /**
+     * Total number of triangles in the model, updated as meshes are added
+     */
+    uint32_t m_totalTriangleCount;
+
+    /**
+     * Time spent in each stage of the last import
+     */
+    LoadStatistics m_loadStatistics;
+
+    /**
+     * Map that maps a texture key to whether the texture may have transparent texels, so that each texture is only scanned once
+     */
+    std::unordered_map<std::string, bool> m_textureTransparency;
+
 private:
     /**
      * @brief Processes an Assimp node.
@@ -67,6 +225,74 @@ private:
      */
     void ProcessMesh(aiMesh* mesh, const aiScene* scene, Mesh* outMesh);
 
+    /**
+     * @brief Resolves a material texture path to the key used to load the texture.
+     * @param[in] texturePath Texture path as stored in the material
+     * @param[in] scene Assimp scene
+     * @param[in] modelFilePath Model file path
+     * @param[in] modelDirPath Directory containing the model file
+     * @return Unique key of the embedded texture if the path refers to one. File path of the texture otherwise.
+     */
+    static std::string ResolveTexturePath(const std::string& texturePath, const aiScene* scene, const std::string& modelFilePath, const std::string& modelDirPath);
+
+    /**
+     * @brief Decodes a texture that is embedded in the model file.
+     * @param[in] scene Assimp scene that owns the embedded texture
+     * @param[in] texture Embedded texture
+     * @return Decoded image. The pixel pointer is null if decoding failed.
+     */
+    static ImageData DecodeEmbeddedTexture(std::shared_ptr<const aiScene> scene, const aiTexture* texture);
+
+    /**
+     * @brief Packs small diffuse textures into texture atlases, and remaps the UVs of the meshes using them.
+     * Only textures that are sampled within [0, 1] by meshes without an emissive map are packed.
+     * @param[in] modelFilePath Model file path, used to build the keys of the atlases
+     */
+    void PackTextureAtlases(const std::string& modelFilePath);
+
+    /**
+     * @brief Decodes an image file for packing into a texture atlas.
+     * @param[in] filePath Image file path
+     * @return Decoded image. The pixel pointer is null if decoding failed.
+     */
+    static ImageData LoadImageFile(const std::string& filePath);
+
+    /**
+     * @brief Classifies the material of each mesh as opaque or alpha-masked based on its textures.
+     */
+    void ClassifyMaterials();
+
+    /**
+     * @brief Checks whether a texture may have transparent texels. Embedded textures are scanned, while
+     * texture files are classified by whether they have an alpha channel, without decoding them.
+     * @param[in] textureKey Texture key, as stored in the mesh texture paths
+     * @return Returns true if the texture may have transparent texels. Returns false otherwise.
+     */
+    bool IsTextureTransparent(const std::string& textureKey);
+
+    /**
+     * @brief Checks whether all the UVs of a mesh are within [0, 1].
+     * @param[in] mesh Mesh
+     * @return Returns true if all the UVs are within [0, 1]. Returns false otherwise.
+     */
+    static bool AreTextureCoordinatesNormalized(const Mesh* mesh);
+
+    /**
+     * @brief Reads a pixel of an image and converts it to 8-bit RGBA.
+     * @param[in] image Image
+     * @param[in] x Pixel column
+     * @param[in] y Pixel row
+     * @param[out] outPixel Pixel in 8-bit RGBA
+     */
+    static void ReadPixelRGBA8(const ImageData& image, const uint32_t& x, const uint32_t& y, uint8_t* outPixel);
+
+    /**
+     * @brief Gets the time elapsed since a point in time.
+     * @param[in] startTime Point in time
+     * @return Elapsed time (in milliseconds)
+     */
+    static double GetElapsedMilliseconds(const std::chrono::steady_clock::time_point& startTime);
+
     /**
      * @brief Cleans up resources.
      */
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Records chunks of a render pass into secondary command buffers on several threads.
+ * Each thread has its own command pool per frame in flight, so that no pool is shared between threads
+ * and a frame's pools can be reset as a whole once the frame has completed.
+ */
+class ParallelCommandRecorder
+{
+public:
+    /**
+     * Function recording one chunk into a secondary command buffer that has already been begun
+     */
+    using RecordFunction = std::function<void(const uint32_t& chunkIndex, VkCommandBuffer commandBuffer)>;
+
+public:
+    /**
+     * @brief Constructor
+     */
+    ParallelCommandRecorder();
+
+    /**
+     * @brief Destructor
+     */
+    ~ParallelCommandRecorder();
+
+    /**
+     * @brief Creates the command pools and starts the worker threads. The calling thread also records chunks,
+     * so one thread less than the thread count is started.
+     * @param[in] numFramesInFlight Number of frames in flight
+     * @param[in] numThreads Number of recording threads, including the calling thread
+     * @return Returns true if the initialization was successful. Returns false otherwise.
+     */
+    bool Initialize(const uint32_t& numFramesInFlight, const uint32_t& numThreads);
+
+    /**
+     * @brief Stops the worker threads and destroys the command pools. The device must be idle.
+     */
+    void Cleanup();
+
+    /**
+     * @brief Gets the number of recording threads, including the calling thread.
+     * @return Number of recording threads
+     */
+    uint32_t GetThreadCount() const;
+
+    /**
+     * @brief Resets the command pools of a frame in flight, recycling its secondary command buffers.
+     * The previous submission of the frame must have completed.
+     * @param[in] frameIndex Index of the frame in flight
+     */
+    void BeginFrame(const uint32_t& frameIndex);
+
+    /**
+     * @brief Begins a secondary command buffer on the calling thread, for commands that must be ordered
+     * between parallel chunks. Must not be called while chunks are being recorded.
+     * @param[in] frameIndex Index of the frame in flight
+     * @param[in] inheritanceInfo Render pass state inherited from the primary command buffer
+     * @return Secondary command buffer, or VK_NULL_HANDLE if it could not be begun
+     */
+    VkCommandBuffer BeginSecondary(const uint32_t& frameIndex, const VkCommandBufferInheritanceInfo& inheritanceInfo);
+
+    /**
+     * @brief Records chunks into secondary command buffers in parallel, and waits for all of them to finish.
+     * @param[in] frameIndex Index of the frame in flight
+     * @param[in] numChunks Number of chunks
+     * @param[in] inheritanceInfo Render pass state inherited from the primary command buffer
+     * @param[in] recordChunk Function recording a chunk. It is called concurrently from several threads.
+     * @param[out] outCommandBuffers Array of numChunks elements receiving the ended secondary command buffers, in chunk order
+     * @return Returns true if every chunk was recorded successfully. Returns false otherwise.
+     */
+    bool Record(const uint32_t& frameIndex, const uint32_t& numChunks, const VkCommandBufferInheritanceInfo& inheritanceInfo,
+        const RecordFunction& recordChunk, VkCommandBuffer* outCommandBuffers);
+
+private:
+    /**
+     * Struct containing the command pool of one thread for one frame in flight
+     */
+    struct ThreadCommandPool
+    {
+        /**
+         * Vulkan command pool
+         */
+        VkCommandPool commandPool;
+
+        /**
+         * Secondary command buffers allocated from the pool so far
+         */
+        std::vector<VkCommandBuffer> commandBuffers;
+
+        /**
+         * Number of command buffers used since the pool was last reset
+         */
+        size_t numUsedCommandBuffers;
+    };
+
+    /**
+     * Command pools, indexed by frame in flight and then by thread. Thread 0 is the calling thread.
+     */
+    std::vector<std::vector<ThreadCommandPool>> m_commandPools;
+
+    /**
+     * Worker threads (threads 1 and up)
+     */
+    std::vector<std::thread> m_workerThreads;
+
+    /**
+     * Mutex guarding the job state
+     */
+    std::mutex m_mutex;
+
+    /**
+     * Condition variable used to wake up the worker threads when a job is posted
+     */
+    std::condition_variable m_jobCondition;
+
+    /**
+     * Condition variable used to wake up the calling thread when the workers are done
+     */
+    std::condition_variable m_doneCondition;
+
+    /**
+     * Incremented each time a job is posted
+     */
+    uint64_t m_jobGeneration;
+
+    /**
+     * Number of workers that have not finished the current job yet
+     */
+    uint32_t m_numBusyWorkers;
+
+    /**
+     * Flag indicating whether the worker threads should keep running
+     */
+    bool m_isRunning;
+
+    /**
+     * Frame in flight of the current job
+     */
+    uint32_t m_jobFrameIndex;
+
+    /**
+     * Number of chunks of the current job
+     */
+    uint32_t m_jobNumChunks;
+
+    /**
+     * Inheritance info of the current job
+     */
+    const VkCommandBufferInheritanceInfo* m_jobInheritanceInfo;
+
+    /**
+     * Chunk recording function of the current job
+     */
+    const RecordFunction* m_jobRecordFunction;
+
+    /**
+     * Output command buffers of the current job, in chunk order
+     */
+    VkCommandBuffer* m_jobCommandBuffers;
+
+    /**
+     * Index of the next chunk to record
+     */
+    std::atomic<uint32_t> m_nextChunk;
+
+    /**
+     * Flag indicating whether recording any chunk of the current job failed
+     */
+    std::atomic<bool> m_hasJobFailed;
+
+private:
+    /**
+     * @brief Main loop of a worker thread.
+     * @param[in] threadIndex Index of the thread
+     */
+    void WorkerLoop(const uint32_t threadIndex);
+
+    /**
+     * @brief Records chunks of the current job until none are left.
+     * @param[in] threadIndex Index of the recording thread
+     */
+    void RecordChunks(const uint32_t& threadIndex);
+
+    /**
+     * @brief Takes an unused secondary command buffer of a thread, allocating a new one if needed, and begins it.
+     * @param[in] frameIndex Index of the frame in flight
+     * @param[in] threadIndex Index of the recording thread
+     * @param[in] inheritanceInfo Render pass state inherited from the primary command buffer
+     * @return Secondary command buffer, or VK_NULL_HANDLE if it could not be begun
+     */
+    VkCommandBuffer BeginCommandBuffer(const uint32_t& frameIndex, const uint32_t& threadIndex, const VkCommandBufferInheritanceInfo& inheritanceInfo);
+};
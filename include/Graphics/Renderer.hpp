@@ -1,13 +1,19 @@
 #pragma once
 
+#include "Graphics/FrameArena.hpp"
+#include "Graphics/GpuProfiler.hpp"
 #include "Graphics/Model.hpp"
+#include "Graphics/ParallelCommandRecorder.hpp"
+#include "Graphics/TextureStreamer.hpp"
 
 #include "Graphics/Vulkan/VulkanBuffer.hpp"
 #include "Graphics/Vulkan/VulkanImage.hpp"
 #include "Graphics/Vulkan/VulkanImageView.hpp"
+#include "Graphics/Vulkan/VulkanRingBuffer.hpp"
 
 #include <glm/glm.hpp>
 
+#include <array>
 #include <iostream>
 #include <unordered_map>
 
@@ -16,6 +22,94 @@
  */
 class Renderer
 {
+public:
+    /**
+     * Struct containing counters describing the work submitted in the last rendered frame
+     */
+    struct FrameStatistics
+    {
+        /**
+         * Number of draw calls
+         */
+        uint32_t drawCount;
+
+        /**
+         * Number of triangles submitted
+         */
+        uint32_t triangleCount;
+
+        /**
+         * Number of draw calls using the alpha-masked pipelines
+         */
+        uint32_t maskedDrawCount;
+
+        /**
+         * Number of triangles submitted with the alpha-masked pipelines
+         */
+        uint32_t maskedTriangleCount;
+
+        /**
+         * Number of pipeline binds
+         */
+        uint32_t pipelineBindCount;
+
+        /**
+         * Number of descriptor set binds
+         */
+        uint32_t descriptorSetBindCount;
+
+        /**
+         * Number of meshes skipped because their bounds were outside of the view frustum
+         */
+        uint32_t culledMeshCount;
+
+        /**
+         * Number of triangles skipped because their meshes were outside of the view frustum
+         */
+        uint32_t culledTriangleCount;
+
+        /**
+         * Number of visible meshes skipped because they did not fit in the per-frame buffers
+         */
+        uint32_t droppedDrawCount;
+
+        /**
+         * Number of bytes of geometry, uniform and texture data uploaded to the GPU
+         */
+        uint64_t uploadedBytes;
+    };
+
+    /**
+     * Struct containing the GPU memory allocated by the renderer, by category
+     */
+    struct MemoryStatistics
+    {
+        /**
+         * Memory of the per-frame vertex and index buffers
+         */
+        uint64_t geometryBufferBytes;
+
+        /**
+         * Memory of the per-frame staging buffers
+         */
+        uint64_t stagingBufferBytes;
+
+        /**
+         * Memory of the per-frame and per-object uniform buffers
+         */
+        uint64_t uniformBufferBytes;
+
+        /**
+         * Memory of the texture images
+         */
+        uint64_t textureBytes;
+
+        /**
+         * Number of texture images
+         */
+        uint32_t textureCount;
+    };
+
 public:
     /**
      * @brief Constructor
@@ -29,37 +123,169 @@ public:
 
     /**
      * @brief Initializes the mesh renderer system.
-     * @param[in] numSwapchainImages Number of swapchain images
+     * @param[in] numFramesInFlight Number of frames in flight
+     * @param[in] numRecordingThreads Number of threads recording the draws. With more than one thread,
+     * the draws are recorded into secondary command buffers.
      * @param[in] renderPass Vulkan render pass
      * @return Returns true if the initialization was successful. Returns false otherwise.
      */
-    bool Initialize(const uint32_t& numSwapchainImages, VkRenderPass renderPass);
+    bool Initialize(const uint32_t& numFramesInFlight, const uint32_t& numRecordingThreads, VkRenderPass renderPass);
 
     /**
-     * @brief Begins the render batch.
+     * @brief Begins the render batch. The previous submission of the frame in flight must have completed,
+     * since its transient data is released.
+     * @param[in] frameIndex Index of the frame in flight
+     * @param[in] numProducers Number of producers that add draws to the batch, each from at most one thread at a time
      */
-    void Begin();
+    void Begin(const uint32_t& frameIndex, const uint32_t& numProducers = 1);
 
     /**
-     * @brief Adds the model to the render batch.
+     * @brief Adds the model to the render batch. Different producers may call this concurrently,
+     * since each one appends to its own buffer.
      * @param[in] model Model to add to the render batch
      * @param[in] transform Transformation matrix
+     * @param[in] producerIndex Index of the producer adding the model, smaller than the count passed to Begin
      */
-    void DrawModel(Model* model, const glm::mat4& transform);
+    void DrawModel(Model* model, const glm::mat4& transform, const uint32_t& producerIndex = 0);
 
     /**
-     * @brief Ends the render batch.
+     * @brief Ends the render batch, merging the draws of all producers in producer order.
+     * No producer may be adding draws anymore.
      */
     void End();
 
     /**
-     * @brief Renders all entities with a MeshComponent and a TransformComponent.
+     * @brief Picks up decoded textures and refines the resolution of the textures in the render batch
+     * based on how large they appear on screen.
+     * @param[in] cameraPosition Camera position in world space
+     * @param[in] fieldOfView Vertical field of view of the camera (in degrees)
+     * @param[in] viewportHeight Height of the viewport in pixels
+     */
+    void UpdateTextureStreaming(const glm::vec3& cameraPosition, const float& fieldOfView, const uint32_t& viewportHeight);
+
+    /**
+     * @brief Gets the number of textures decoded since the last model load that turned out to be identical
+     * to another texture and therefore share its GPU image.
+     * @return Number of deduplicated textures
+     */
+    uint32_t GetDeduplicatedTextureCount() const;
+
+    /**
+     * @brief Resets the number of deduplicated textures and starts a new load generation, so that it only counts the textures of the next model.
+     */
+    void ResetDeduplicatedTextureCount();
+
+    /**
+     * @brief Checks whether texture streaming needs more frames to make progress, because decoded textures
+     * are waiting to be picked up or visible textures are not at their desired resolution yet.
+     * Textures that are still being decoded do not count, since they report their completion through
+     * the texture decoded callback.
+     * @return Returns true if texture streaming needs more frames. Returns false otherwise.
+     */
+    bool IsStreamingTextures();
+
+    /**
+     * @brief Checks whether texture streaming has settled: nothing is waiting to be decoded or picked up,
+     * and every visible texture is at its desired resolution.
+     * @return Returns true if texture streaming has settled. Returns false otherwise.
+     */
+    bool IsTextureStreamingSettled();
+
+    /**
+     * @brief Sets a function that is called from the decoding thread whenever a texture finishes decoding.
+     * @param[in] callback Function to call, or nullptr to call nothing
+     */
+    void SetTextureDecodedCallback(void (*callback)());
+
+    /**
+     * @brief Culls the render batch against the view frustum and records the copies of the remaining
+     * vertex and index data into the frame's buffers. Must be recorded outside of a render pass, before Render.
+     * @param[in] commandBuffer Vulkan command buffer
+     * @param[in] frameIndex Index of the frame in flight
+     * @param[in] viewMatrix View matrix
+     * @param[in] projMatrix Projection matrix
+     */
+    void Upload(VkCommandBuffer commandBuffer, const uint32_t& frameIndex, const glm::mat4& viewMatrix, const glm::mat4& projMatrix);
+
+    /**
+     * @brief Renders all entities with a MeshComponent and a TransformComponent. When recording in parallel,
+     * the render pass must have been begun with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS.
      * @param[in] commandBuffer Vulkan command buffer
-     * @param[in] imageIndex Swapchain image index
+     * @param[in] frameIndex Index of the frame in flight
+     * @param[in] extent Size of the render area
      * @param[in] viewMatrix View matrix
      * @param[in] projMatrix Projection matrix
      */
-    void Render(VkCommandBuffer commandBuffer, const uint32_t& imageIndex, const glm::mat4& viewMatrix, const glm::mat4& projMatrix);
+    void Render(VkCommandBuffer commandBuffer, const uint32_t& frameIndex, const VkExtent2D& extent, const glm::mat4& viewMatrix, const glm::mat4& projMatrix);
+
+    /**
+     * @brief Checks whether the draws are recorded into secondary command buffers on several threads.
+     * @return Returns true if the draws are recorded in parallel. Returns false otherwise.
+     */
+    bool IsRecordingInParallel() const;
+
+    /**
+     * @brief Sets the render pass that pipelines and secondary command buffers are created for,
+     * after the render pass has been recreated. The new render pass must be compatible with the old one.
+     * @param[in] renderPass Vulkan render pass
+     */
+    void SetRenderPass(VkRenderPass renderPass);
+
+    /**
+     * @brief Sets the GPU profiler used to time the opaque and alpha-masked passes.
+     * @param[in] gpuProfiler GPU profiler, or nullptr to disable the pass timings
+     */
+    void SetGpuProfiler(GpuProfiler* gpuProfiler);
+
+    /**
+     * @brief Enables or disables drawing opaque meshes with discard-free pipelines before the alpha-masked meshes.
+     * When disabled, every mesh is drawn in batch order with the alpha test, for comparison.
+     * @param[in] isEnabled Flag indicating whether the split is enabled
+     */
+    void SetAlphaMaskSplitEnabled(const bool& isEnabled);
+
+    /**
+     * @brief Checks whether opaque meshes are drawn with discard-free pipelines before the alpha-masked meshes.
+     * @return Returns true if the split is enabled. Returns false otherwise.
+     */
+    bool IsAlphaMaskSplitEnabled() const;
+
+    /**
+     * @brief Gets the counters describing the work submitted in the last rendered frame.
+     * @return Frame statistics
+     */
+    const FrameStatistics& GetFrameStatistics() const;
+
+    /**
+     * @brief Gets the GPU memory allocated by the renderer, by category.
+     * @return Memory statistics
+     */
+    const MemoryStatistics& GetMemoryStatistics() const;
+
+    /**
+     * @brief Gets the number of frames rendered so far.
+     * @return Frame number
+     */
+    uint64_t GetFrameNumber() const;
+
+    /**
+     * @brief Gets the number of graphics pipelines created so far, one per combination of pipeline features in use.
+     * @return Number of graphics pipelines
+     */
+    uint32_t GetPipelineCount() const;
+
+    /**
+     * @brief Gets the total time spent creating graphics pipelines, which is lower with a warm pipeline cache.
+     * @return Pipeline creation time (in milliseconds)
+     */
+    double GetPipelineCreationTime() const;
+
+    /**
+     * @brief Writes the frame, memory and pipeline statistics to a JSON file.
+     * @param[in] filePath Output file path
+     * @return Returns true if the file was written successfully. Returns false otherwise.
+     */
+    bool WriteStatisticsToFile(const std::string& filePath) const;
 
     /**
      * @brief Cleans up all resources used by the MeshRendererSystem
@@ -72,6 +298,49 @@ private:
      */
     const uint32_t MAX_OBJECTS = 1000;
 
+    /**
+     * Maximum number of vertices in the per-frame vertex buffer
+     */
+    const uint32_t MAX_VERTICES = 250000;
+
+    /**
+     * Maximum number of indices in the per-frame index buffer
+     */
+    const uint32_t MAX_INDICES = 1000000;
+
+    /**
+     * Maximum number of texture descriptor sets that can be allocated at the same time
+     */
+    const uint32_t MAX_TEXTURE_DESCRIPTOR_SETS = 1000;
+
+    /**
+     * Textures are first made visible with the largest mip level that fits within this size
+     */
+    const uint32_t STREAMING_INITIAL_MIP_SIZE = 32;
+
+    /**
+     * Maximum number of texture bytes uploaded per frame when refining streamed textures
+     */
+    const size_t STREAMING_UPLOAD_BUDGET = 8 * 1024 * 1024;
+
+    /**
+     * Minimum number of draws recorded per secondary command buffer. Smaller chunks cost more
+     * in command buffer overhead than they save by spreading the recording over threads.
+     */
+    const size_t MIN_DRAWS_PER_CHUNK = 64;
+
+    /**
+     * Feature bits selecting a permutation of the graphics pipeline. Each bit maps to a specialization
+     * constant of the fragment shader, so materials that do not need a feature skip its cost.
+     */
+    enum PipelineFeature
+    {
+        PIPELINE_FEATURE_EMISSIVE_MAP = 1 << 0,
+        PIPELINE_FEATURE_ALPHA_TEST = 1 << 1,
+
+        PIPELINE_FEATURE_ALL = PIPELINE_FEATURE_EMISSIVE_MAP | PIPELINE_FEATURE_ALPHA_TEST
+    };
+
     struct FrameInFlightData
     {
         /**
@@ -83,6 +352,124 @@ private:
          * Common index buffer for all objects to be rendererd
          */
         VulkanBuffer indexBuffer;
+
+        /**
+         * Staging buffer for the vertex buffer
+         */
+        VulkanBuffer vertexStagingBuffer;
+
+        /**
+         * Staging buffer for the index buffer
+         */
+        VulkanBuffer indexStagingBuffer;
+    };
+
+    /**
+     * Struct containing a texture and its streaming state
+     */
+    struct Texture
+    {
+        /**
+         * Vulkan image containing the full mip chain
+         */
+        VulkanImage image;
+
+        /**
+         * Format of the Vulkan image
+         */
+        VkFormat format;
+
+        /**
+         * Flag indicating whether any pixel of the texture is not fully opaque, which requires the alpha test
+         */
+        bool hasTransparency;
+
+        /**
+         * Component swizzle of the image views, which expands single and dual-channel formats to RGBA
+         */
+        VkComponentMapping components;
+
+        /**
+         * Vulkan image view covering the mip levels that have been uploaded
+         */
+        VulkanImageView imageView;
+
+        /**
+         * Descriptor set pointing to the image view
+         */
+        VkDescriptorSet descriptorSet;
+
+        /**
+         * Flag indicating whether the texture finished decoding and has its GPU image created
+         */
+        bool isLoaded;
+
+        /**
+         * Number of mip levels in the full mip chain
+         */
+        uint32_t numMipLevels;
+
+        /**
+         * Finest mip level that has been uploaded to the GPU
+         */
+        uint32_t residentMipLevel;
+
+        /**
+         * Finest mip level that is needed given the on-screen footprint
+         */
+        uint32_t desiredMipLevel;
+
+        /**
+         * Largest on-screen footprint (in pixels) of the meshes using the texture in the current frame
+         */
+        float footprint;
+
+        /**
+         * Decoded mip chain, kept until all mip levels have been uploaded
+         */
+        TextureStreamer::DecodedTexture decodedTexture;
+    };
+
+    /**
+     * Struct containing an image view and descriptor set that are waiting for the frames using them to finish
+     */
+    struct RetiredTextureView
+    {
+        /**
+         * Retired image view
+         */
+        VulkanImageView imageView;
+
+        /**
+         * Retired descriptor set
+         */
+        VkDescriptorSet descriptorSet;
+
+        /**
+         * Last graphics queue submission when the view was retired. Later submissions no longer use it.
+         */
+        uint64_t retiredSubmission;
+    };
+
+    /**
+     * Struct containing an upload that was submitted without waiting for it to complete
+     */
+    struct PendingUpload
+    {
+        /**
+         * Command buffer containing the upload commands
+         */
+        VkCommandBuffer commandBuffer;
+
+        /**
+         * Staging buffer the upload copies from
+         */
+        VulkanBuffer stagingBuffer;
+
+        /**
+         * Graphics queue submission of the upload
+         */
+        uint64_t submission;
     };
 
     struct RenderBatchUnit
@@ -90,6 +477,43 @@ private:
         Mesh* mesh;
 
         glm::mat4 transform;
+
+        /**
+         * Offset of the mesh's vertices in the frame's vertex buffer, set by Upload
+         */
+        VkDeviceSize vertexBufferOffset;
+
+        /**
+         * Offset of the mesh's indices in the frame's index buffer, set by Upload
+         */
+        VkDeviceSize indexBufferOffset;
+
+        /**
+         * Pipeline features needed by the mesh's material, set by Upload
+         */
+        uint32_t pipelineFeatures;
+
+        /**
+         * Graphics pipeline for the pipeline features, set by Upload so that recording threads do not create pipelines
+         */
+        VkPipeline pipeline;
+    };
+
+    /**
+     * Struct containing the draws added by one producer. Aligned to a cache line, so that producers
+     * appending on different threads do not contend for the cache line holding the vector ends.
+     */
+    struct alignas(64) ProducerBatch
+    {
+        /**
+         * Render batch units added by the producer
+         */
+        std::vector<RenderBatchUnit> renderBatchUnits;
+
+        /**
+         * Models drawn by the producer, whose textures are requested when the batch ends
+         */
+        std::vector<Model*> models;
     };
 
     /**
@@ -119,6 +543,31 @@ private:
         glm::mat4 model;
     };
 
+    /**
+     * Struct containing what the recording threads need to record the chunks of a frame
+     */
+    struct ChunkRecordingJob
+    {
+        uint32_t frameIndex;
+
+        VkExtent2D extent;
+
+        /**
+         * Range of render batch units of each chunk
+         */
+        const std::pair<size_t, size_t>* chunkRanges;
+
+        /**
+         * Mapped per-object storage buffer of the frame
+         */
+        ObjectUBO* objectUBOData;
+
+        /**
+         * Statistics of each chunk
+         */
+        FrameStatistics* chunkStatistics;
+    };
+
 private:
     /**
      * Vulkan descriptor set layout for per-frame data
@@ -146,9 +595,29 @@ private:
     VkPipelineLayout m_vkPipelineLayout;
 
     /**
-     * Vulkan graphics pipeline
+     * Render pass the graphics pipelines are created for
+     */
+    VkRenderPass m_vkRenderPass;
+
+    /**
+     * Vertex shader module, kept to create pipeline permutations on demand
+     */
+    VkShaderModule m_vkVertexShaderModule;
+
+    /**
+     * Fragment shader module, kept to create pipeline permutations on demand
+     */
+    VkShaderModule m_vkFragmentShaderModule;
+
+    /**
+     * Map that maps a combination of pipeline features to the graphics pipeline created for it
+     */
+    std::unordered_map<uint32_t, VkPipeline> m_vkPipelines;
+
+    /**
+     * Total time spent creating graphics pipelines (in milliseconds)
      */
-    VkPipeline m_vkPipeline;
+    double m_pipelineCreationTime;
 
     /**
      * Vulkan texture sampler
@@ -161,58 +630,173 @@ private:
     VkDescriptorPool m_vkDescriptorPool;
 
     /**
-     * Per-frame UBO Vulkan buffers (One per swapchain image)
+     * Ring buffer holding the per-frame and per-object data, with one region per frame in flight
+     */
+    VulkanRingBuffer m_uniformRingBuffer;
+
+    /**
+     * Alignment of the allocations from the uniform ring buffer, satisfying both uniform and storage buffer offsets
+     */
+    VkDeviceSize m_uniformBufferAlignment;
+
+    /**
+     * Descriptor set for the per-frame UBO, bound with a dynamic offset into the uniform ring buffer
      */
-    std::vector<VulkanBuffer> m_perFrameUBOs;
+    VkDescriptorSet m_vkPerFrameDescriptorSet;
 
     /**
-     * Per-object UBO Vulkan buffers (One per swapchain image)
+     * Descriptor set for the per-object UBOs, bound with a dynamic offset into the uniform ring buffer
      */
-    std::vector<VulkanBuffer> m_perObjectUBOs;
+    VkDescriptorSet m_vkPerObjectDescriptorSet;
 
     /**
-     * Descriptor set for per-frame UBO (One per swapchain image)
+     * Dynamic offset of the current frame's per-frame UBO, set by Render
      */
-    std::vector<VkDescriptorSet> m_vkPerFrameDescriptorSets;
+    uint32_t m_frameUBOOffset;
 
     /**
-     * Descriptor set for per-object UBOs (One per swapchain image)
+     * Dynamic offset of the current frame's per-object UBOs, set by Render
      */
-    std::vector<VkDescriptorSet> m_vkPerObjectDescriptorSets;
+    uint32_t m_objectUBOOffset;
 
     /**
-     * List of data that is needed for each frame-in-flight (One per swapchain image)
+     * List of data that is needed for each frame-in-flight (One per frame in flight)
      */
     std::vector<FrameInFlightData> m_frameInFlightData;
 
     /**
-     * Staging buffer for the vertex buffer
+     * Map that maps the content hash of a texture to the texture. Textures with identical contents share one entry.
+     */
+    std::unordered_map<uint64_t, Texture> m_textures;
+
+    /**
+     * Map that maps the texture filename to the content hash of the texture, for textures that finished decoding
+     */
+    std::unordered_map<std::string, uint64_t> m_textureContentHashes;
+
+    /**
+     * Map that maps the filename of a texture that has been requested but has no GPU texture yet
+     * to its largest on-screen footprint in the current frame
+     */
+    std::unordered_map<std::string, float> m_requestedTextures;
+
+    /**
+     * Number of textures decoded since the last model load whose contents matched an existing texture
+     */
+    uint32_t m_numDeduplicatedTextures;
+
+    /**
+     * Load generation, incremented with each model load. Textures requested for an earlier model
+     * are not counted as deduplicated when they finish decoding.
+     */
+    uint32_t m_textureLoadGeneration;
+
+    /**
+     * Background texture decoder
      */
-    VulkanBuffer m_vertexStagingBuffer;
+    TextureStreamer m_textureStreamer;
 
     /**
-     * Staging buffer for the index buffer
+     * Image views and descriptor sets replaced by finer ones, waiting to be destroyed
      */
-    VulkanBuffer m_indexStagingBuffer;
+    std::vector<RetiredTextureView> m_retiredTextureViews;
 
     /**
-     * Map that maps the texture filename to a Vulkan image
+     * Uploads whose command buffers and staging buffers are released once the GPU has finished them
      */
-    std::unordered_map<std::string, VulkanImage> m_textureToVulkanImageMap;
+    std::vector<PendingUpload> m_pendingUploads;
 
     /**
-     * Map that maps the texture filename to a Vulkan image view
+     * Number of frames that can be in flight at the same time
      */
-    std::unordered_map<std::string, VulkanImageView> m_textureToVulkanImageViewMap;
+    uint32_t m_numFramesInFlight;
 
     /**
-     * Map that maps the texture filename to a descriptor set
+     * Number of frames rendered so far
      */
-    std::unordered_map<std::string, VkDescriptorSet> m_textureToDescriptorSetMap;
+    uint64_t m_frameNumber;
 
     std::vector<RenderBatchUnit> m_renderBatchUnits;
 
+    /**
+     * Draws added by each producer since the batch began, merged into the render batch units by End
+     */
+    std::vector<ProducerBatch> m_producerBatches;
+
+    /**
+     * Linear allocators for the transient CPU data of each frame (One per frame in flight)
+     */
+    std::vector<FrameArena> m_frameArenas;
+
+    /**
+     * Index of the frame in flight whose batch is being built, set by Begin
+     */
+    uint32_t m_currentFrameIndex;
+
+    /**
+     * Number of render batch units whose geometry fit in the frame's buffers and was uploaded
+     */
+    size_t m_numUploadedBatchUnits;
+
+    /**
+     * Number of uploaded render batch units drawn with discard-free pipelines. They come before the alpha-masked units.
+     */
+    size_t m_numOpaqueBatchUnits;
+
+    /**
+     * Flag indicating whether opaque meshes are drawn with discard-free pipelines before the alpha-masked meshes
+     */
+    bool m_isAlphaMaskSplitEnabled;
+
+    /**
+     * GPU profiler used to time the opaque and alpha-masked passes. Not owned by the renderer.
+     */
+    GpuProfiler* m_gpuProfiler;
+
+    /**
+     * Records the draws into secondary command buffers when more than one recording thread is used
+     */
+    ParallelCommandRecorder m_commandRecorder;
+
+    /**
+     * Counters describing the work submitted in the last rendered frame
+     */
+    FrameStatistics m_frameStatistics;
+
+    /**
+     * Flag indicating whether a frame has already dropped draws, so that the warning is only printed once
+     */
+    bool m_hasDroppedDraws;
+
+    /**
+     * GPU memory allocated by the renderer, updated as resources are created
+     */
+    MemoryStatistics m_memoryStatistics;
+
 private:
+    /**
+     * @brief Checks whether a bounding sphere intersects the view frustum.
+     * @param[in] frustumPlanes Frustum planes, with their normals pointing inwards
+     * @param[in] center Sphere center in world space
+     * @param[in] radius Sphere radius
+     * @return Returns true if the sphere is at least partially inside the frustum. Returns false otherwise.
+     */
+    static bool IsSphereInFrustum(const std::array<glm::vec4, 5>& frustumPlanes, const glm::vec3& center, const float& radius);
+
+    /**
+     * @brief Records the draws of a range of render batch units. Only reads shared renderer state,
+     * so ranges can be recorded concurrently into different command buffers.
+     * @param[in] commandBuffer Vulkan command buffer, inside the render pass
+     * @param[in] frameIndex Index of the frame in flight
+     * @param[in] extent Size of the render area
+     * @param[in] begin Index of the first render batch unit
+     * @param[in] end Index after the last render batch unit
+     * @param[out] objectUBOData Mapped per-object storage buffer, written at the indices of the range
+     * @param[in,out] statistics Counters that the draws are added to
+     */
+    void RecordDraws(VkCommandBuffer commandBuffer, const uint32_t& frameIndex, const VkExtent2D& extent, const size_t& begin, const size_t& end,
+        ObjectUBO* objectUBOData, FrameStatistics& statistics);
+
     /**
      * @brief Create descriptor set layout.
      * @return Returns true if the creation was successful. Returns false otherwise.
@@ -220,16 +804,138 @@ private:
     bool CreateDescriptorSetLayout();
 
     /**
-     * @brief Create Vulkan graphics pipeline
+     * @brief Creates the pipeline layout and loads the shader modules shared by all pipeline permutations.
+     * @return Returns true if the creation was successful. Returns false otherwise.
+     */
+    bool CreatePipelineLayout();
+
+    /**
+     * @brief Create Vulkan graphics pipeline for a combination of pipeline features
+     * @param[in] features Pipeline feature bits
+     * @param[out] outPipeline Created pipeline
+     * @return Returns true if the creation was successful. Returns false otherwise.
+     */
+    bool CreateGraphicsPipeline(const uint32_t& features, VkPipeline& outPipeline);
+
+    /**
+     * @brief Gets the graphics pipeline for a combination of pipeline features, creating it on first use.
+     * @param[in] features Pipeline feature bits
+     * @return Graphics pipeline, or VK_NULL_HANDLE if the creation failed
+     */
+    VkPipeline GetPipeline(const uint32_t& features);
+
+    /**
+     * @brief Selects the cheapest pipeline features that can render a mesh with its current textures.
+     * @param[in] mesh Mesh
+     * @return Pipeline feature bits
+     */
+    uint32_t GetPipelineFeatures(const Mesh* mesh);
+
+    /**
+     * @brief Creates the GPU image of a decoded texture and uploads its smallest mip levels.
+     * @param[in] decodedTexture Decoded texture
+     * @param[in] initialMipSize Mip levels that fit within this size are uploaded right away
+     * @param[out] outTexture Texture where the created resources will be placed
      * @return Returns true if the creation was successful. Returns false otherwise.
      */
-    bool CreateGraphicsPipeline(VkRenderPass renderPass);
+    bool CreateTextureImage(TextureStreamer::DecodedTexture&& decodedTexture, const uint32_t& initialMipSize, Texture& outTexture);
+
+    /**
+     * @brief Selects the smallest image format that can hold a decoded texture without loss, and the swizzle
+     * that makes it read as RGBA in the shaders. Converts the texture to RGBA8 if the device cannot sample that format.
+     * @param[in,out] decodedTexture Decoded texture
+     * @param[out] outFormat Image format
+     * @param[out] outComponents Image view component swizzle
+     */
+    void SelectTextureFormat(TextureStreamer::DecodedTexture& decodedTexture, VkFormat& outFormat, VkComponentMapping& outComponents);
+
+    /**
+     * @brief Checks whether the device can sample images of the specified format with linear filtering.
+     * @param[in] format Image format
+     * @return Returns true if the format is supported. Returns false otherwise.
+     */
+    bool IsSampledFormatSupported(const VkFormat& format);
+
+    /**
+     * @brief Loads a texture file synchronously at full resolution.
+     * @param[in] textureFilePath Texture file path
+     * @return Returns true if the texture was loaded successfully. Returns false otherwise.
+     */
+    bool LoadTextureImmediate(const std::string& textureFilePath);
+
+    /**
+     * @brief Registers a texture and queues it for decoding if it has not been seen before.
+     * @param[in] model Model that uses the texture
+     * @param[in] textureFilePath Texture file path, or the key of a texture embedded in the model
+     */
+    void RequestTexture(const Model* model, const std::string& textureFilePath);
+
+    /**
+     * @brief Finds the texture with the specified file path.
+     * @param[in] textureFilePath Texture file path
+     * @return Pointer to the texture. Returns nullptr if the texture has not finished decoding yet.
+     */
+    Texture* FindTexture(const std::string& textureFilePath);
+
+    /**
+     * @brief Records the on-screen footprint of a mesh that uses the specified texture.
+     * @param[in] textureFilePath Texture file path
+     * @param[in] footprint On-screen footprint of the mesh (in pixels)
+     */
+    void AddTextureFootprint(const std::string& textureFilePath, const float& footprint);
+
+    /**
+     * @brief Gets the descriptor set to use for a texture.
+     * @param[in] textureFilePath Texture file path
+     * @param[in] fallbackTextureFilePath Texture to use while the texture is not loaded yet
+     * @return Descriptor set of the texture, or of the fallback texture
+     */
+    VkDescriptorSet GetTextureDescriptorSet(const std::string& textureFilePath, const std::string& fallbackTextureFilePath);
+
+    /**
+     * @brief Uploads a range of mip levels of a texture.
+     * @param[in] texture Texture, which must still have its decoded mip chain
+     * @param[in] firstMipLevel Finest mip level to upload
+     * @param[in] lastMipLevel Coarsest mip level to upload
+     * @return Returns true if the upload was successful. Returns false otherwise.
+     */
+    bool UploadTextureMipLevels(Texture& texture, const uint32_t& firstMipLevel, const uint32_t& lastMipLevel);
+
+    /**
+     * @brief Recreates the image view and descriptor set of a texture after its resident mip levels changed.
+     * The current view and descriptor set are kept if the new ones cannot be created.
+     * @param[in] texture Texture
+     * @return Returns true if the operation was successful. Returns false otherwise.
+     */
+    bool RefreshTextureView(Texture& texture);
+
+    /**
+     * @brief Allocates and writes a descriptor set for a single texture.
+     * @param[in] imageView Image view of the texture
+     * @return Descriptor set, or VK_NULL_HANDLE if the allocation failed
+     */
+    VkDescriptorSet CreateTextureDescriptorSet(VkImageView imageView);
+
+    /**
+     * @brief Destroys retired texture views that are no longer used by any frame in flight.
+     * @param[in] destroyAll Destroy all retired views regardless of the frames in flight
+     */
+    void DestroyRetiredTextureViews(const bool& destroyAll);
+
+    /**
+     * @brief Ends a single use command buffer and submits it without waiting for it to complete.
+     * The command buffer and the staging buffer are released once the submission has completed.
+     * @param[in] commandBuffer Command buffer to end
+     * @param[in] stagingBuffer Staging buffer used by the command buffer
+     * @return Returns true if the submission was successful. Returns false otherwise.
+     */
+    bool SubmitUpload(VkCommandBuffer commandBuffer, const VulkanBuffer& stagingBuffer);
 
     /**
-     * @brief Creates a texture image from the specified file path.
-     * @param[out] outImage Variable where the loaded information will be placed.
+     * @brief Releases the command buffers and staging buffers of the uploads that the GPU has finished.
+     * @param[in] releaseAll Release all uploads regardless of their completion. The device must be idle.
      */
-    bool CreateTextureImage(const std::string& textureFilePath, VulkanImage& outImage);
+    void ReleaseCompletedUploads(const bool& releaseAll);
 
     /**
      * @brief Creates the texture sampler.
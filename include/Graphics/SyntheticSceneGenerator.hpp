@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Graphics/ImageData.hpp"
+#include "Graphics/Mesh.hpp"
+#include "Graphics/Model.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Builds models of controlled size in memory, for measuring how the renderer scales without depending on external assets
+ */
+class SyntheticSceneGenerator
+{
+public:
+    /**
+     * Struct describing the size of the scene to generate
+     */
+    struct Settings
+    {
+        /**
+         * Number of meshes in the model
+         */
+        uint32_t numMeshes = 100;
+
+        /**
+         * Number of triangles in each mesh
+         */
+        uint32_t trianglesPerMesh = 1000;
+
+        /**
+         * Number of times the model is drawn
+         */
+        uint32_t numInstances = 1;
+
+        /**
+         * Number of distinct diffuse textures shared by the meshes. 0 means the meshes are untextured.
+         */
+        uint32_t numUniqueTextures = 10;
+
+        /**
+         * Width and height of each texture
+         */
+        uint32_t textureSize = 256;
+
+        /**
+         * Seed of the random number generator, so that the same settings always generate the same scene
+         */
+        uint32_t seed = 1;
+    };
+
+public:
+    /**
+     * @brief Generates the meshes and textures of a scene into a model. The meshes are laid out in a grid and
+     * the instances in a larger grid, so that the whole scene fits within [-1, 1] on each axis.
+     * @param[in] settings Scene size
+     * @param[out] outModel Model where the meshes and textures are added. Should be empty.
+     * @param[out] outInstanceTransforms Transformation matrix of each instance
+     */
+    static void Generate(const Settings& settings, Model& outModel, std::vector<glm::mat4>& outInstanceTransforms);
+
+    /**
+     * @brief Parses settings in the "meshes,trianglesPerMesh,instances,textures" format. Missing trailing values keep their default.
+     * @param[in] text Text to parse
+     * @param[out] outSettings Settings
+     * @return Returns true if the text was valid. Returns false otherwise.
+     */
+    static bool ParseSettings(const std::string& text, Settings& outSettings);
+
+    /**
+     * @brief Gets a short description of the settings, usable as a benchmark name.
+     * @param[in] settings Scene size
+     * @return Description of the settings
+     */
+    static std::string GetDescription(const Settings& settings);
+
+private:
+    /**
+     * Number of checker squares along each side of a generated texture
+     */
+    static const uint32_t TEXTURE_CHECKER_COUNT = 8;
+
+private:
+    /**
+     * @brief Generates a wavy rectangular patch with exactly the requested number of triangles.
+     * @param[in] center Center of the patch
+     * @param[in] size Width and height of the patch
+     * @param[in] numTriangles Number of triangles
+     * @param[in] random Random number generator, used for the color and the waves
+     * @param[out] outMesh Mesh where the geometry is placed
+     */
+    static void GenerateMesh(const glm::vec3& center, const float& size, const uint32_t& numTriangles, std::mt19937& random, Mesh* outMesh);
+
+    /**
+     * @brief Generates a checkerboard texture in two random colors.
+     * @param[in] size Width and height of the texture
+     * @param[in] random Random number generator, used for the colors
+     * @return Generated image
+     */
+    static ImageData GenerateTexture(const uint32_t& size, std::mt19937& random);
+};
@@ -0,0 +1,409 @@
+#pragma once
+
+#include "Graphics/ImageData.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * Decodes textures on a background thread and prepares their mip chains,
+ * so that the renderer can upload them progressively.
+ */
+class TextureStreamer
+{
+public:
+    /**
+     * Struct describing a single mip level of a decoded texture
+     */
+    struct MipLevel
+    {
+        /**
+         * Mip level width
+         */
+        uint32_t width;
+
+        /**
+         * Mip level height
+         */
+        uint32_t height;
+
+        /**
+         * Offset of the pixel data in the mip storage (unused for mip level 0)
+         */
+        size_t offset;
+
+        /**
+         * Size of the pixel data in bytes
+         */
+        size_t size;
+    };
+
+    /**
+     * Struct containing a decoded texture and its mip chain
+     */
+    struct DecodedTexture
+    {
+        /**
+         * Key that identifies the texture
+         */
+        std::string key;
+
+        /**
+         * Load generation of the request that produced the texture
+         */
+        uint32_t generation;
+
+        /**
+         * Flag indicating whether the texture was decoded successfully
+         */
+        bool isValid;
+
+        /**
+         * Hash of the source file contents (or of the pixels, for in-memory images)
+         */
+        uint64_t contentHash;
+
+        /**
+         * Flag indicating whether a texture with the same content hash was already decoded.
+         * Duplicates carry no pixel data.
+         */
+        bool isDuplicate;
+
+        /**
+         * Width of the full resolution image
+         */
+        uint32_t width;
+
+        /**
+         * Height of the full resolution image
+         */
+        uint32_t height;
+
+        /**
+         * Number of channels per pixel
+         */
+        uint32_t numChannels;
+
+        /**
+         * Number of bytes per channel (1 for 8-bit images, 2 for 16-bit images)
+         */
+        uint32_t bytesPerChannel;
+
+        /**
+         * Flag indicating whether the pixels are stored in BGRA order instead of RGBA
+         */
+        bool isBGRA;
+
+        /**
+         * Flag indicating whether any pixel of the full resolution image is not fully opaque
+         */
+        bool hasTransparency;
+
+        /**
+         * Maximum number of mip levels to generate. 0 means the full mip chain.
+         */
+        uint32_t maxMipLevels;
+
+        /**
+         * Pixel data of the full resolution image
+         */
+        std::shared_ptr<const uint8_t> basePixels;
+
+        /**
+         * Pixel data of mip levels 1 and up, tightly packed
+         */
+        std::vector<uint8_t> mipStorage;
+
+        /**
+         * Mip levels, from the full resolution image down to 1x1
+         */
+        std::vector<MipLevel> mipLevels;
+
+        /**
+         * @brief Gets the pixel data of the specified mip level.
+         * @param[in] mipLevel Mip level
+         * @return Pointer to the pixel data of the mip level
+         */
+        const uint8_t* GetMipLevelPixels(const uint32_t& mipLevel) const
+        {
+            return (mipLevel == 0) ? basePixels.get() : mipStorage.data() + mipLevels[mipLevel].offset;
+        }
+    };
+
+public:
+    /**
+     * @brief Constructor
+     */
+    TextureStreamer();
+
+    /**
+     * @brief Destructor
+     */
+    ~TextureStreamer();
+
+    /**
+     * @brief Starts the background decoding thread.
+     */
+    void Start();
+
+    /**
+     * @brief Stops the background decoding thread. Pending requests are discarded.
+     */
+    void Stop();
+
+    /**
+     * @brief Sets a function that the decoding thread calls whenever a texture finishes decoding,
+     * e.g., to wake up an event loop that is waiting for events.
+     * @param[in] callback Function to call, or nullptr to call nothing
+     */
+    void SetDecodedCallback(void (*callback)());
+
+    /**
+     * @brief Checks whether any decoded texture is waiting to be taken.
+     * @return Returns true if PopDecodedTexture would return a texture. Returns false otherwise.
+     */
+    bool HasDecodedTextures();
+
+    /**
+     * @brief Checks whether the decoding thread has finished all its work: no request is pending or being decoded,
+     * and every decoded texture has been taken.
+     * @return Returns true if the streamer is idle. Returns false otherwise.
+     */
+    bool IsIdle();
+
+    /**
+     * @brief Queues a texture file for decoding.
+     * @param[in] key Key that identifies the texture
+     * @param[in] filePath Texture file path
+     * @param[in] priority Decoding priority. Requests with higher priority are decoded first.
+     * @param[in] generation Load generation, returned with the decoded texture to recognize stale results
+     */
+    void Request(const std::string& key, const std::string& filePath, const float& priority, const uint32_t& generation);
+
+    /**
+     * @brief Queues an image that is already decoded in memory. Only its mip chain needs to be generated.
+     * @param[in] key Key that identifies the texture
+     * @param[in] image Decoded image
+     * @param[in] priority Decoding priority. Requests with higher priority are decoded first.
+     * @param[in] generation Load generation, returned with the decoded texture to recognize stale results
+     */
+    void Request(const std::string& key, const ImageData& image, const float& priority, const uint32_t& generation);
+
+    /**
+     * @brief Updates the priority of a pending request.
+     * @param[in] key Key that identifies the texture
+     * @param[in] priority New decoding priority
+     */
+    void SetPriority(const std::string& key, const float& priority);
+
+    /**
+     * @brief Makes the decoding thread forget that it decoded a texture with the specified content hash,
+     * so that the next texture with the same contents is decoded in full instead of being reported as a duplicate.
+     * @param[in] contentHash Content hash
+     */
+    void ForgetContentHash(const uint64_t& contentHash);
+
+    /**
+     * @brief Takes one texture that has finished decoding, if there is any.
+     * @param[out] outTexture Decoded texture
+     * @return Returns true if a decoded texture was returned. Returns false otherwise.
+     */
+    bool PopDecodedTexture(DecodedTexture& outTexture);
+
+    /**
+     * @brief Decodes a texture file and generates its mip chain on the calling thread.
+     * @param[in] key Key that identifies the texture
+     * @param[in] filePath Texture file path
+     * @param[out] outTexture Decoded texture
+     * @return Returns true if the texture was decoded successfully. Returns false otherwise.
+     */
+    static bool DecodeFile(const std::string& key, const std::string& filePath, DecodedTexture& outTexture);
+
+    /**
+     * @brief Generates the mip chain of an image that is already decoded in memory. The pixels are not copied.
+     * @param[in] key Key that identifies the texture
+     * @param[in] image Decoded image
+     * @param[out] outTexture Decoded texture
+     * @return Returns true if the texture was prepared successfully. Returns false otherwise.
+     */
+    static bool DecodeImage(const std::string& key, const ImageData& image, DecodedTexture& outTexture);
+
+    /**
+     * @brief Decodes an image file that is already in memory, keeping its channel count and bit depth.
+     * Grayscale and grayscale+alpha images keep 1 and 2 channels, RGB images get an opaque alpha channel,
+     * and 16-bit images keep 16 bits per channel. The color channels of 16-bit images are converted from sRGB
+     * to linear, because they are uploaded to UNORM formats that the sampler does not decode.
+     * @param[in] data File contents
+     * @param[in] size Size of the file contents in bytes
+     * @param[out] outImage Decoded image
+     * @return Returns true if the image was decoded successfully. Returns false otherwise.
+     */
+    static bool DecodeImageFile(const uint8_t* data, const size_t& size, ImageData& outImage);
+
+    /**
+     * @brief Converts a decoded texture and its mip chain to 8-bit RGBA, for devices that cannot sample its original format.
+     * @param[in,out] texture Decoded texture
+     */
+    static void ConvertToRGBA8(DecodedTexture& texture);
+
+    /**
+     * @brief Checks whether any pixel of an image is not fully opaque.
+     * @param[in] image Decoded image
+     * @return Returns true if the image has an alpha channel with a value below the maximum. Returns false otherwise.
+     */
+    static bool HasTransparentPixels(const ImageData& image);
+
+    /**
+     * @brief Converts a linear 16-bit channel value to 8-bit sRGB.
+     * @param[in] value Linear channel value
+     * @return sRGB channel value
+     */
+    static uint8_t EncodeSRGB8(const uint16_t& value);
+
+private:
+    /**
+     * Struct containing a pending decode request
+     */
+    struct DecodeRequest
+    {
+        /**
+         * Key that identifies the texture
+         */
+        std::string key;
+
+        /**
+         * Texture file path
+         */
+        std::string filePath;
+
+        /**
+         * In-memory image, used instead of the file path if it has pixel data
+         */
+        ImageData image;
+
+        /**
+         * Decoding priority
+         */
+        float priority;
+
+        /**
+         * Load generation of the request
+         */
+        uint32_t generation;
+    };
+
+    /**
+     * Requests that are yet to be decoded
+     */
+    std::vector<DecodeRequest> m_pendingRequests;
+
+    /**
+     * Textures that finished decoding but have not been taken by the renderer yet
+     */
+    std::vector<DecodedTexture> m_decodedTextures;
+
+    /**
+     * Mutex guarding the request and result lists
+     */
+    std::mutex m_mutex;
+
+    /**
+     * Condition variable used to wake up the worker thread
+     */
+    std::condition_variable m_condition;
+
+    /**
+     * Background decoding thread
+     */
+    std::thread m_workerThread;
+
+    /**
+     * Content hashes of the textures decoded so far. Only accessed by the worker thread.
+     */
+    std::unordered_set<uint64_t> m_decodedContentHashes;
+
+    /**
+     * Content hashes to remove from the decoded content hashes before the next request. Guarded by the mutex.
+     */
+    std::vector<uint64_t> m_forgottenContentHashes;
+
+    /**
+     * Flag indicating whether the worker thread should keep running
+     */
+    bool m_isRunning;
+
+    /**
+     * Flag indicating whether the worker thread has taken a request whose result is not in the decoded list yet.
+     * Guarded by the mutex.
+     */
+    bool m_isDecoding;
+
+    /**
+     * Function called by the worker thread after each decoded texture. Guarded by the mutex.
+     */
+    void (*m_decodedCallback)();
+
+private:
+    /**
+     * @brief Main loop of the background decoding thread.
+     */
+    void WorkerLoop();
+
+    /**
+     * @brief Reads a file in chunks, hashing each chunk as it arrives.
+     * @param[in] filePath File path
+     * @param[out] outContents File contents
+     * @param[out] outContentHash Hash of the file contents
+     * @return Returns true if the file was read successfully. Returns false otherwise.
+     */
+    static bool ReadFileContents(const std::string& filePath, std::vector<uint8_t>& outContents, uint64_t& outContentHash);
+
+    /**
+     * @brief Decodes the contents of an image file and generates its mip chain.
+     * @param[in] filePath File path, used for error messages
+     * @param[in] contents File contents
+     * @param[out] outTexture Decoded texture. The key and content hash must already be set.
+     * @return Returns true if the texture was decoded successfully. Returns false otherwise.
+     */
+    static bool DecodeFileContents(const std::string& filePath, const std::vector<uint8_t>& contents, DecodedTexture& outTexture);
+
+    /**
+     * @brief Converts a 16-bit sRGB channel value to linear.
+     * @param[in] value sRGB channel value
+     * @return Linear channel value
+     */
+    static uint16_t DecodeSRGB16(const uint16_t& value);
+
+    /**
+     * @brief Computes the hash of a block of data using 64-bit FNV-1a.
+     * @param[in] data Data
+     * @param[in] size Size of the data in bytes
+     * @param[in] hash Hash of the preceding data, used to hash data in chunks
+     * @return Hash of the data
+     */
+    static uint64_t ComputeContentHash(const uint8_t* data, const size_t& size, uint64_t hash);
+
+    /**
+     * @brief Generates the mip chain of a decoded texture using a box filter.
+     * @param[in,out] texture Decoded texture
+     */
+    static void GenerateMipChain(DecodedTexture& texture);
+
+
+    /**
+     * @brief Downsamples a mip level to half its size using a box filter.
+     * @param[in] srcPixels Pixel data of the source mip level
+     * @param[in] src Source mip level
+     * @param[out] dstPixels Pixel data of the destination mip level
+     * @param[in] dst Destination mip level
+     * @param[in] numChannels Number of channels per pixel
+     */
+    template <typename T>
+    static void DownsampleMipLevel(const T* srcPixels, const MipLevel& src, T* dstPixels, const MipLevel& dst, const uint32_t& numChannels);
+};
@@ -54,6 +54,12 @@ public:
      */
     VkBuffer GetHandle();
 
+    /**
+     * @brief Gets the size of the GPU memory allocated for this buffer
+     * @return Size of the allocated memory in bytes. Returns 0 if the buffer has not been created.
+     */
+    VkDeviceSize GetMemorySize() const;
+
 private:
     /**
      * Vulkan buffer
@@ -65,6 +71,11 @@ private:
      */
     VkDeviceMemory m_vkMemory;
 
+    /**
+     * Size of the Vulkan memory allocated for this buffer
+     */
+    VkDeviceSize m_memorySize;
+
 private:
     /**
      * @brief Find the index of a suitable memory type given the requirements
@@ -3,6 +3,8 @@
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 
+#include "Graphics/Vulkan/VulkanTimeline.hpp"
+
 #include <vulkan/vulkan.h>
 
 #include <optional>
@@ -22,7 +24,7 @@ public:
 
     /**
      * @brief Initializes the Vulkan manager.
-     * @param[in] window GLFW window
+     * @param[in] window GLFW window. If null, the context is initialized without a surface for headless rendering.
      * @return Returns true if the initialization was successful. Returns false otherwise.
      */
     static bool Initialize(GLFWwindow* window);
@@ -86,6 +88,46 @@ public:
      */
     static VkCommandPool GetDefaultCommandPool();
 
+    /**
+     * @brief Gets the pipeline cache shared by all pipeline creation. It is loaded from disk on initialization
+     * and saved back on cleanup.
+     * @return Returns the pipeline cache, or VK_NULL_HANDLE if it could not be created.
+     */
+    static VkPipelineCache GetPipelineCache();
+
+    /**
+     * @brief Submits a batch to the graphics queue. Each submission gets a monotonically increasing
+     * timeline value that can be waited on or polled.
+     * @param[in] submitInfo Batch to submit. Its wait and signal semaphores must be binary semaphores.
+     * @param[out] outSubmission Timeline value signaled when the batch completes
+     * @return Returns true if the submission was successful. Returns false otherwise.
+     */
+    static bool SubmitToGraphicsQueue(const VkSubmitInfo& submitInfo, uint64_t& outSubmission);
+
+    /**
+     * @brief Gets the timeline value of the most recent submission that has completed, without blocking.
+     * @return Completed timeline value
+     */
+    static uint64_t GetCompletedSubmission();
+
+    /**
+     * @brief Gets the timeline value of the last submission to the graphics queue.
+     * @return Last submitted timeline value
+     */
+    static uint64_t GetLastSubmission();
+
+    /**
+     * @brief Blocks until a submission has completed.
+     * @param[in] submission Timeline value of the submission. 0 returns immediately.
+     */
+    static void WaitForSubmission(const uint64_t& submission);
+
+    /**
+     * @brief Checks whether submissions are tracked with a timeline semaphore instead of fences.
+     * @return Returns true if timeline semaphores are supported. Returns false otherwise.
+     */
+    static bool IsTimelineSemaphoreSupported();
+
     /**
      * @brief Begins a single use command buffer.
      * @return Returns the command buffer that was created.
@@ -156,6 +198,21 @@ private:
      */
     VkCommandPool m_vkDefaultCommandPool;
 
+    /**
+     * Vulkan pipeline cache
+     */
+    VkPipelineCache m_vkPipelineCache;
+
+    /**
+     * Completion tracking of the graphics queue submissions
+     */
+    VulkanTimeline m_graphicsTimeline;
+
+    /**
+     * File the pipeline cache is loaded from and saved to
+     */
+    const char* PIPELINE_CACHE_FILE_PATH = "pipeline_cache.bin";
+
 private:
     /**
      * @brief Constructor
@@ -170,7 +227,7 @@ private:
 
     /**
      * @brief Initialization code implemented as a member function.
-     * @param[in] window GLFW window
+     * @param[in] window GLFW window. If null, the context is initialized without a surface for headless rendering.
      * @return Returns true if the initialization was successful. Returns false otherwise.
      */
     bool InitInternal(GLFWwindow* window);
@@ -198,11 +255,47 @@ private:
      */
     bool CheckDeviceExtensionSupport(VkPhysicalDevice physicalDevice, const std::vector<const char*>& extensionNames);
 
+    /**
+     * @brief Checks whether the physical device supports timeline semaphores, either through Vulkan 1.2 or
+     * through the VK_KHR_timeline_semaphore extension.
+     * @param[in] physicalDevice Physical device
+     * @param[in] instanceApiVersion API version the instance was created with
+     * @param[out] outUsesExtension Flag indicating whether the extension needs to be enabled
+     * @return Returns true if timeline semaphores are supported. Returns false otherwise.
+     */
+    bool CheckTimelineSemaphoreSupport(VkPhysicalDevice physicalDevice, const uint32_t& instanceApiVersion, bool& outUsesExtension);
+
+    /**
+     * @brief Checks whether all the provided validation layers are installed.
+     * @param[in] layerNames List of layer names to check support
+     * @return Returns true if all the provided layers are supported. Returns false otherwise.
+     */
+    bool CheckValidationLayerSupport(const std::vector<const char*>& layerNames);
+
     /**
      * @brief Gets the indices of each queue type in the physical device's queue family.
      * @param[in] physicalDevice Physical device
-     * @param[in] surface Surface
+     * @param[in] surface Surface. If null, the graphics queue is also used as the present queue.
      * @return Returns a QueueFamilyIndices struct which contains the indices for each queue type.
      */
     QueueFamilyIndices GetQueueFamilyIndices(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface);
+
+    /**
+     * @brief Creates the pipeline cache, seeded with the data saved by a previous run if it was created
+     * by the same device and driver.
+     * @return Returns true if the creation was successful. Returns false otherwise.
+     */
+    bool CreatePipelineCache();
+
+    /**
+     * @brief Saves the contents of the pipeline cache to disk.
+     */
+    void SavePipelineCache();
+
+    /**
+     * @brief Checks whether saved pipeline cache data was created by the current device and driver.
+     * @param[in] data Pipeline cache data
+     * @return Returns true if the data can be used with the current device. Returns false otherwise.
+     */
+    bool IsPipelineCacheDataCompatible(const std::vector<char>& data);
 };
@@ -30,9 +30,10 @@ public:
      * @param[in] tiling Image tiling type
      * @param[in] usageFlags Vulkan flags indicating how the image will be used
      * @param[in] memoryProperties Properties describing how to allocate memory for this image
+     * @param[in] mipLevels Number of mip levels
      * @reutnr Returns true if the creation was successful. Returns false otherwise.
      */
-    bool Create(const uint32_t& width, const uint32_t& height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usageFlags, VkMemoryPropertyFlags memoryProperties);
+    bool Create(const uint32_t& width, const uint32_t& height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usageFlags, VkMemoryPropertyFlags memoryProperties, const uint32_t& mipLevels = 1);
 
     /**
      * @brief Clean up resources used.
@@ -45,6 +46,12 @@ public:
      */
     VkImage GetHandle();
 
+    /**
+     * @brief Gets the size of the GPU memory allocated for this image.
+     * @return Size of the allocated memory in bytes. Returns 0 if the image has not been created.
+     */
+    VkDeviceSize GetMemorySize() const;
+
 private:
     /**
      * Vulkan image handle
@@ -56,6 +63,11 @@ private:
      */
     VkDeviceMemory m_vkMemory;
 
+    /**
+     * Size of the Vulkan memory allocated for this image
+     */
+    VkDeviceSize m_memorySize;
+
     /**
      * @brief Find the index of a suitable memory type given the requirements
      * @param[in] memoryTypeBits Flag containing the supported memory types
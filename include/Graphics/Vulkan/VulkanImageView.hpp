@@ -24,9 +24,12 @@ public:
      * @param[in] image Vulkan image
      * @param[in] format Vulkan image format
      * @param[in] imageAspectFlags Vulkan image aspect flags
+     * @param[in] baseMipLevel First mip level accessible to the view
+     * @param[in] mipLevelCount Number of mip levels accessible to the view
+     * @param[in] components Component swizzle applied when the view is sampled
      * @return Returns true if the creation was successful. Returns false otherwise.
      */
-    bool Create(VkImage image, VkFormat format, VkImageAspectFlags imageAspectFlags);
+    bool Create(VkImage image, VkFormat format, VkImageAspectFlags imageAspectFlags, const uint32_t& baseMipLevel = 0, const uint32_t& mipLevelCount = 1, const VkComponentMapping& components = {});
 
     /**
      * @brief Cleans up the resources used.
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Graphics/Vulkan/VulkanBuffer.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+
+/**
+ * Persistently mapped, host-visible buffer split into one region per frame in flight. Per-frame data is
+ * sub-allocated linearly from the current frame's region, and the regions are reused in turn once the
+ * frames that wrote them have completed. Allocations are addressed through dynamic descriptor offsets.
+ */
+class VulkanRingBuffer
+{
+public:
+    /**
+     * @brief Constructor
+     */
+    VulkanRingBuffer();
+
+    /**
+     * @brief Destructor
+     */
+    ~VulkanRingBuffer();
+
+    /**
+     * @brief Creates and maps the buffer.
+     * @param[in] frameSize Size in bytes of the region of each frame in flight, including alignment padding
+     * @param[in] numFramesInFlight Number of frames in flight
+     * @param[in] usageFlags Vulkan flags describing how the buffer will be used
+     * @return Returns true if the creation was successful. Returns false otherwise.
+     */
+    bool Create(const VkDeviceSize& frameSize, const uint32_t& numFramesInFlight, VkBufferUsageFlags usageFlags);
+
+    /**
+     * @brief Unmaps and destroys the buffer.
+     */
+    void Cleanup();
+
+    /**
+     * @brief Starts allocating from the region of a frame in flight, discarding its previous allocations.
+     * The previous submission of the frame must have completed.
+     * @param[in] frameIndex Index of the frame in flight
+     */
+    void BeginFrame(const uint32_t& frameIndex);
+
+    /**
+     * @brief Allocates memory from the current frame's region.
+     * @param[in] size Size in bytes
+     * @param[in] alignment Required alignment of the offset (e.g., minUniformBufferOffsetAlignment)
+     * @param[out] outOffset Offset of the allocation from the start of the buffer
+     * @return Pointer to the mapped memory of the allocation. Returns nullptr if the region is full.
+     */
+    void* Allocate(const VkDeviceSize& size, const VkDeviceSize& alignment, uint32_t& outOffset);
+
+    /**
+     * @brief Gets the Vulkan buffer handle.
+     * @return Vulkan buffer handle
+     */
+    VkBuffer GetHandle();
+
+    /**
+     * @brief Gets the size of the GPU memory allocated for the buffer.
+     * @return Size of the allocated memory in bytes. Returns 0 if the buffer has not been created.
+     */
+    VkDeviceSize GetMemorySize() const;
+
+private:
+    /**
+     * Buffer holding the regions of all frames in flight
+     */
+    VulkanBuffer m_buffer;
+
+    /**
+     * Host pointer to the start of the buffer, mapped for the whole lifetime of the buffer
+     */
+    uint8_t* m_mappedData;
+
+    /**
+     * Size in bytes of the region of each frame in flight
+     */
+    VkDeviceSize m_frameSize;
+
+    /**
+     * Offset of the end of the current frame's region
+     */
+    VkDeviceSize m_frameEnd;
+
+    /**
+     * Offset of the next free byte in the current frame's region
+     */
+    VkDeviceSize m_head;
+};
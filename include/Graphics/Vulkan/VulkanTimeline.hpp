@@ -0,0 +1,138 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+/**
+ * Tracks the completion of queue submissions. Each submission gets a monotonically increasing value,
+ * which is signaled on a timeline semaphore if the device supports them, or on a pooled fence otherwise.
+ */
+class VulkanTimeline
+{
+public:
+    /**
+     * @brief Constructor
+     */
+    VulkanTimeline();
+
+    /**
+     * @brief Destructor
+     */
+    ~VulkanTimeline();
+
+    /**
+     * @brief Creates the timeline.
+     * @param[in] device Logical device
+     * @param[in] useTimelineSemaphore Flag indicating whether the timelineSemaphore feature is enabled on the device
+     * @param[in] useExtensionEntryPoints Flag indicating whether the feature comes from VK_KHR_timeline_semaphore instead of Vulkan 1.2
+     * @return Returns true if the creation was successful. Returns false otherwise.
+     */
+    bool Create(VkDevice device, const bool& useTimelineSemaphore, const bool& useExtensionEntryPoints);
+
+    /**
+     * @brief Cleans up the resources used by the timeline. No submission may be pending.
+     */
+    void Cleanup();
+
+    /**
+     * @brief Submits a batch to a queue and signals the next timeline value when it completes.
+     * @param[in] queue Queue to submit to
+     * @param[in] submitInfo Batch to submit. Its wait and signal semaphores must be binary semaphores,
+     * and it may signal at most 7 of them.
+     * @param[out] outValue Timeline value signaled when the batch completes
+     * @return Returns true if the submission was successful. Returns false otherwise.
+     */
+    bool Submit(VkQueue queue, const VkSubmitInfo& submitInfo, uint64_t& outValue);
+
+    /**
+     * @brief Gets the highest timeline value whose submission has completed, without blocking.
+     * @return Completed timeline value
+     */
+    uint64_t GetCompletedValue();
+
+    /**
+     * @brief Gets the timeline value of the last submission.
+     * @return Last submitted timeline value
+     */
+    uint64_t GetLastSubmittedValue() const;
+
+    /**
+     * @brief Blocks until the submission with the given timeline value has completed.
+     * Values that were never submitted (e.g., 0) return immediately.
+     * @param[in] value Timeline value
+     */
+    void Wait(const uint64_t& value);
+
+    /**
+     * @brief Checks whether submissions are tracked with a timeline semaphore.
+     * @return Returns true if a timeline semaphore is used. Returns false if fences are used instead.
+     */
+    bool IsUsingTimelineSemaphore() const;
+
+private:
+    /**
+     * Struct containing a fence of a submission that has not been seen completing yet
+     */
+    struct PendingFence
+    {
+        /**
+         * Fence signaled by the submission
+         */
+        VkFence fence;
+
+        /**
+         * Timeline value of the submission
+         */
+        uint64_t value;
+    };
+
+    /**
+     * Logical device
+     */
+    VkDevice m_vkDevice;
+
+    /**
+     * Timeline semaphore, or VK_NULL_HANDLE if fences are used instead
+     */
+    VkSemaphore m_vkTimelineSemaphore;
+
+    /**
+     * vkWaitSemaphores or vkWaitSemaphoresKHR
+     */
+    PFN_vkWaitSemaphores m_pfnWaitSemaphores;
+
+    /**
+     * vkGetSemaphoreCounterValue or vkGetSemaphoreCounterValueKHR
+     */
+    PFN_vkGetSemaphoreCounterValue m_pfnGetSemaphoreCounterValue;
+
+    /**
+     * Timeline value of the last submission
+     */
+    uint64_t m_lastSubmittedValue;
+
+    /**
+     * Highest timeline value known to have completed
+     */
+    uint64_t m_completedValue;
+
+    /**
+     * Fences of the pending submissions in submission order. Only used without a timeline semaphore.
+     */
+    std::deque<PendingFence> m_pendingFences;
+
+    /**
+     * Unsignaled fences ready to be reused. Only used without a timeline semaphore.
+     */
+    std::vector<VkFence> m_freeFences;
+
+private:
+    /**
+     * @brief Takes a fence from the free list, or creates a new one if the list is empty.
+     * @return Fence, or VK_NULL_HANDLE if the creation failed
+     */
+    VkFence AcquireFence();
+};
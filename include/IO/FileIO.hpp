@@ -12,5 +12,13 @@ namespace FileIO
      * @return Returns true if the file was successfully read. Returns false otherwise.
      */
     extern bool ReadFileAsBinary(const std::string& filePath, std::vector<char>& outFileContents);
+
+    /**
+     * @brief Write the provided contents to the specified file as binary, replacing the file if it exists.
+     * @param[in] filePath File path
+     * @param[in] fileContents Contents to write
+     * @return Returns true if the file was successfully written. Returns false otherwise.
+     */
+    extern bool WriteFileAsBinary(const std::string& filePath, const std::vector<char>& fileContents);
 }
 
@@ -108,6 +108,11 @@ private:
      */
     int m_mouseScrollY;
 
+    /**
+     * Flag indicating whether any input event was received since the last call to Prepare
+     */
+    bool m_hasEvents;
+
     /**
      * @brief Constructor
      */
@@ -202,6 +207,18 @@ public:
      */
     static int GetMouseScrollY();
 
+    /**
+     * @brief Has any input event been received since the input manager was last prepared?
+     * @return True if an input event was received. False otherwise.
+     */
+    static bool HasEvents();
+
+    /**
+     * @brief Is any key or button being held down?
+     * @return True if at least one key or button is held down. False otherwise.
+     */
+    static bool IsAnyDown();
+
     /**
      * @brief Prepare the input manager for polling its new state
      */
@@ -0,0 +1,278 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define CPU_PROFILER_CONCAT_INNER(a, b) a##b
+#define CPU_PROFILER_CONCAT(a, b) CPU_PROFILER_CONCAT_INNER(a, b)
+
+/**
+ * Records a zone named after the string literal from this point to the end of the enclosing scope
+ */
+#define PROFILE_ZONE(name) CpuProfiler::ScopedZone CPU_PROFILER_CONCAT(profileZone, __LINE__)(name)
+
+/**
+ * Records a zone named after the enclosing function from this point to the end of the enclosing scope
+ */
+#define PROFILE_FUNCTION() PROFILE_ZONE(__func__)
+
+/**
+ * Records timed zones of CPU work on every thread. Each thread writes into its own ring buffer without locking,
+ * so zones are cheap enough to leave in the frame loop. Zones can be shown as a flame chart or exported
+ * to the Chrome trace format, which chrome://tracing and Perfetto can open.
+ */
+class CpuProfiler
+{
+public:
+    /**
+     * Struct describing a finished zone
+     */
+    struct Zone
+    {
+        /**
+         * Zone name. Must point to a string that outlives the profiler (e.g., a string literal).
+         */
+        const char* name;
+
+        /**
+         * Start time (in nanoseconds since the profiler was created)
+         */
+        uint64_t startTime;
+
+        /**
+         * End time (in nanoseconds since the profiler was created)
+         */
+        uint64_t endTime;
+
+        /**
+         * Number of zones the zone is nested in on its thread
+         */
+        uint32_t depth;
+    };
+
+    /**
+     * Struct containing the zones of one thread
+     */
+    struct ThreadZones
+    {
+        /**
+         * Thread name
+         */
+        std::string threadName;
+
+        /**
+         * Thread identifier, in the order threads first recorded a zone
+         */
+        uint32_t threadId;
+
+        /**
+         * Zones, in the order they finished
+         */
+        std::vector<Zone> zones;
+    };
+
+    /**
+     * Records a zone from its construction to its destruction
+     */
+    class ScopedZone
+    {
+    public:
+        /**
+         * @brief Constructor. Starts the zone.
+         * @param[in] name Zone name. Must point to a string that outlives the profiler (e.g., a string literal).
+         */
+        ScopedZone(const char* name);
+
+        /**
+         * @brief Destructor. Ends the zone.
+         */
+        ~ScopedZone();
+
+        // Delete copy constructor and copy operator
+        ScopedZone(const ScopedZone&) = delete;
+        void operator=(const ScopedZone&) = delete;
+
+    private:
+        /**
+         * Zone name
+         */
+        const char* m_name;
+
+        /**
+         * Start time (in nanoseconds since the profiler was created)
+         */
+        uint64_t m_startTime;
+    };
+
+public:
+    // Delete copy constructor and copy operator
+    CpuProfiler(const CpuProfiler&) = delete;
+    void operator=(const CpuProfiler&) = delete;
+
+    /**
+     * @brief Destructor
+     */
+    ~CpuProfiler();
+
+    /**
+     * @brief Enables or disables recording. Zones that start while recording is disabled are dropped.
+     * @param[in] isEnabled Flag indicating whether to record zones
+     */
+    static void SetEnabled(const bool& isEnabled);
+
+    /**
+     * @brief Checks whether zones are being recorded.
+     * @return Returns true if zones are being recorded. Returns false otherwise.
+     */
+    static bool IsEnabled();
+
+    /**
+     * @brief Names the calling thread in the flame chart and in exported traces.
+     * @param[in] threadName Thread name
+     */
+    static void SetThreadName(const std::string& threadName);
+
+    /**
+     * @brief Gets the current time on the profiler's clock.
+     * @return Time (in nanoseconds since the profiler was created)
+     */
+    static uint64_t GetTime();
+
+    /**
+     * @brief Copies the zones of every thread that finished within a time range. Zones that were overwritten
+     * in a thread's ring buffer are missing.
+     * @param[in] startTime Start of the time range (in nanoseconds since the profiler was created)
+     * @param[in] endTime End of the time range (in nanoseconds since the profiler was created)
+     * @param[out] outThreadZones Zones of each thread
+     */
+    static void GetZones(const uint64_t& startTime, const uint64_t& endTime, std::vector<ThreadZones>& outThreadZones);
+
+    /**
+     * @brief Finds the most recent zone with the specified name recorded on the calling thread.
+     * @param[in] name Zone name
+     * @param[out] outZone Zone
+     * @return Returns true if a zone was found. Returns false otherwise.
+     */
+    static bool FindLatestZone(const std::string& name, Zone& outZone);
+
+    /**
+     * @brief Writes all the zones that are still in the ring buffers into a Chrome trace JSON file.
+     * @param[in] filePath Output file path
+     * @return Returns true if the file was written successfully. Returns false otherwise.
+     */
+    static bool WriteChromeTrace(const std::string& filePath);
+
+private:
+    /**
+     * Number of zones kept per thread
+     */
+    static const uint32_t ZONES_PER_THREAD = 1 << 16;
+
+    /**
+     * Struct containing the ring buffer of a thread. Only the owning thread writes into it.
+     */
+    struct ThreadBuffer
+    {
+        /**
+         * Thread name
+         */
+        std::string threadName;
+
+        /**
+         * Thread identifier
+         */
+        uint32_t threadId;
+
+        /**
+         * Number of zones that are open on the thread
+         */
+        uint32_t depth;
+
+        /**
+         * Ring buffer of finished zones
+         */
+        std::vector<Zone> zones;
+
+        /**
+         * Total number of zones written. Published with release ordering after each write.
+         */
+        std::atomic<uint64_t> numWrittenZones;
+
+        /**
+         * Flag indicating whether a running thread owns the buffer. Guarded by the mutex of the buffer list.
+         */
+        bool isInUse;
+    };
+
+    /**
+     * Struct owning the ring buffer of a thread, which hands the buffer back for reuse when the thread exits
+     */
+    struct ThreadBufferOwner
+    {
+        /**
+         * Ring buffer of the thread, or nullptr if the thread has not recorded a zone yet
+         */
+        ThreadBuffer* threadBuffer = nullptr;
+
+        /**
+         * @brief Destructor. Releases the ring buffer.
+         */
+        ~ThreadBufferOwner();
+    };
+
+    /**
+     * Ring buffers of every thread that recorded a zone. The buffer of a thread that exits is reused
+     * by the next thread that records a zone, so short-lived threads do not each allocate a buffer.
+     */
+    std::vector<std::unique_ptr<ThreadBuffer>> m_threadBuffers;
+
+    /**
+     * Mutex guarding the list of ring buffers. Only taken when a thread records its first zone or exits, and when reading.
+     */
+    std::mutex m_threadBuffersMutex;
+
+    /**
+     * Flag indicating whether zones are recorded
+     */
+    std::atomic<bool> m_isEnabled;
+
+    /**
+     * Time at which the profiler was created (in nanoseconds on the steady clock)
+     */
+    int64_t m_epoch;
+
+private:
+    /**
+     * @brief Constructor
+     */
+    CpuProfiler();
+
+    /**
+     * @brief Gets the singleton instance for this class.
+     * @return Returns the singleton instance for this class.
+     */
+    static CpuProfiler& GetSingletonInstance();
+
+    /**
+     * @brief Gets the ring buffer of the calling thread, creating it the first time.
+     * @return Ring buffer of the calling thread
+     */
+    ThreadBuffer& GetThreadBuffer();
+
+    /**
+     * @brief Marks the ring buffer of a thread that exits as free, so that another thread can reuse it.
+     * @param[in] threadBuffer Ring buffer
+     */
+    void ReleaseThreadBuffer(ThreadBuffer& threadBuffer);
+
+    /**
+     * @brief Copies the zones of a ring buffer that have not been overwritten and are not being written.
+     * @param[in] threadBuffer Ring buffer
+     * @param[out] outZones Zones, in the order they finished
+     */
+    static void CopyZones(const ThreadBuffer& threadBuffer, std::vector<Zone>& outZones);
+};
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Estimates the latency of each frame from the CPU side. Input-to-submit is the time from sampling the input
+ * used by a frame to submitting its commands. Submit-to-present is the time from the submission until the frame's
+ * rendering is observed to have completed, which is when its image can be presented. Completion is only observed
+ * when the tracker is updated, so the second estimate is an upper bound within one update of the actual time.
+ */
+class LatencyTracker
+{
+public:
+    /**
+     * Struct containing the recent values of one latency
+     */
+    struct LatencyHistory
+    {
+        /**
+         * Latencies of the most recent frames (in milliseconds), used as a ring buffer
+         */
+        std::vector<float> times;
+
+        /**
+         * Index of the oldest latency in the ring buffer
+         */
+        uint32_t offset;
+
+        /**
+         * Latency of the most recent frame (in milliseconds)
+         */
+        float latest;
+
+        /**
+         * Average of the latencies in the ring buffer (in milliseconds)
+         */
+        float average;
+    };
+
+public:
+    /**
+     * @brief Constructor
+     */
+    LatencyTracker();
+
+    /**
+     * @brief Destructor
+     */
+    ~LatencyTracker();
+
+    /**
+     * @brief Prepares tracking for the given number of frames in flight, discarding all samples.
+     * @param[in] numFramesInFlight Number of frames in flight
+     */
+    void Initialize(const uint32_t& numFramesInFlight);
+
+    /**
+     * @brief Records the submission of a frame.
+     * @param[in] frameIndex Index of the frame in flight
+     * @param[in] submission Graphics queue submission of the frame
+     * @param[in] inputTime Time at which the input used by the frame was sampled (in seconds)
+     * @param[in] submitTime Time at which the frame was submitted (in seconds)
+     */
+    void RecordSubmit(const uint32_t& frameIndex, const uint64_t& submission, const double& inputTime, const double& submitTime);
+
+    /**
+     * @brief Completes the samples of the frames whose submissions have completed.
+     * @param[in] completedSubmission Last completed graphics queue submission
+     * @param[in] currentTime Current time (in seconds)
+     */
+    void Update(const uint64_t& completedSubmission, const double& currentTime);
+
+    /**
+     * @brief Gets the input-to-submit latencies of the most recent frames.
+     * @return Input-to-submit latency history
+     */
+    const LatencyHistory& GetInputToSubmitHistory() const;
+
+    /**
+     * @brief Gets the submit-to-present latencies of the most recent frames.
+     * @return Submit-to-present latency history
+     */
+    const LatencyHistory& GetSubmitToPresentHistory() const;
+
+    /**
+     * @brief Gets the number of frames whose latencies were fully measured.
+     * @return Number of completed samples
+     */
+    uint64_t GetSampleCount() const;
+
+private:
+    /**
+     * Struct containing a frame whose submission has not been observed to complete yet
+     */
+    struct PendingFrame
+    {
+        /**
+         * Graphics queue submission of the frame. 0 if the frame slot has no pending frame.
+         */
+        uint64_t submission;
+
+        /**
+         * Time at which the frame was submitted (in seconds)
+         */
+        double submitTime;
+
+        /**
+         * Input-to-submit latency of the frame (in milliseconds)
+         */
+        float inputToSubmit;
+    };
+
+private:
+    /**
+     * Number of frames kept in the latency histories
+     */
+    const uint32_t HISTORY_LENGTH = 240;
+
+    /**
+     * Pending frame of each frame slot
+     */
+    std::vector<PendingFrame> m_pendingFrames;
+
+    /**
+     * Input-to-submit latencies of the most recent frames
+     */
+    LatencyHistory m_inputToSubmitHistory;
+
+    /**
+     * Submit-to-present latencies of the most recent frames
+     */
+    LatencyHistory m_submitToPresentHistory;
+
+    /**
+     * Number of frames whose latencies were fully measured
+     */
+    uint64_t m_numSamples;
+
+private:
+    /**
+     * @brief Adds a latency to a history and updates its average.
+     * @param[in] time Latency (in milliseconds)
+     * @param[in,out] history History to add the latency to
+     */
+    void AddToHistory(const float& time, LatencyHistory& history);
+};
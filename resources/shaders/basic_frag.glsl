@@ -9,15 +9,24 @@ layout(location = 0) out vec4 finalFragColor;
 layout(set = 2, binding = 0) uniform sampler2D emissiveMap;
 layout(set = 3, binding = 0) uniform sampler2D diffuseMap;
 
+// Pipeline permutation features, set by the renderer through specialization constants
+layout(constant_id = 0) const bool HAS_EMISSIVE_MAP = true;
+layout(constant_id = 1) const bool USE_ALPHA_TEST = true;
+
 void main()
 {
-    vec4 emission = texture(emissiveMap, fragUV);
+    // Without an emissive map, the emission is opaque black (the same as the default emissive texture)
+    vec4 emission = vec4(0.0, 0.0, 0.0, 1.0);
+    if (HAS_EMISSIVE_MAP)
+    {
+        emission = texture(emissiveMap, fragUV);
+    }
     float emissionAlpha = emission.a;
 
     vec4 diffuse = texture(diffuseMap, fragUV);
     float diffuseAlpha = diffuse.a;
 
-    if (emissionAlpha * diffuseAlpha < 0.1)
+    if (USE_ALPHA_TEST && (emissionAlpha * diffuseAlpha < 0.1))
     {
         discard;
     }
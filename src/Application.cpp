@@ -1,9 +1,14 @@
 #include "Application.hpp"
 
+#include "Benchmark/BenchmarkReport.hpp"
+
+#include "Graphics/Vulkan/VulkanBuffer.hpp"
 #include "Graphics/Vulkan/VulkanContext.hpp"
 
 #include "Input/Input.hpp"
 
+#include "Profiling/CpuProfiler.hpp"
+
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_vulkan.h"
@@ -11,32 +16,86 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <thread>
 
-Application::Application()
-    : m_window(nullptr)
+Application::Application(const LaunchOptions& launchOptions)
+    : m_launchOptions(launchOptions)
+    , m_window(nullptr)
     , m_wasFramebufferResized(false)
     , m_vkImageAvailableSemaphores()
     , m_vkRenderFinishedSemaphores()
-    , m_vkFrameInFlightFences()
-    , m_vkImageInFlightFences()
+    , m_frameSubmissions()
+    , m_imageSubmissions()
     , m_vkCommandPool(VK_NULL_HANDLE)
     , m_vkSwapchain(VK_NULL_HANDLE)
     , m_vkSwapchainImages()
+    , m_offscreenColorImages()
     , m_vkSwapchainImageViews()
     , m_vkSwapchainImageFormat()
     , m_vkSwapchainImageExtent()
+    , m_vkSwapchainPresentMode(VK_PRESENT_MODE_FIFO_KHR)
+    , m_availablePresentModes()
+    , m_minSwapchainImageCount(0)
+    , m_maxSwapchainImageCount(0)
     , m_vkCommandBuffers()
+    , m_vkImGuiCommandBuffers()
     , m_vkDepthBufferImage()
     , m_vkDepthBufferImageView()
     , m_vkRenderPass(VK_NULL_HANDLE)
+    , m_vkScenePass(VK_NULL_HANDLE)
+    , m_vkOverlayPass(VK_NULL_HANDLE)
     , m_vkSwapchainFramebuffers()
-    , m_maxFramesInFlight(1)
+    , m_retiredSwapchains()
+    , m_renderTargetImages()
+    , m_renderTargetImageViews()
+    , m_renderTargetFramebuffers()
+    , m_maxFramesInFlight(launchOptions.framesInFlight)
     , m_camera()
     , m_renderer()
     , m_currentModel()
     , m_currentModelTransform(1.0f)
+    , m_instanceTransforms()
+    , m_importOptions()
+    , m_cameraPath()
+    , m_gpuProfiler()
     , m_vkImguiPool(VK_NULL_HANDLE)
+    , m_isIdleModeEnabled(launchOptions.idleMode)
+    , m_numFramesToRender(IDLE_SETTLE_FRAMES)
+    , m_idleTime(0.0)
+    , m_lastIdleDuration(0.0)
+    , m_numRenderedFrames(0)
+    , m_numIdleWakeups(0)
+    , m_runStartTime(0.0)
+    , m_isLowLatencyModeEnabled(launchOptions.lowLatency)
+    , m_frameRateLimit(launchOptions.frameRateLimit)
+    , m_nextFrameTime(0.0)
+    , m_inputSampleTime(0.0)
+    , m_latencyTracker()
+    , m_requestedPresentMode(launchOptions.presentMode)
+    , m_requestedSwapchainImageCount(launchOptions.swapchainImageCount)
+    , m_wasSwapchainSettingChanged(false)
+    , m_presentModeStatistics()
+    , m_lastPresentTime(0.0)
+    , m_numRecordedLatencySamples(0)
+    , m_isDynamicResolutionSupported(false)
+    , m_isDynamicResolutionEnabled(launchOptions.dynamicResolution)
+    , m_targetFrameTime(launchOptions.targetFrameTime)
+    , m_minRenderScale(launchOptions.minRenderScale)
+    , m_maxRenderScale(launchOptions.maxRenderScale)
+    , m_renderScale(launchOptions.maxRenderScale)
+    , m_frameRenderScales(launchOptions.framesInFlight, 1.0f)
+    , m_lastGpuFrameTime(0.0f)
+    , m_previousViewMatrix(1.0f)
 {
 }
 
@@ -46,16 +105,26 @@ Application::~Application()
 
 void Application::Run()
 {
+    CpuProfiler::SetThreadName("Main");
+
+    std::chrono::steady_clock::time_point startupStartTime = std::chrono::steady_clock::now();
     if (!Initialize())
     {
         Cleanup();
         return;
     }
 
-    if (!m_renderer.Initialize(m_maxFramesInFlight, m_vkRenderPass))
+    if (!m_renderer.Initialize(m_maxFramesInFlight, m_launchOptions.recordingThreads, m_vkRenderPass))
     {
         std::cout << "Failed to initialize renderer!" << std::endl;
     }
+    m_renderer.SetGpuProfiler(&m_gpuProfiler);
+    m_renderer.SetAlphaMaskSplitEnabled(!m_launchOptions.disableAlphaMaskSplit);
+
+    // Covers the Vulkan, ImGui and renderer initialization, including all pipeline creation
+    std::cout << "Startup took "
+        << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startupStartTime).count() << " ms ("
+        << m_renderer.GetPipelineCount() << " pipeline(s) created in " << m_renderer.GetPipelineCreationTime() << " ms)" << std::endl;
 
     m_camera.GetCamera().SetFieldOfView(90.0f);
     m_camera.GetCamera().SetAspectRatio(GetSwapchainImageExtent().width * 1.0f / GetSwapchainImageExtent().height);
@@ -63,23 +132,107 @@ void Application::Run()
     m_camera.SetPitch(0.0f);
     m_camera.SetYaw(0.0f);
 
+    if (m_launchOptions.useSyntheticScene)
+    {
+        LoadSyntheticScene(m_launchOptions.syntheticScene);
+    }
+    else if (!m_launchOptions.modelFilePath.empty())
+    {
+        LoadModel(m_launchOptions.modelFilePath);
+    }
+
+    if (m_launchOptions.headless)
+    {
+        RunHeadless();
+        if (!m_launchOptions.cpuTraceOutputPath.empty())
+        {
+            CpuProfiler::WriteChromeTrace(m_launchOptions.cpuTraceOutputPath);
+        }
+        if (!m_launchOptions.statisticsOutputPath.empty())
+        {
+            WriteRendererStatistics();
+        }
+        Cleanup();
+        return;
+    }
+
+    // Finished texture decodes wake up the event loop while it waits in idle mode
+    m_renderer.SetTextureDecodedCallback(glfwPostEmptyEvent);
+
+    m_latencyTracker.Initialize(m_maxFramesInFlight);
+
     double prevTime = glfwGetTime();
+    m_runStartTime = prevTime;
+    m_inputSampleTime = prevTime;
 
-    uint32_t currentFrame = 0;
-    while (!glfwWindowShouldClose(m_window))
+    // Advances the camera by the time since the previous update, using the latest sampled input
+    auto updateFrame = [this, &prevTime]()
     {
         double currentTime = glfwGetTime();
         float deltaTime = static_cast<float>(currentTime - prevTime);
         prevTime = currentTime;
-        Update(deltaTime); 
+        Update(deltaTime);
+
+        if (!m_launchOptions.recordedCameraPathFilePath.empty())
+        {
+            m_cameraPath.AddKeyframe(m_camera);
+        }
+    };
+
+    uint32_t currentFrame = 0;
+    while (!glfwWindowShouldClose(m_window))
+    {
+        // In idle mode, sleep until something invalidates the frame instead of rendering the same image again
+        if (m_isIdleModeEnabled && (m_numFramesToRender == 0))
+        {
+            {
+                PROFILE_ZONE("WaitEvents");
+                double waitStartTime = glfwGetTime();
+                glfwWaitEventsTimeout(IDLE_WAIT_TIMEOUT);
+                m_inputSampleTime = glfwGetTime();
+                m_lastIdleDuration = m_inputSampleTime - waitStartTime;
+                m_idleTime += m_lastIdleDuration;
+            }
+
+            CheckFrameInvalidation();
+            if (m_numFramesToRender == 0)
+            {
+                ++m_numIdleWakeups;
+                continue;
+            }
+
+            // Neither the camera nor the measured frame time may include the time spent idle
+            prevTime = glfwGetTime();
+            m_lastPresentTime = 0.0;
+        }
+
+        PROFILE_ZONE("Frame");
+
+        // In low-latency mode, the waits below happen before the input is sampled, so the input is not
+        // a whole frame old by the time the frame is recorded
+        bool isLowLatencyFrame = m_isLowLatencyModeEnabled;
+        if (!isLowLatencyFrame)
+        {
+            WaitForFrameLimit();
+            updateFrame();
+        }
 
         // --- Draw frame ---
         // In case the current frame is still in flight, we wait for the frame to become free
-        vkWaitForFences(VulkanContext::GetLogicalDevice(), 1, &m_vkFrameInFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+        {
+            PROFILE_ZONE("WaitForFrameSlot");
+            VulkanContext::WaitForSubmission(m_frameSubmissions[currentFrame]);
+        }
+        m_latencyTracker.Update(VulkanContext::GetCompletedSubmission(), glfwGetTime());
+        DestroyRetiredSwapchains(false);
 
         // Get the index of the next available image
         uint32_t imageIndex;
-        VkResult acquireImageResult = vkAcquireNextImageKHR(VulkanContext::GetLogicalDevice(), m_vkSwapchain, UINT64_MAX, m_vkImageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex);
+        VkResult acquireImageResult = VK_SUCCESS;
+        {
+            PROFILE_ZONE("AcquireNextImage");
+            acquireImageResult = vkAcquireNextImageKHR(VulkanContext::GetLogicalDevice(), m_vkSwapchain, UINT64_MAX, m_vkImageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex);
+        }
         if (acquireImageResult == VK_ERROR_OUT_OF_DATE_KHR)
         {
             m_wasFramebufferResized = false;
@@ -100,70 +253,20 @@ void Application::Run()
         }
 
         // If the target image is being used by another frame that is currently in flight, we wait for that frame in flight to finish
-        if (m_vkImageInFlightFences[imageIndex] != VK_NULL_HANDLE)
         {
-            vkWaitForFences(VulkanContext::GetLogicalDevice(), 1, &m_vkImageInFlightFences[imageIndex], VK_TRUE, UINT64_MAX);
+            PROFILE_ZONE("WaitForImage");
+            VulkanContext::WaitForSubmission(m_imageSubmissions[imageIndex]);
         }
-        m_vkImageInFlightFences[imageIndex] = m_vkFrameInFlightFences[currentFrame];
-
-        VkCommandBuffer& commandBuffer = m_vkCommandBuffers[imageIndex];
-        vkResetCommandBuffer(commandBuffer, 0);
 
-        VkCommandBufferBeginInfo beginInfo = {};
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        beginInfo.flags = 0; // Optional
-        beginInfo.pInheritanceInfo = nullptr; // Optional; only relevant for secondary command buffers
-
-        // Begin command buffer
-        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+        if (isLowLatencyFrame)
         {
-            std::cout << "Failed to begin recording command buffer!" << std::endl;
-            glfwSetWindowShouldClose(m_window, GLFW_TRUE);
-            continue;
+            WaitForFrameLimit();
+            SampleInput();
+            updateFrame();
         }
 
-        // Begin render pass
-        VkRenderPassBeginInfo renderPassInfo = {};
-        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-        renderPassInfo.renderPass = m_vkRenderPass;
-        renderPassInfo.framebuffer = m_vkSwapchainFramebuffers[imageIndex];
-        // Size of the render area
-        renderPassInfo.renderArea.offset = { 0, 0 };
-        renderPassInfo.renderArea.extent = GetSwapchainImageExtent();
-
-        // Clear values (1 for color buffer, 1 for depth buffer)
-        std::array<VkClearValue, 2> clearValues;
-        clearValues[0].color = {{ 1.0f, 0.0f, 0.0f, 1.0f }};
-        clearValues[1].depthStencil = { 1.0f, 0 };
-        renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-        renderPassInfo.pClearValues = clearValues.data();
-        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-
-        // We set viewport and scissors to be dynamic, so we set them here as a command
-        VkViewport viewport = {};
-        viewport.x = 0.0f;
-        viewport.y = 0.0f;
-        viewport.width = static_cast<float>(GetSwapchainImageExtent().width);
-        viewport.height = static_cast<float>(GetSwapchainImageExtent().height);
-        viewport.minDepth = 0.0f;
-        viewport.maxDepth = 1.0f;
-
-        VkRect2D scissor = {};
-        scissor.offset = { 0, 0 };
-        scissor.extent = GetSwapchainImageExtent();
-
-        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
-        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-
-        Render(commandBuffer, imageIndex);
-
-        vkCmdEndRenderPass(commandBuffer);
-
-        // Finish recording buffer.
-        // This is where we have error handling.
-        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+        if (!RecordCommandBuffer(m_vkCommandBuffers[currentFrame], currentFrame, imageIndex))
         {
-            std::cout << "Failed to end recording of command buffer!" << std::endl;
             glfwSetWindowShouldClose(m_window, GLFW_TRUE);
             continue;
         }
@@ -179,19 +282,19 @@ void Application::Run()
         submitInfo.pWaitDstStageMask = waitStages;
         // Which command buffer/s to submit
         submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &m_vkCommandBuffers[imageIndex];
+        submitInfo.pCommandBuffers = &m_vkCommandBuffers[currentFrame];
         VkSemaphore signalSemaphores[] = { m_vkRenderFinishedSemaphores[currentFrame] };
         submitInfo.signalSemaphoreCount = 1;
         submitInfo.pSignalSemaphores = signalSemaphores;
 
-        vkResetFences(VulkanContext::GetLogicalDevice(), 1, &m_vkFrameInFlightFences[currentFrame]);
-
-        if (vkQueueSubmit(VulkanContext::GetGraphicsQueue(), 1, &submitInfo, m_vkFrameInFlightFences[currentFrame]) != VK_SUCCESS)
+        if (!VulkanContext::SubmitToGraphicsQueue(submitInfo, m_frameSubmissions[currentFrame]))
         {
             std::cout << "Failed to submit draw command buffer!" << std::endl;
             glfwSetWindowShouldClose(m_window, GLFW_TRUE);
             continue;
         }
+        m_imageSubmissions[imageIndex] = m_frameSubmissions[currentFrame];
+        m_latencyTracker.RecordSubmit(currentFrame, m_frameSubmissions[currentFrame], m_inputSampleTime, glfwGetTime());
 
         // Present
         VkPresentInfoKHR presentInfo = {};
@@ -205,10 +308,20 @@ void Application::Run()
         presentInfo.pImageIndices = &imageIndex;
         presentInfo.pResults = nullptr; // Optional
 
-        VkResult presentResult = vkQueuePresentKHR(VulkanContext::GetGraphicsQueue(), &presentInfo);
-        if ((presentResult == VK_ERROR_OUT_OF_DATE_KHR) || (presentResult == VK_SUBOPTIMAL_KHR) || m_wasFramebufferResized)
+        VkResult presentResult = VK_SUCCESS;
+        {
+            PROFILE_ZONE("Present");
+            presentResult = vkQueuePresentKHR(VulkanContext::GetGraphicsQueue(), &presentInfo);
+        }
+        if ((presentResult == VK_SUCCESS) || (presentResult == VK_SUBOPTIMAL_KHR))
+        {
+            RecordPresentModeStatistics();
+        }
+
+        if ((presentResult == VK_ERROR_OUT_OF_DATE_KHR) || (presentResult == VK_SUBOPTIMAL_KHR) || m_wasFramebufferResized || m_wasSwapchainSettingChanged)
         {
             m_wasFramebufferResized = false;
+            m_wasSwapchainSettingChanged = false;
             if (!RecreateSwapchain())
             {
                 std::cout << "Failed to recreate swapchain!" << std::endl;
@@ -222,209 +335,1704 @@ void Application::Run()
         }
 
         currentFrame = (currentFrame + 1) % m_maxFramesInFlight;
+        ++m_numRenderedFrames;
+        if (m_numFramesToRender > 0)
+        {
+            --m_numFramesToRender;
+        }
 
+        // The input is consumed, so events from here on (including those that wake up idle mode) go to the next frame
         Input::Prepare();
+        if (!m_isLowLatencyModeEnabled)
+        {
+            SampleInput();
+        }
+    }
 
-        glfwPollEvents();
+    if (m_idleTime > 0.0)
+    {
+        double runTime = glfwGetTime() - m_runStartTime;
+        std::cout << "Rendered " << m_numRenderedFrames << " frames in " << runTime << " s, idle for " << m_idleTime << " s ("
+            << (100.0 * m_idleTime / runTime) << "%)" << std::endl;
     }
 
-    Cleanup();
-}
+    if (m_latencyTracker.GetSampleCount() > 0)
+    {
+        std::cout << "Average latency over the last frames: input-to-submit " << m_latencyTracker.GetInputToSubmitHistory().average
+            << " ms, submit-to-present " << m_latencyTracker.GetSubmitToPresentHistory().average << " ms" << std::endl;
+    }
 
-bool Application::Initialize()
-{
-    if (glfwInit() == GLFW_FALSE)
+    for (const PresentModeStatistics& statistics : m_presentModeStatistics)
     {
-        std::cout << "Failed to initialize GLFW!" << std::endl;
-        return false;
+        double frameTimeVariance = (statistics.numFrames > 1) ? (statistics.frameTimeSquaredDeviations / (statistics.numFrames - 1)) : 0.0;
+        std::cout << GetPresentModeName(statistics.presentMode) << " with " << statistics.imageCount << " images: "
+            << statistics.numFrames << " frames, frame time " << statistics.frameTimeMean << " ms (variance " << frameTimeVariance << " ms^2)";
+        if (statistics.numLatencySamples > 0)
+        {
+            std::cout << ", input-to-submit " << (statistics.totalInputToSubmit / statistics.numLatencySamples)
+                << " ms, submit-to-present " << (statistics.totalSubmitToPresent / statistics.numLatencySamples) << " ms";
+        }
+        std::cout << std::endl;
     }
 
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+    if (!m_launchOptions.recordedCameraPathFilePath.empty())
+    {
+        m_cameraPath.SaveToFile(m_launchOptions.recordedCameraPathFilePath);
+    }
 
-    m_window = glfwCreateWindow(800, 600, "Vulkan Model Viewer", nullptr, nullptr);
+    if (!m_launchOptions.cpuTraceOutputPath.empty())
+    {
+        CpuProfiler::WriteChromeTrace(m_launchOptions.cpuTraceOutputPath);
+    }
 
-    // Setup framebuffer resize callback
-    glfwSetWindowUserPointer(m_window, this);
-    glfwSetFramebufferSizeCallback(m_window, Application::FramebufferResizeCallback);
+    if (!m_launchOptions.statisticsOutputPath.empty())
+    {
+        WriteRendererStatistics();
+    }
 
-    // Register input callback functions
-    glfwSetKeyCallback(m_window, Input::KeyCallback);
-    glfwSetMouseButtonCallback(m_window, Input::MouseButtonCallback);
-    glfwSetCursorEnterCallback(m_window, Input::CursorEnterCallback);
-    glfwSetCursorPosCallback(m_window, Input::CursorCallback);
-    glfwSetScrollCallback(m_window, Input::MouseScrollCallback);
+    Cleanup();
+}
 
-    // Set drop callback function
-    glfwSetDropCallback(m_window, Application::DropCallback);
+/**
+ * @brief Parses command line arguments into launch options.
+ * @param[in] argc Number of arguments
+ * @param[in] argv Arguments
+ * @param[in,out] outLaunchOptions Launch options. Options that are not specified keep their value.
+ * @return Returns true if all the arguments were valid. Returns false otherwise.
+ */
+bool Application::ParseLaunchOptions(int argc, char** argv, LaunchOptions& outLaunchOptions)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        bool hasValue = (i + 1 < argc);
 
-    if (!VulkanContext::Initialize(m_window))
+        if (argument == "--headless")
+        {
+            outLaunchOptions.headless = true;
+        }
+        else if ((argument == "--model") && hasValue)
+        {
+            outLaunchOptions.modelFilePath = argv[++i];
+        }
+        else if ((argument == "--synthetic-scene") && hasValue)
+        {
+            outLaunchOptions.useSyntheticScene = true;
+            if (!SyntheticSceneGenerator::ParseSettings(argv[++i], outLaunchOptions.syntheticScene))
+            {
+                std::cout << "Invalid synthetic scene size: " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if ((argument == "--frames") && hasValue)
+        {
+            if (!ParseUnsigned(argv[++i], outLaunchOptions.frameCount))
+            {
+                std::cout << "Invalid value for " << argument << ": " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if ((argument == "--frames-in-flight") && hasValue)
+        {
+            if (!ParseUnsigned(argv[++i], outLaunchOptions.framesInFlight))
+            {
+                std::cout << "Invalid value for " << argument << ": " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if ((argument == "--recording-threads") && hasValue)
+        {
+            if (!ParseUnsigned(argv[++i], outLaunchOptions.recordingThreads))
+            {
+                std::cout << "Invalid value for " << argument << ": " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if ((argument == "--width") && hasValue)
+        {
+            if (!ParseUnsigned(argv[++i], outLaunchOptions.width))
+            {
+                std::cout << "Invalid value for " << argument << ": " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if ((argument == "--height") && hasValue)
+        {
+            if (!ParseUnsigned(argv[++i], outLaunchOptions.height))
+            {
+                std::cout << "Invalid value for " << argument << ": " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if ((argument == "--output") && hasValue)
+        {
+            outLaunchOptions.outputImagePath = argv[++i];
+        }
+        else if ((argument == "--camera-path") && hasValue)
+        {
+            outLaunchOptions.cameraPathFilePath = argv[++i];
+        }
+        else if ((argument == "--benchmark-output") && hasValue)
+        {
+            outLaunchOptions.benchmarkOutputPath = argv[++i];
+        }
+        else if ((argument == "--record-camera-path") && hasValue)
+        {
+            outLaunchOptions.recordedCameraPathFilePath = argv[++i];
+        }
+        else if ((argument == "--cpu-trace") && hasValue)
+        {
+            outLaunchOptions.cpuTraceOutputPath = argv[++i];
+        }
+        else if ((argument == "--stats-output") && hasValue)
+        {
+            outLaunchOptions.statisticsOutputPath = argv[++i];
+        }
+        else if ((argument == "--stats-interval") && hasValue)
+        {
+            if (!ParseUnsigned(argv[++i], outLaunchOptions.statisticsInterval))
+            {
+                std::cout << "Invalid value for " << argument << ": " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if (argument == "--no-alpha-mask-split")
+        {
+            outLaunchOptions.disableAlphaMaskSplit = true;
+        }
+        else if (argument == "--idle")
+        {
+            outLaunchOptions.idleMode = true;
+        }
+        else if (argument == "--low-latency")
+        {
+            outLaunchOptions.lowLatency = true;
+        }
+        else if ((argument == "--fps-limit") && hasValue)
+        {
+            if (!ParseFloat(argv[++i], outLaunchOptions.frameRateLimit))
+            {
+                std::cout << "Invalid value for " << argument << ": " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if ((argument == "--present-mode") && hasValue)
+        {
+            if (!ParsePresentMode(argv[++i], outLaunchOptions.presentMode))
+            {
+                std::cout << "Unknown present mode: " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if ((argument == "--swapchain-images") && hasValue)
+        {
+            if (!ParseUnsigned(argv[++i], outLaunchOptions.swapchainImageCount))
+            {
+                std::cout << "Invalid value for " << argument << ": " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if (argument == "--dynamic-resolution")
+        {
+            outLaunchOptions.dynamicResolution = true;
+        }
+        else if ((argument == "--target-frame-time") && hasValue)
+        {
+            if (!ParseFloat(argv[++i], outLaunchOptions.targetFrameTime))
+            {
+                std::cout << "Invalid value for " << argument << ": " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if ((argument == "--min-render-scale") && hasValue)
+        {
+            if (!ParseFloat(argv[++i], outLaunchOptions.minRenderScale))
+            {
+                std::cout << "Invalid value for " << argument << ": " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if ((argument == "--max-render-scale") && hasValue)
+        {
+            if (!ParseFloat(argv[++i], outLaunchOptions.maxRenderScale))
+            {
+                std::cout << "Invalid value for " << argument << ": " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else
+        {
+            std::cout << "Unknown or incomplete argument: " << argument << std::endl;
+            return false;
+        }
+    }
+
+    if ((outLaunchOptions.width == 0) || (outLaunchOptions.height == 0))
     {
-        std::cout << "Failed to intiialize Vulkan context!" << std::endl;
-        Cleanup();
+        std::cout << "Offscreen image size must be non-zero!" << std::endl;
         return false;
     }
 
-    if (!InitSwapchain()
-            || !InitSynchronizationTools()
-            || !InitCommandPool()
-            || !InitCommandBuffers()
-            || !InitDepthStencil()
-            || !InitRenderPass()
-            || !InitFramebuffers())
+    if (outLaunchOptions.framesInFlight == 0)
     {
-        Cleanup();
+        std::cout << "Number of frames in flight must be non-zero!" << std::endl;
         return false;
     }
 
-    //1: create descriptor pool for IMGUI
-	// the size of the pool is very oversize, but it's copied from imgui demo itself.
-	VkDescriptorPoolSize pool_sizes[] =
-	{
-		{ VK_DESCRIPTOR_TYPE_SAMPLER, 1000 },
-		{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1000 },
-		{ VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1000 },
-		{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1000 },
-		{ VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 1000 },
-		{ VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, 1000 },
-		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1000 },
-		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1000 },
-		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1000 },
-		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1000 },
-		{ VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1000 }
-	};
+    if (outLaunchOptions.recordingThreads == 0)
+    {
+        std::cout << "Number of recording threads must be non-zero!" << std::endl;
+        return false;
+    }
 
-	VkDescriptorPoolCreateInfo pool_info = {};
-	pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-	pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-	pool_info.maxSets = 1000;
-	pool_info.poolSizeCount = std::size(pool_sizes);
-	pool_info.pPoolSizes = pool_sizes;
+    if (outLaunchOptions.frameRateLimit < 0.0f)
+    {
+        std::cout << "Frame rate limit must not be negative!" << std::endl;
+        return false;
+    }
 
-	if (vkCreateDescriptorPool(VulkanContext::GetLogicalDevice(), &pool_info, nullptr, &m_vkImguiPool) != VK_SUCCESS)
+    if (outLaunchOptions.targetFrameTime <= 0.0f)
     {
-        std::cout << "Failed to create IMGUI descriptor pool" << std::endl;
+        std::cout << "Target frame time must be positive!" << std::endl;
         return false;
     }
 
-	// 2: initialize imgui library
+    if ((outLaunchOptions.minRenderScale <= 0.0f) || (outLaunchOptions.minRenderScale > outLaunchOptions.maxRenderScale)
+        || (outLaunchOptions.maxRenderScale > 1.0f))
+    {
+        std::cout << "Render scales must satisfy 0 < minimum <= maximum <= 1!" << std::endl;
+        return false;
+    }
 
-	//this initializes the core structures of imgui
-	ImGui::CreateContext();
+    return true;
+}
 
-	//this initializes imgui for GLFW
-	ImGui_ImplGlfw_InitForVulkan(m_window, false);
+/**
+ * @brief Prints the command line arguments understood by ParseLaunchOptions.
+ * @param[in] programName Name of the executable
+ */
+void Application::PrintUsage(const std::string& programName)
+{
+    std::cout << "Usage: " << programName << " [options]" << std::endl
+        << "  --model <path>               Model to load on startup" << std::endl
+        << "  --synthetic-scene <m,t,i,x>  Generate m meshes of t triangles, drawn i times, sharing x textures" << std::endl
+        << "  --record-camera-path <path>  Record the camera movement into a camera path file" << std::endl
+        << "  --headless                   Render offscreen without a window" << std::endl
+        << "  --frames <count>             Number of frames to render in headless mode" << std::endl
+        << "  --frames-in-flight <count>   Number of frames the CPU may record ahead of the GPU (default 2)" << std::endl
+        << "  --recording-threads <count>  Number of threads recording the draws into secondary command buffers (default 1)" << std::endl
+        << "  --width <pixels>             Width of the offscreen images" << std::endl
+        << "  --height <pixels>            Height of the offscreen images" << std::endl
+        << "  --output <file.ppm>          Write the last headless frame into a PPM file" << std::endl
+        << "  --camera-path <path>         Play back a camera path over the headless frames" << std::endl
+        << "  --benchmark-output <path>    Write per-frame benchmark results into a .csv or .json file" << std::endl
+        << "  --cpu-trace <file.json>      Write the CPU profiler zones into a Chrome trace file on exit" << std::endl
+        << "  --stats-output <file.json>   Write the renderer statistics into a JSON file on exit" << std::endl
+        << "  --stats-interval <frames>    Also rewrite the renderer statistics file every given number of frames" << std::endl
+        << "  --no-alpha-mask-split        Draw every mesh with the alpha test, without drawing opaque meshes first" << std::endl
+        << "  --idle                       Only render when input, window events or texture loads change the frame" << std::endl
+        << "  --low-latency                Wait for the frame slot before sampling the input, right before recording" << std::endl
+        << "  --fps-limit <fps>            Limit the viewer's frame rate (default 0, unlimited)" << std::endl
+        << "  --present-mode <mode>        fifo, fifo-relaxed, mailbox or immediate (default mailbox, or fifo if unsupported)" << std::endl
+        << "  --swapchain-images <count>   Minimum number of swapchain images (default one more than the surface minimum)" << std::endl
+        << "  --dynamic-resolution         Lower the model's resolution while the camera moves to hold the target frame time" << std::endl
+        << "  --target-frame-time <ms>     GPU frame time dynamic resolution aims for (default 16.7)" << std::endl
+        << "  --min-render-scale <scale>   Lowest resolution scale of dynamic resolution (default 0.5)" << std::endl
+        << "  --max-render-scale <scale>   Highest resolution scale while the camera moves (default 1.0)" << std::endl;
+}
 
-	//this initializes imgui for Vulkan
+/**
+ * @brief Parses a command line value as an unsigned 32-bit integer.
+ * @param[in] text Value text. Must consist of decimal digits only.
+ * @param[out] outValue Parsed value. Left unchanged if the text is not valid.
+ * @return Returns true if the whole text is a number that fits in 32 bits. Returns false otherwise.
+ */
+bool Application::ParseUnsigned(const char* text, uint32_t& outValue)
+{
+    // from_chars rejects signs and whitespace, so negative values cannot wrap around
+    const char* end = text + std::strlen(text);
+    uint32_t value = 0;
+    std::from_chars_result result = std::from_chars(text, end, value);
+    if ((result.ec != std::errc()) || (result.ptr != end))
+    {
+        return false;
+    }
+
+    outValue = value;
+    return true;
+}
+
+/**
+ * @brief Parses a command line value as a finite floating-point number.
+ * @param[in] text Value text
+ * @param[out] outValue Parsed value. Left unchanged if the text is not valid.
+ * @return Returns true if the whole text is a finite number. Returns false otherwise.
+ */
+bool Application::ParseFloat(const char* text, float& outValue)
+{
+    if ((*text == '\0') || std::isspace(static_cast<unsigned char>(*text)))
+    {
+        return false;
+    }
+
+    char* end = nullptr;
+    errno = 0;
+    float value = std::strtof(text, &end);
+    if ((*end != '\0') || (errno == ERANGE) || !std::isfinite(value))
+    {
+        return false;
+    }
+
+    outValue = value;
+    return true;
+}
+
+/**
+ * @brief Parses a present mode name, as accepted on the command line.
+ * @param[in] name Present mode name (fifo, fifo-relaxed, mailbox or immediate)
+ * @param[out] outPresentMode Present mode
+ * @return Returns true if the name is a known present mode. Returns false otherwise.
+ */
+bool Application::ParsePresentMode(const std::string& name, VkPresentModeKHR& outPresentMode)
+{
+    const VkPresentModeKHR PRESENT_MODES[] =
+    {
+        VK_PRESENT_MODE_FIFO_KHR,
+        VK_PRESENT_MODE_FIFO_RELAXED_KHR,
+        VK_PRESENT_MODE_MAILBOX_KHR,
+        VK_PRESENT_MODE_IMMEDIATE_KHR
+    };
+    for (VkPresentModeKHR presentMode : PRESENT_MODES)
+    {
+        if (name == GetPresentModeName(presentMode))
+        {
+            outPresentMode = presentMode;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Gets the name of a present mode, as accepted on the command line.
+ * @param[in] presentMode Present mode
+ * @return Present mode name. Returns "unknown" for modes that cannot be selected.
+ */
+const char* Application::GetPresentModeName(VkPresentModeKHR presentMode)
+{
+    switch (presentMode)
+    {
+    case VK_PRESENT_MODE_FIFO_KHR:
+        return "fifo";
+    case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+        return "fifo-relaxed";
+    case VK_PRESENT_MODE_MAILBOX_KHR:
+        return "mailbox";
+    case VK_PRESENT_MODE_IMMEDIATE_KHR:
+        return "immediate";
+    default:
+        return "unknown";
+    }
+}
+
+/**
+ * @brief Renders the requested number of frames into the offscreen images and reports the frame times.
+ */
+void Application::RunHeadless()
+{
+    const bool isBenchmarking = !m_launchOptions.benchmarkOutputPath.empty();
+    if (!m_launchOptions.cameraPathFilePath.empty())
+    {
+        if (!m_cameraPath.LoadFromFile(m_launchOptions.cameraPathFilePath))
+        {
+            return;
+        }
+    }
+    else if (isBenchmarking)
+    {
+        m_cameraPath.GenerateOrbit(m_launchOptions.frameCount);
+    }
+
+    BenchmarkReport report(m_launchOptions.useSyntheticScene
+        ? SyntheticSceneGenerator::GetDescription(m_launchOptions.syntheticScene) : m_launchOptions.modelFilePath);
+    report.SetFrameCount(m_launchOptions.frameCount);
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point prevTime = startTime;
+
+    uint32_t currentFrame = 0;
+    uint32_t lastImageIndex = 0;
+    uint32_t numRenderedFrames = 0;
+    for (uint32_t frame = 0; frame < m_launchOptions.frameCount; ++frame)
+    {
+        PROFILE_ZONE("Frame");
+
+        VulkanContext::WaitForSubmission(m_frameSubmissions[currentFrame]);
+
+        // Each frame in flight owns its own offscreen image, so there is nothing to acquire
+        uint32_t imageIndex = currentFrame;
+
+        // The frame that last used this slot has finished, so its timestamps can be read without waiting
+        if (frame >= m_maxFramesInFlight)
+        {
+            m_gpuProfiler.CollectResults(currentFrame);
+            GetFrameGpuTimes(currentFrame, report.GetFrame(frame - m_maxFramesInFlight));
+        }
+
+        std::chrono::steady_clock::time_point cpuStartTime = std::chrono::steady_clock::now();
+
+        if (!m_cameraPath.IsEmpty())
+        {
+            float t = (m_launchOptions.frameCount > 1) ? static_cast<float>(frame) / (m_launchOptions.frameCount - 1) : 0.0f;
+            m_cameraPath.Apply(t, m_camera);
+        }
+
+        // Steady-state frames are expected to record without touching the heap
+        uint64_t numAllocationsBefore = (m_launchOptions.allocationCounter != nullptr) ? m_launchOptions.allocationCounter() : 0;
+        if (!RecordCommandBuffer(m_vkCommandBuffers[currentFrame], currentFrame, imageIndex))
+        {
+            break;
+        }
+        uint64_t numAllocationsAfter = (m_launchOptions.allocationCounter != nullptr) ? m_launchOptions.allocationCounter() : 0;
+
+        VkSubmitInfo submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &m_vkCommandBuffers[currentFrame];
+
+        if (!VulkanContext::SubmitToGraphicsQueue(submitInfo, m_frameSubmissions[currentFrame]))
+        {
+            std::cout << "Failed to submit draw command buffer!" << std::endl;
+            break;
+        }
+
+        lastImageIndex = imageIndex;
+        currentFrame = (currentFrame + 1) % m_maxFramesInFlight;
+        ++numRenderedFrames;
+
+        std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
+        BenchmarkReport::FrameSample& sample = report.GetFrame(frame);
+        sample.frameTime = std::chrono::duration<double, std::milli>(currentTime - prevTime).count();
+        sample.cpuTime = std::chrono::duration<double, std::milli>(currentTime - cpuStartTime).count();
+        sample.drawCount = m_renderer.GetFrameStatistics().drawCount;
+        sample.triangleCount = m_renderer.GetFrameStatistics().triangleCount;
+        sample.droppedDrawCount = m_renderer.GetFrameStatistics().droppedDrawCount;
+        sample.allocationCount = numAllocationsAfter - numAllocationsBefore;
+        prevTime = currentTime;
+    }
+
+    vkDeviceWaitIdle(VulkanContext::GetLogicalDevice());
+    double totalTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    if (numRenderedFrames == 0)
+    {
+        std::cout << "No frames were rendered!" << std::endl;
+        return;
+    }
+
+    // Collect the GPU times of the frames that were still in flight when the loop ended
+    report.SetFrameCount(numRenderedFrames);
+    for (uint32_t frame = (numRenderedFrames > m_maxFramesInFlight) ? (numRenderedFrames - m_maxFramesInFlight) : 0; frame < numRenderedFrames; ++frame)
+    {
+        m_gpuProfiler.CollectResults(frame % m_maxFramesInFlight);
+        GetFrameGpuTimes(frame % m_maxFramesInFlight, report.GetFrame(frame));
+    }
+
+    std::cout << "Rendered " << numRenderedFrames << " frames at " << m_vkSwapchainImageExtent.width << "x" << m_vkSwapchainImageExtent.height
+        << " in " << totalTime << " ms (" << (numRenderedFrames * 1000.0 / totalTime) << " fps)" << std::endl;
+    report.PrintSummary();
+
+    if (isBenchmarking)
+    {
+        report.WriteToFile(m_launchOptions.benchmarkOutputPath);
+    }
+
+    if (!m_launchOptions.outputImagePath.empty())
+    {
+        // Keep rendering the last camera pose until every texture is decoded and at its desired resolution,
+        // so that the saved image does not depend on the decoding timing. Textures picked up in a frame only get
+        // their desired resolution in the next one, so streaming must be settled after two frames in a row.
+        std::chrono::steady_clock::time_point settleStartTime = std::chrono::steady_clock::now();
+        uint32_t numSettledFrames = m_renderer.IsTextureStreamingSettled() ? 1 : 0;
+        while (numSettledFrames < 2)
+        {
+            if (std::chrono::duration<double>(std::chrono::steady_clock::now() - settleStartTime).count() > HEADLESS_STREAMING_TIMEOUT)
+            {
+                std::cout << "Texture streaming did not settle within " << HEADLESS_STREAMING_TIMEOUT << " s, saving the image anyway" << std::endl;
+                break;
+            }
+
+            VulkanContext::WaitForSubmission(m_frameSubmissions[currentFrame]);
+            if (!RecordCommandBuffer(m_vkCommandBuffers[currentFrame], currentFrame, currentFrame))
+            {
+                break;
+            }
+
+            VkSubmitInfo submitInfo = {};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &m_vkCommandBuffers[currentFrame];
+            if (!VulkanContext::SubmitToGraphicsQueue(submitInfo, m_frameSubmissions[currentFrame]))
+            {
+                std::cout << "Failed to submit draw command buffer!" << std::endl;
+                break;
+            }
+
+            lastImageIndex = currentFrame;
+            currentFrame = (currentFrame + 1) % m_maxFramesInFlight;
+            numSettledFrames = m_renderer.IsTextureStreamingSettled() ? (numSettledFrames + 1) : 0;
+        }
+        vkDeviceWaitIdle(VulkanContext::GetLogicalDevice());
+
+        SaveOffscreenImage(lastImageIndex, m_launchOptions.outputImagePath);
+    }
+}
+
+/**
+ * @brief Loads a model, replacing the current one, and scales it to fit the view.
+ * @param[in] filePath Model file path
+ */
+void Application::LoadModel(const std::string& filePath)
+{
+    PROFILE_FUNCTION();
+
+    if (m_currentModel == nullptr)
+    {
+        m_currentModel = new Model();
+    }
+
+    Model* model = m_currentModel;
+    model->Load(filePath, m_importOptions);
+    m_instanceTransforms.clear();
+    m_renderer.ResetDeduplicatedTextureCount();
+    
+    // --- Scale model to have its largest dimension be of scale 1.0
+    if (model->GetTotalVertexCount() > 0)
+    {
+        // Calculate model bounding box
+        glm::vec3 min = model->GetMeshes()[0]->vertices[0].position;
+        glm::vec3 max = min;
+
+        for (size_t i = 0; i < model->GetMeshes().size(); ++i)
+        {
+            Mesh* mesh = model->GetMeshes()[i];
+            for (size_t j = 0; j < mesh->vertices.size(); ++j)
+            {
+                min.x = std::min(min.x, mesh->vertices[j].position.x);
+                min.y = std::min(min.y, mesh->vertices[j].position.y);
+                min.z = std::min(min.z, mesh->vertices[j].position.z);
+                max.x = std::max(max.x, mesh->vertices[j].position.x);
+                max.y = std::max(max.y, mesh->vertices[j].position.y);
+                max.z = std::max(max.z, mesh->vertices[j].position.z);
+            }
+        }
+
+        glm::vec3 dimensions = max - min;
+        float maxDimension = std::max({dimensions.x, dimensions.y, dimensions.z});
+        float modelScale = 2.0f / maxDimension;
+
+        m_currentModelTransform = glm::scale(glm::mat4(1.0f), glm::vec3(modelScale));
+    }
+}
+
+/**
+ * @brief Generates a synthetic scene, replacing the current model.
+ * @param[in] settings Scene size
+ */
+void Application::LoadSyntheticScene(const SyntheticSceneGenerator::Settings& settings)
+{
+    PROFILE_FUNCTION();
+
+    // A fresh model, since generated meshes are added to whatever the model already contains
+    delete m_currentModel;
+    m_currentModel = new Model();
+
+    // The generator already fits the scene within [-1, 1]
+    SyntheticSceneGenerator::Generate(settings, *m_currentModel, m_instanceTransforms);
+    m_currentModelTransform = glm::mat4(1.0f);
+    m_renderer.ResetDeduplicatedTextureCount();
+}
+
+bool Application::Initialize()
+{
+    if (m_launchOptions.headless)
+    {
+        // No window, surface, swapchain or UI. Frames are rendered into offscreen images instead.
+        if (!VulkanContext::Initialize(nullptr))
+        {
+            std::cout << "Failed to intiialize Vulkan context!" << std::endl;
+            return false;
+        }
+
+        if (!InitOffscreenTargets()
+                || !InitSynchronizationTools()
+                || !InitCommandPool()
+                || !InitCommandBuffers()
+                || !m_gpuProfiler.Initialize(static_cast<uint32_t>(m_vkCommandBuffers.size()))
+                || !InitDepthStencil()
+                || !InitRenderPass()
+                || !InitFramebuffers())
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    if (glfwInit() == GLFW_FALSE)
+    {
+        std::cout << "Failed to initialize GLFW!" << std::endl;
+        return false;
+    }
+
+    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+
+    m_window = glfwCreateWindow(800, 600, "Vulkan Model Viewer", nullptr, nullptr);
+
+    // Setup framebuffer resize callback
+    glfwSetWindowUserPointer(m_window, this);
+    glfwSetFramebufferSizeCallback(m_window, Application::FramebufferResizeCallback);
+    glfwSetWindowRefreshCallback(m_window, Application::WindowRefreshCallback);
+
+    // Register input callback functions
+    glfwSetKeyCallback(m_window, Input::KeyCallback);
+    glfwSetMouseButtonCallback(m_window, Input::MouseButtonCallback);
+    glfwSetCursorEnterCallback(m_window, Input::CursorEnterCallback);
+    glfwSetCursorPosCallback(m_window, Input::CursorCallback);
+    glfwSetScrollCallback(m_window, Input::MouseScrollCallback);
+
+    // Set drop callback function
+    glfwSetDropCallback(m_window, Application::DropCallback);
+
+    if (!VulkanContext::Initialize(m_window))
+    {
+        std::cout << "Failed to intiialize Vulkan context!" << std::endl;
+        Cleanup();
+        return false;
+    }
+
+    if (!InitSwapchain()
+            || !InitSynchronizationTools()
+            || !InitCommandPool()
+            || !InitCommandBuffers()
+            || !m_gpuProfiler.Initialize(static_cast<uint32_t>(m_vkCommandBuffers.size()))
+            || !InitDepthStencil()
+            || !InitRenderPass()
+            || !InitFramebuffers())
+    {
+        Cleanup();
+        return false;
+    }
+
+    //1: create descriptor pool for IMGUI
+	// the size of the pool is very oversize, but it's copied from imgui demo itself.
+	VkDescriptorPoolSize pool_sizes[] =
+	{
+		{ VK_DESCRIPTOR_TYPE_SAMPLER, 1000 },
+		{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1000 },
+		{ VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1000 },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1000 },
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 1000 },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, 1000 },
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1000 },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1000 },
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1000 },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1000 },
+		{ VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1000 }
+	};
+
+	VkDescriptorPoolCreateInfo pool_info = {};
+	pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+	pool_info.maxSets = 1000;
+	pool_info.poolSizeCount = std::size(pool_sizes);
+	pool_info.pPoolSizes = pool_sizes;
+
+	if (vkCreateDescriptorPool(VulkanContext::GetLogicalDevice(), &pool_info, nullptr, &m_vkImguiPool) != VK_SUCCESS)
+    {
+        std::cout << "Failed to create IMGUI descriptor pool" << std::endl;
+        return false;
+    }
+
+	// 2: initialize imgui library
+
+	//this initializes the core structures of imgui
+	ImGui::CreateContext();
+
+	//this initializes imgui for GLFW
+	ImGui_ImplGlfw_InitForVulkan(m_window, false);
+
+	//this initializes imgui for Vulkan
 	ImGui_ImplVulkan_InitInfo init_info = {};
 	init_info.Instance = VulkanContext::GetVulkanInstance();
 	init_info.PhysicalDevice = VulkanContext::GetPhysicalDevice();
 	init_info.Device = VulkanContext::GetLogicalDevice();
 	init_info.Queue = VulkanContext::GetGraphicsQueue();
 	init_info.DescriptorPool = m_vkImguiPool;
-	init_info.MinImageCount = m_maxFramesInFlight;
-	init_info.ImageCount = m_maxFramesInFlight;
+	init_info.MinImageCount = GetSwapchainImageCount();
+    // The backend rotates its vertex and index buffers once per frame modulo ImageCount, so it needs
+    // at least one set per frame in flight, even when there are more frames in flight than swapchain images
+	init_info.ImageCount = std::max(m_maxFramesInFlight, GetSwapchainImageCount());
 	init_info.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
+	init_info.PipelineCache = VulkanContext::GetPipelineCache();
+
+	ImGui_ImplVulkan_Init(&init_info, m_vkRenderPass);
+
+	//execute a gpu command to upload imgui font textures
+    VkCommandBuffer cmd = VulkanContext::BeginSingleUseCommandBuffer();
+	ImGui_ImplVulkan_CreateFontsTexture(cmd);
+    VulkanContext::EndSingleUseCommandBuffer(cmd);
+
+	//clear font textures from cpu data
+	ImGui_ImplVulkan_DestroyFontUploadObjects();
+
+    return true;
+}
+
+/**
+ * @brief Updates the application's state.
+ * @param[in] deltaTime Time elapsed since the previous frame.
+ */
+void Application::Update(float deltaTime)
+{
+    float sensitivity = 1.0f;
+    if (Input::IsDown(Input::RIGHT_MOUSE))
+    {
+        m_camera.SetYaw(m_camera.GetYaw() + Input::GetMouseDeltaX() * sensitivity);
+
+        float pitch = m_camera.GetPitch() + Input::GetMouseDeltaY() * sensitivity;
+        pitch = std::clamp(pitch, -89.0f, 89.0f);
+        m_camera.SetPitch(pitch);
+    }
+
+    float moveSpeed = 5.0f;
+    glm::vec3 cameraForward = m_camera.GetCamera().GetForwardVector();
+    glm::vec3 cameraRight = m_camera.GetCamera().GetRightVector();
+
+    glm::vec3 movementVector(0.0f);
+    if (Input::IsDown(Input::Key::W))
+    {
+        movementVector += cameraForward;
+    }
+    else if (Input::IsDown(Input::S))
+    {
+        movementVector -= cameraForward;
+    }
+
+    if (Input::IsDown(Input::Key::A))
+    {
+        movementVector -= cameraRight;
+    }
+    else if (Input::IsDown(Input::Key::D))
+    {
+        movementVector += cameraRight;
+    }
+
+    if (glm::dot(movementVector, movementVector) > 0.0f)
+    {
+        movementVector = glm::normalize(movementVector);
+        m_camera.SetLookTarget(m_camera.GetLookTarget() + movementVector * moveSpeed * deltaTime);
+    }
+}
+
+/**
+ * @brief Renders the model.
+ * @param[in] commandBuffer Command buffer, inside the render pass
+ * @param[in] frameIndex Index of the frame in flight
+ * @param[in] extent Size of the area to render into
+ */
+void Application::Render(VkCommandBuffer commandBuffer, uint32_t frameIndex, const VkExtent2D& extent)
+{
+    m_renderer.Render(commandBuffer, frameIndex, extent, m_camera.GetViewMatrix(), m_camera.GetProjectionMatrix());
+}
+
+/**
+ * @brief Renders the ImGui overlay, through a secondary command buffer when the draws are recorded in parallel.
+ * Does nothing in headless mode.
+ * @param[in] commandBuffer Command buffer, inside the render pass
+ * @param[in] frameIndex Index of the frame in flight
+ */
+void Application::RenderOverlay(VkCommandBuffer commandBuffer, uint32_t frameIndex)
+{
+    if (m_launchOptions.headless)
+    {
+        return;
+    }
+
+    if (!m_renderer.IsRecordingInParallel())
+    {
+        RenderImGui(commandBuffer);
+        return;
+    }
+
+    // The render pass only accepts secondary command buffers when the draws are recorded in parallel
+    VkCommandBufferInheritanceInfo inheritanceInfo = {};
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritanceInfo.renderPass = m_vkRenderPass;
+    inheritanceInfo.subpass = 0;
+    inheritanceInfo.framebuffer = VK_NULL_HANDLE;
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+    VkCommandBuffer imguiCommandBuffer = m_vkImGuiCommandBuffers[frameIndex];
+    if (vkBeginCommandBuffer(imguiCommandBuffer, &beginInfo) != VK_SUCCESS)
+    {
+        std::cout << "Failed to begin recording ImGui command buffer!" << std::endl;
+        return;
+    }
+    RenderImGui(imguiCommandBuffer);
+    if (vkEndCommandBuffer(imguiCommandBuffer) != VK_SUCCESS)
+    {
+        std::cout << "Failed to end recording of ImGui command buffer!" << std::endl;
+        return;
+    }
+    vkCmdExecuteCommands(commandBuffer, 1, &imguiCommandBuffer);
+}
+
+/**
+ * @brief Builds the ImGui overlay and records its draws.
+ * @param[in] commandBuffer Command buffer, inside the render pass
+ */
+void Application::RenderImGui(VkCommandBuffer commandBuffer)
+{
+    uint32_t imguiScope = m_gpuProfiler.BeginScope(commandBuffer, "ImGui");
+
+    ImGui_ImplVulkan_NewFrame();
+    ImGui_ImplGlfw_NewFrame();
+    ImGui::NewFrame();
+
+    if (m_currentModel != nullptr)
+    {
+        ImGui::SetNextWindowSize({250, 140});
+        ImGui::Begin("Model info");
+
+        ImGui::Text("Vertices: %u", m_currentModel->GetTotalVertexCount());
+        ImGui::Text("Triangles: %u", m_currentModel->GetTotalTriangleCount());
+        ImGui::Text("Deduplicated textures: %u", m_renderer.GetDeduplicatedTextureCount());
+        ImGui::Text("Texture atlases: %u (%u textures)", m_currentModel->GetTextureAtlasCount(), m_currentModel->GetAtlasPackedTextureCount());
+
+        ImGui::End();
+    }
+
+    ImGui::Begin("Import options");
+    ImGui::Checkbox("Pack small textures into atlases", &m_importOptions.packTextureAtlases);
+    ImGui::End();
+
+    DrawGpuProfilerWindow();
+    DrawCpuProfilerWindow();
+    DrawRendererStatisticsWindow();
+    DrawIdleModeWindow();
+    DrawLatencyWindow();
+    DrawSwapchainWindow();
+    DrawDynamicResolutionWindow();
+
+    ImGui::Render();
+    ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), commandBuffer);
+
+    ImGui::EndFrame();
+
+    m_gpuProfiler.EndScope(commandBuffer, imguiScope);
+}
+
+/**
+ * @brief Fills the renderer's batch with the current model and updates texture streaming.
+ * @param[in] frameIndex Index of the frame in flight
+ */
+void Application::PrepareRenderBatch(uint32_t frameIndex)
+{
+    PROFILE_FUNCTION();
+
+    m_renderer.Begin(frameIndex);
+
+    if (m_instanceTransforms.empty())
+    {
+        m_renderer.DrawModel(m_currentModel, m_currentModelTransform);
+    }
+    for (size_t i = 0; i < m_instanceTransforms.size(); ++i)
+    {
+        m_renderer.DrawModel(m_currentModel, m_currentModelTransform * m_instanceTransforms[i]);
+    }
+
+    m_renderer.End();
+
+    m_renderer.UpdateTextureStreaming(m_camera.GetCamera().GetPosition(), m_camera.GetCamera().GetFieldOfView(), GetSwapchainImageExtent().height);
+}
+
+/**
+ * @brief Draws the overlay window with a flame chart of the CPU zones of the last frame.
+ */
+void Application::DrawCpuProfilerWindow()
+{
+    const float ROW_HEIGHT = 18.0f;
+
+    ImGui::Begin("CPU profiler");
+
+    bool isRecording = CpuProfiler::IsEnabled();
+    if (ImGui::Checkbox("Record", &isRecording))
+    {
+        CpuProfiler::SetEnabled(isRecording);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Save Chrome trace"))
+    {
+        CpuProfiler::WriteChromeTrace(m_launchOptions.cpuTraceOutputPath.empty() ? "cpu_trace.json" : m_launchOptions.cpuTraceOutputPath);
+    }
+
+    // The frame being recorded is still open, so the chart shows the previous one
+    CpuProfiler::Zone frameZone;
+    if (!CpuProfiler::FindLatestZone("Frame", frameZone))
+    {
+        ImGui::Text("No frame recorded yet.");
+        ImGui::End();
+        return;
+    }
+    uint64_t frameDuration = std::max<uint64_t>(frameZone.endTime - frameZone.startTime, 1);
+    ImGui::Text("Frame: %.3f ms", frameDuration / 1000000.0);
+
+    std::vector<CpuProfiler::ThreadZones> threadZones;
+    CpuProfiler::GetZones(frameZone.startTime, frameZone.endTime, threadZones);
+
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    float chartWidth = std::max(ImGui::GetContentRegionAvail().x, 100.0f);
+    double pixelsPerNanosecond = chartWidth / static_cast<double>(frameDuration);
+    for (const CpuProfiler::ThreadZones& thread : threadZones)
+    {
+        if (thread.zones.empty())
+        {
+            continue;
+        }
+
+        uint32_t maxDepth = 0;
+        for (const CpuProfiler::Zone& zone : thread.zones)
+        {
+            maxDepth = std::max(maxDepth, zone.depth);
+        }
+
+        ImGui::TextUnformatted(thread.threadName.c_str());
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        ImGui::Dummy(ImVec2(chartWidth, (maxDepth + 1) * ROW_HEIGHT));
+
+        for (const CpuProfiler::Zone& zone : thread.zones)
+        {
+            // Zones that straddle the frame boundaries are clipped to the frame
+            uint64_t startTime = std::max(zone.startTime, frameZone.startTime) - frameZone.startTime;
+            uint64_t endTime = std::min(zone.endTime, frameZone.endTime) - frameZone.startTime;
+            ImVec2 zoneMin(origin.x + static_cast<float>(startTime * pixelsPerNanosecond), origin.y + zone.depth * ROW_HEIGHT);
+            ImVec2 zoneMax(std::max(origin.x + static_cast<float>(endTime * pixelsPerNanosecond), zoneMin.x + 1.0f), zoneMin.y + ROW_HEIGHT - 1.0f);
+
+            float hue = (std::hash<std::string>()(zone.name) % 360) / 360.0f;
+            drawList->AddRectFilled(zoneMin, zoneMax, ImColor::HSV(hue, 0.5f, 0.7f));
+            drawList->PushClipRect(zoneMin, zoneMax, true);
+            drawList->AddText(ImVec2(zoneMin.x + 2.0f, zoneMin.y + 2.0f), IM_COL32_WHITE, zone.name);
+            drawList->PopClipRect();
+
+            if (ImGui::IsMouseHoveringRect(zoneMin, zoneMax))
+            {
+                ImGui::SetTooltip("%s: %.3f ms", zone.name, (zone.endTime - zone.startTime) / 1000000.0);
+            }
+        }
+    }
+
+    ImGui::End();
+}
+
+/**
+ * @brief Draws the overlay window with the GPU time of each profiled pass.
+ */
+void Application::DrawGpuProfilerWindow()
+{
+    ImGui::Begin("GPU profiler");
+
+    if (!m_gpuProfiler.IsSupported())
+    {
+        ImGui::Text("Timestamp queries are not supported.");
+        ImGui::End();
+        return;
+    }
+
+    if (ImGui::BeginTable("GPU scopes", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+    {
+        ImGui::TableSetupColumn("Pass");
+        ImGui::TableSetupColumn("Last (ms)");
+        ImGui::TableSetupColumn("Average (ms)");
+        ImGui::TableHeadersRow();
+
+        const std::vector<GpuProfiler::ScopeHistory>& histories = m_gpuProfiler.GetScopeHistories();
+        for (const GpuProfiler::ScopeTiming& timing : m_gpuProfiler.GetLatestTimings())
+        {
+            float average = 0.0f;
+            for (const GpuProfiler::ScopeHistory& history : histories)
+            {
+                if (history.name == timing.name)
+                {
+                    average = history.average;
+                }
+            }
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("%*s%s", static_cast<int>(timing.depth * 2), "", timing.name.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", timing.time);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", average);
+        }
+        ImGui::EndTable();
+    }
+
+    // Rolling graph of each pass, sharing the scale of the slowest one
+    float maxTime = 0.0f;
+    for (const GpuProfiler::ScopeHistory& history : m_gpuProfiler.GetScopeHistories())
+    {
+        maxTime = std::max(maxTime, *std::max_element(history.times.begin(), history.times.end()));
+    }
+    for (const GpuProfiler::ScopeHistory& history : m_gpuProfiler.GetScopeHistories())
+    {
+        ImGui::PlotLines(history.name.c_str(), history.times.data(), static_cast<int>(history.times.size()),
+            static_cast<int>(history.offset), nullptr, 0.0f, maxTime, ImVec2(0.0f, 40.0f));
+    }
+
+    ImGui::End();
+}
+
+/**
+ * @brief Draws the overlay window with the renderer's frame and memory statistics.
+ */
+void Application::DrawRendererStatisticsWindow()
+{
+    const Renderer::FrameStatistics& frameStatistics = m_renderer.GetFrameStatistics();
+    const Renderer::MemoryStatistics& memoryStatistics = m_renderer.GetMemoryStatistics();
+    const double MEGABYTE = 1024.0 * 1024.0;
+
+    ImGui::Begin("Renderer statistics");
+
+    ImGui::Text("Draw calls: %u", frameStatistics.drawCount);
+    ImGui::Text("Pipeline binds: %u", frameStatistics.pipelineBindCount);
+    ImGui::Text("Descriptor set binds: %u", frameStatistics.descriptorSetBindCount);
+    ImGui::Text("Triangles submitted: %u", frameStatistics.triangleCount);
+    ImGui::Text("Triangles culled: %u (%u meshes)", frameStatistics.culledTriangleCount, frameStatistics.culledMeshCount);
+    ImGui::Text("Draws dropped: %u", frameStatistics.droppedDrawCount);
+    ImGui::Text("Alpha-masked: %u triangles (%u draws)", frameStatistics.maskedTriangleCount, frameStatistics.maskedDrawCount);
+    ImGui::Text("Uploaded: %.2f MB", frameStatistics.uploadedBytes / MEGABYTE);
+    ImGui::Text("Pipelines: %u (created in %.2f ms)", m_renderer.GetPipelineCount(), m_renderer.GetPipelineCreationTime());
+
+    ImGui::Separator();
+    ImGui::Text("Geometry buffers: %.2f MB", memoryStatistics.geometryBufferBytes / MEGABYTE);
+    ImGui::Text("Staging buffers: %.2f MB", memoryStatistics.stagingBufferBytes / MEGABYTE);
+    ImGui::Text("Uniform buffers: %.2f MB", memoryStatistics.uniformBufferBytes / MEGABYTE);
+    ImGui::Text("Textures: %.2f MB (%u images)", memoryStatistics.textureBytes / MEGABYTE, memoryStatistics.textureCount);
+
+    ImGui::Separator();
+    bool isAlphaMaskSplitEnabled = m_renderer.IsAlphaMaskSplitEnabled();
+    if (ImGui::Checkbox("Split opaque and masked pipelines", &isAlphaMaskSplitEnabled))
+    {
+        m_renderer.SetAlphaMaskSplitEnabled(isAlphaMaskSplitEnabled);
+    }
+
+    if (ImGui::Button("Dump statistics"))
+    {
+        WriteRendererStatistics();
+    }
+
+    ImGui::End();
+}
+
+/**
+ * @brief Draws the overlay window with the idle mode toggle and the time spent idle.
+ */
+void Application::DrawIdleModeWindow()
+{
+    ImGui::Begin("Idle mode");
+
+    ImGui::Checkbox("Render only on changes", &m_isIdleModeEnabled);
+
+    double runTime = glfwGetTime() - m_runStartTime;
+    ImGui::Text("Idle before this frame: %.2f s", m_lastIdleDuration);
+    ImGui::Text("Idle time: %.1f s (%.1f%% of %.0f s)", m_idleTime, (runTime > 0.0) ? (100.0 * m_idleTime / runTime) : 0.0, runTime);
+    ImGui::Text("Rendered frames: %llu (%.1f per second)", static_cast<unsigned long long>(m_numRenderedFrames),
+        (runTime > 0.0) ? (m_numRenderedFrames / runTime) : 0.0);
+    ImGui::Text("Wake-ups without a frame: %llu", static_cast<unsigned long long>(m_numIdleWakeups));
+
+    ImGui::End();
+}
+
+/**
+ * @brief Draws the overlay window with the low-latency mode toggle, the frame rate limit and the frame latencies.
+ */
+void Application::DrawLatencyWindow()
+{
+    ImGui::Begin("Latency");
+
+    ImGui::Checkbox("Sample input after waiting for the frame", &m_isLowLatencyModeEnabled);
+    ImGui::SliderFloat("Frame rate limit", &m_frameRateLimit, 0.0f, 240.0f, (m_frameRateLimit > 0.0f) ? "%.0f fps" : "Unlimited");
+
+    const LatencyTracker::LatencyHistory& inputToSubmit = m_latencyTracker.GetInputToSubmitHistory();
+    const LatencyTracker::LatencyHistory& submitToPresent = m_latencyTracker.GetSubmitToPresentHistory();
+    ImGui::Text("Input to submit: %.2f ms (average %.2f ms)", inputToSubmit.latest, inputToSubmit.average);
+    ImGui::Text("Submit to present: %.2f ms (average %.2f ms)", submitToPresent.latest, submitToPresent.average);
+
+    // Both graphs share the scale of the larger latency
+    float maxTime = std::max(*std::max_element(inputToSubmit.times.begin(), inputToSubmit.times.end()),
+        *std::max_element(submitToPresent.times.begin(), submitToPresent.times.end()));
+    ImGui::PlotLines("Input to submit", inputToSubmit.times.data(), static_cast<int>(inputToSubmit.times.size()),
+        static_cast<int>(inputToSubmit.offset), nullptr, 0.0f, maxTime, ImVec2(0.0f, 40.0f));
+    ImGui::PlotLines("Submit to present", submitToPresent.times.data(), static_cast<int>(submitToPresent.times.size()),
+        static_cast<int>(submitToPresent.offset), nullptr, 0.0f, maxTime, ImVec2(0.0f, 40.0f));
+
+    ImGui::End();
+}
+
+/**
+ * @brief Draws the overlay window with the present mode and image count controls and the frame pacing measured with each.
+ */
+void Application::DrawSwapchainWindow()
+{
+    ImGui::Begin("Swapchain");
+
+    ImGui::Text("Current: %s, %u images", GetPresentModeName(m_vkSwapchainPresentMode), GetSwapchainImageCount());
+
+    // The swapchain is recreated after the current frame is presented
+    if (ImGui::BeginCombo("Present mode", GetPresentModeName(m_requestedPresentMode)))
+    {
+        for (VkPresentModeKHR presentMode : m_availablePresentModes)
+        {
+            // The shared presentable image modes from extensions cannot be selected
+            if (presentMode > VK_PRESENT_MODE_FIFO_RELAXED_KHR)
+            {
+                continue;
+            }
+
+            if (ImGui::Selectable(GetPresentModeName(presentMode), presentMode == m_requestedPresentMode) && (presentMode != m_requestedPresentMode))
+            {
+                m_requestedPresentMode = presentMode;
+                m_wasSwapchainSettingChanged = true;
+            }
+        }
+        ImGui::EndCombo();
+    }
+
+    // Surfaces without a maximum image count still get a bounded slider
+    int maxImageCount = static_cast<int>((m_maxSwapchainImageCount > 0) ? m_maxSwapchainImageCount : m_minSwapchainImageCount + 4);
+    int imageCount = static_cast<int>((m_requestedSwapchainImageCount > 0) ? m_requestedSwapchainImageCount : GetSwapchainImageCount());
+    if (ImGui::SliderInt("Image count", &imageCount, static_cast<int>(m_minSwapchainImageCount), maxImageCount)
+        && (static_cast<uint32_t>(imageCount) != m_requestedSwapchainImageCount))
+    {
+        m_requestedSwapchainImageCount = static_cast<uint32_t>(imageCount);
+        m_wasSwapchainSettingChanged = true;
+    }
+
+    if (ImGui::BeginTable("Present mode statistics", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+    {
+        ImGui::TableSetupColumn("Mode");
+        ImGui::TableSetupColumn("Images");
+        ImGui::TableSetupColumn("Frames");
+        ImGui::TableSetupColumn("Frame time (ms)");
+        ImGui::TableSetupColumn("Input to submit (ms)");
+        ImGui::TableSetupColumn("Submit to present (ms)");
+        ImGui::TableHeadersRow();
+
+        for (const PresentModeStatistics& statistics : m_presentModeStatistics)
+        {
+            double frameTimeVariance = (statistics.numFrames > 1) ? (statistics.frameTimeSquaredDeviations / (statistics.numFrames - 1)) : 0.0;
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", GetPresentModeName(statistics.presentMode));
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", statistics.imageCount);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(statistics.numFrames));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f (var %.3f)", statistics.frameTimeMean, frameTimeVariance);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", (statistics.numLatencySamples > 0) ? (statistics.totalInputToSubmit / statistics.numLatencySamples) : 0.0);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", (statistics.numLatencySamples > 0) ? (statistics.totalSubmitToPresent / statistics.numLatencySamples) : 0.0);
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::Button("Reset statistics"))
+    {
+        m_presentModeStatistics.clear();
+        m_lastPresentTime = 0.0;
+    }
+
+    ImGui::End();
+}
+
+/**
+ * @brief Draws the overlay window with the dynamic resolution settings and the current resolution.
+ */
+void Application::DrawDynamicResolutionWindow()
+{
+    ImGui::Begin("Dynamic resolution");
+
+    if (!m_isDynamicResolutionSupported)
+    {
+        ImGui::Text("The swapchain images cannot be upscaled into.");
+        ImGui::End();
+        return;
+    }
+
+    ImGui::Checkbox("Lower the resolution while moving", &m_isDynamicResolutionEnabled);
+    ImGui::SliderFloat("Target GPU frame time", &m_targetFrameTime, 2.0f, 50.0f, "%.1f ms");
+    ImGui::SliderFloat("Minimum scale", &m_minRenderScale, 0.1f, 1.0f, "%.2f");
+    ImGui::SliderFloat("Maximum scale", &m_maxRenderScale, 0.1f, 1.0f, "%.2f");
+    m_maxRenderScale = std::max(m_maxRenderScale, m_minRenderScale);
+
+    VkExtent2D extent = GetSwapchainImageExtent();
+    ImGui::Text("Scale while moving: %.2f (%ux%u)", m_renderScale,
+        static_cast<uint32_t>(extent.width * m_renderScale), static_cast<uint32_t>(extent.height * m_renderScale));
+    ImGui::Text("GPU frame time: %.2f ms", m_lastGpuFrameTime);
+    if (!m_gpuProfiler.IsSupported())
+    {
+        ImGui::Text("Timestamp queries are not supported, so the maximum scale is used.");
+    }
+
+    ImGui::End();
+}
+
+/**
+ * @brief Adds the time since the previous present and the newly completed latency samples to the statistics
+ * of the current swapchain configuration.
+ */
+void Application::RecordPresentModeStatistics()
+{
+    PresentModeStatistics* statistics = nullptr;
+    for (PresentModeStatistics& modeStatistics : m_presentModeStatistics)
+    {
+        if ((modeStatistics.presentMode == m_vkSwapchainPresentMode) && (modeStatistics.imageCount == GetSwapchainImageCount()))
+        {
+            statistics = &modeStatistics;
+            break;
+        }
+    }
+    if (statistics == nullptr)
+    {
+        m_presentModeStatistics.push_back({ m_vkSwapchainPresentMode, GetSwapchainImageCount(), 0, 0.0, 0.0, 0, 0.0, 0.0 });
+        statistics = &m_presentModeStatistics.back();
+    }
+
+    double currentTime = glfwGetTime();
+    if (m_lastPresentTime > 0.0)
+    {
+        // Welford's algorithm, so the variance is accurate without keeping every frame time
+        double frameTime = (currentTime - m_lastPresentTime) * 1000.0;
+        ++statistics->numFrames;
+        double deviation = frameTime - statistics->frameTimeMean;
+        statistics->frameTimeMean += deviation / statistics->numFrames;
+        statistics->frameTimeSquaredDeviations += deviation * (frameTime - statistics->frameTimeMean);
+    }
+    m_lastPresentTime = currentTime;
+
+    // Samples usually complete a few frames after they were submitted, so the first ones after a switch
+    // may still belong to the previous configuration
+    if (m_latencyTracker.GetSampleCount() != m_numRecordedLatencySamples)
+    {
+        m_numRecordedLatencySamples = m_latencyTracker.GetSampleCount();
+        ++statistics->numLatencySamples;
+        statistics->totalInputToSubmit += m_latencyTracker.GetInputToSubmitHistory().latest;
+        statistics->totalSubmitToPresent += m_latencyTracker.GetSubmitToPresentHistory().latest;
+    }
+}
+
+/**
+ * @brief Polls the window events, which updates the input used by the next frame.
+ */
+void Application::SampleInput()
+{
+    PROFILE_ZONE("PollEvents");
+    glfwPollEvents();
+    m_inputSampleTime = glfwGetTime();
+    CheckFrameInvalidation();
+}
+
+/**
+ * @brief Blocks until the frame rate limit lets the next frame start. Returns immediately if there is no limit.
+ */
+void Application::WaitForFrameLimit()
+{
+    if (m_frameRateLimit <= 0.0f)
+    {
+        return;
+    }
+
+    PROFILE_ZONE("FrameLimiter");
+
+    double sleepTime = m_nextFrameTime - glfwGetTime() - FRAME_LIMITER_SPIN_TIME;
+    if (sleepTime > 0.0)
+    {
+        std::this_thread::sleep_for(std::chrono::duration<double>(sleepTime));
+    }
+    while (glfwGetTime() < m_nextFrameTime)
+    {
+        std::this_thread::yield();
+    }
+
+    // Deadlines advance by whole frames, so the time a frame overshoots is not added to the next one.
+    // After falling more than a frame behind (e.g., after idling), pacing restarts from now instead of catching up.
+    double frameDuration = 1.0 / m_frameRateLimit;
+    double currentTime = glfwGetTime();
+    m_nextFrameTime += frameDuration;
+    if (m_nextFrameTime < currentTime)
+    {
+        m_nextFrameTime = currentTime + frameDuration;
+    }
+}
+
+/**
+ * @brief Makes the viewer render the next few frames in idle mode.
+ */
+void Application::InvalidateFrame()
+{
+    m_numFramesToRender = std::max(m_numFramesToRender, IDLE_SETTLE_FRAMES);
+}
+
+/**
+ * @brief Invalidates the frame if input was received, a key is held down (e.g., moving the camera),
+ * or texture streaming needs more frames.
+ */
+void Application::CheckFrameInvalidation()
+{
+    if (Input::HasEvents() || Input::IsAnyDown() || m_renderer.IsStreamingTextures())
+    {
+        InvalidateFrame();
+    }
+}
+
+/**
+ * @brief Writes the renderer statistics into the statistics output file, or a default file if none was specified.
+ */
+void Application::WriteRendererStatistics()
+{
+    m_renderer.WriteStatisticsToFile(m_launchOptions.statisticsOutputPath.empty() ? "renderer_statistics.json" : m_launchOptions.statisticsOutputPath);
+}
+
+/**
+ * @brief Records the commands for rendering the next frame.
+ * @param[in] commandBuffer Command buffer
+ * @param[in] frameIndex Index of the frame in flight, which selects the per-frame resources
+ * @param[in] imageIndex Index of the image to render into
+ * @return Returns true if the commands were recorded successfully. Returns false otherwise.
+ */
+bool Application::RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t imageIndex)
+{
+    PROFILE_FUNCTION();
+
+    vkResetCommandBuffer(commandBuffer, 0);
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = 0; // Optional
+    beginInfo.pInheritanceInfo = nullptr; // Optional; only relevant for secondary command buffers
+
+    // Begin command buffer
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+    {
+        std::cout << "Failed to begin recording command buffer!" << std::endl;
+        return false;
+    }
+
+    m_gpuProfiler.BeginFrame(commandBuffer, frameIndex);
+    uint32_t frameScope = m_gpuProfiler.BeginScope(commandBuffer, "Frame");
+    float renderScale = UpdateRenderScale(frameIndex);
+
+    // Vertex and index data is copied before the render pass, since copies are not allowed inside one
+    PrepareRenderBatch(frameIndex);
+    uint32_t uploadScope = m_gpuProfiler.BeginScope(commandBuffer, "Upload");
+    m_renderer.Upload(commandBuffer, frameIndex, m_camera.GetViewMatrix(), m_camera.GetProjectionMatrix());
+    m_gpuProfiler.EndScope(commandBuffer, uploadScope);
+
+    if (renderScale < 1.0f)
+    {
+        if (!RecordScaledPasses(commandBuffer, frameIndex, imageIndex, renderScale))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        // Begin render pass
+        VkRenderPassBeginInfo renderPassInfo = {};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = m_vkRenderPass;
+        renderPassInfo.framebuffer = m_vkSwapchainFramebuffers[imageIndex];
+        // Size of the render area
+        renderPassInfo.renderArea.offset = { 0, 0 };
+        renderPassInfo.renderArea.extent = GetSwapchainImageExtent();
+
+        // Clear values (1 for color buffer, 1 for depth buffer)
+        std::array<VkClearValue, 2> clearValues;
+        clearValues[0].color = {{ 1.0f, 0.0f, 0.0f, 1.0f }};
+        clearValues[1].depthStencil = { 1.0f, 0 };
+        renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+        renderPassInfo.pClearValues = clearValues.data();
+        // The viewport and scissors are dynamic state, which the renderer and ImGui set along with their draws
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo,
+            m_renderer.IsRecordingInParallel() ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
 
-	ImGui_ImplVulkan_Init(&init_info, m_vkRenderPass);
+        Render(commandBuffer, frameIndex, GetSwapchainImageExtent());
+        RenderOverlay(commandBuffer, frameIndex);
 
-	//execute a gpu command to upload imgui font textures
-    VkCommandBuffer cmd = VulkanContext::BeginSingleUseCommandBuffer();
-	ImGui_ImplVulkan_CreateFontsTexture(cmd);
-    VulkanContext::EndSingleUseCommandBuffer(cmd);
+        vkCmdEndRenderPass(commandBuffer);
+    }
 
-	//clear font textures from cpu data
-	ImGui_ImplVulkan_DestroyFontUploadObjects();
+    m_gpuProfiler.EndScope(commandBuffer, frameScope);
+
+    if ((m_launchOptions.statisticsInterval > 0) && !m_launchOptions.statisticsOutputPath.empty()
+        && (m_renderer.GetFrameNumber() % m_launchOptions.statisticsInterval == 0))
+    {
+        WriteRendererStatistics();
+    }
+
+    // Finish recording buffer.
+    // This is where we have error handling.
+    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+    {
+        std::cout << "Failed to end recording of command buffer!" << std::endl;
+        return false;
+    }
 
     return true;
 }
 
 /**
- * @brief Updates the application's state.
- * @param[in] deltaTime Time elapsed since the previous frame.
+ * @brief Records the model pass into the frame's reduced resolution render target, upscales it into a swapchain image
+ * and records the overlay on top.
+ * @param[in] commandBuffer Command buffer
+ * @param[in] frameIndex Index of the frame in flight
+ * @param[in] imageIndex Index of the swapchain image
+ * @param[in] renderScale Resolution scale of the model pass
+ * @return Returns true if the passes were recorded. Returns false otherwise.
  */
-void Application::Update(float deltaTime)
+bool Application::RecordScaledPasses(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t imageIndex, const float& renderScale)
 {
-    float sensitivity = 1.0f;
-    if (Input::IsDown(Input::RIGHT_MOUSE))
+    // Render targets are created the first time they are needed, and again after the swapchain is recreated
+    if (m_renderTargetFramebuffers.empty() && !InitRenderTargets())
     {
-        m_camera.SetYaw(m_camera.GetYaw() + Input::GetMouseDeltaX() * sensitivity);
-
-        float pitch = m_camera.GetPitch() + Input::GetMouseDeltaY() * sensitivity;
-        pitch = std::clamp(pitch, -89.0f, 89.0f);
-        m_camera.SetPitch(pitch);
+        return false;
     }
 
-    float moveSpeed = 5.0f;
-    glm::vec3 cameraForward = m_camera.GetCamera().GetForwardVector();
-    glm::vec3 cameraRight = m_camera.GetCamera().GetRightVector();
+    VkExtent2D swapchainExtent = GetSwapchainImageExtent();
+    VkExtent2D scaledExtent;
+    scaledExtent.width = std::max(1u, static_cast<uint32_t>(swapchainExtent.width * renderScale));
+    scaledExtent.height = std::max(1u, static_cast<uint32_t>(swapchainExtent.height * renderScale));
+
+    VkSubpassContents subpassContents = m_renderer.IsRecordingInParallel() ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE;
+
+    std::array<VkClearValue, 2> clearValues;
+    clearValues[0].color = {{ 1.0f, 0.0f, 0.0f, 1.0f }};
+    clearValues[1].depthStencil = { 1.0f, 0 };
+
+    VkRenderPassBeginInfo renderPassInfo = {};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    renderPassInfo.renderPass = m_vkScenePass;
+    renderPassInfo.framebuffer = m_renderTargetFramebuffers[frameIndex];
+    renderPassInfo.renderArea.offset = { 0, 0 };
+    renderPassInfo.renderArea.extent = scaledExtent;
+    renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+    renderPassInfo.pClearValues = clearValues.data();
+
+    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, subpassContents);
+    Render(commandBuffer, frameIndex, scaledExtent);
+    vkCmdEndRenderPass(commandBuffer);
+
+    uint32_t upscaleScope = m_gpuProfiler.BeginScope(commandBuffer, "Upscale");
+
+    // The submission waits for the acquired image at the color attachment output stage,
+    // so the transition starts from that stage to chain onto the wait
+    VkImageMemoryBarrier swapchainImageBarrier = {};
+    swapchainImageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    swapchainImageBarrier.srcAccessMask = 0;
+    swapchainImageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    swapchainImageBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    swapchainImageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    swapchainImageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    swapchainImageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    swapchainImageBarrier.image = m_vkSwapchainImages[imageIndex];
+    swapchainImageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    swapchainImageBarrier.subresourceRange.baseMipLevel = 0;
+    swapchainImageBarrier.subresourceRange.levelCount = 1;
+    swapchainImageBarrier.subresourceRange.baseArrayLayer = 0;
+    swapchainImageBarrier.subresourceRange.layerCount = 1;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+        0, nullptr, 0, nullptr, 1, &swapchainImageBarrier);
+
+    VkImageBlit blit = {};
+    blit.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    blit.srcOffsets[1] = { static_cast<int32_t>(scaledExtent.width), static_cast<int32_t>(scaledExtent.height), 1 };
+    blit.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    blit.dstOffsets[1] = { static_cast<int32_t>(swapchainExtent.width), static_cast<int32_t>(swapchainExtent.height), 1 };
+    vkCmdBlitImage(commandBuffer, m_renderTargetImages[frameIndex].GetHandle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        m_vkSwapchainImages[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+
+    m_gpuProfiler.EndScope(commandBuffer, upscaleScope);
+
+    // The overlay stays at full resolution
+    renderPassInfo.renderPass = m_vkOverlayPass;
+    renderPassInfo.framebuffer = m_vkSwapchainFramebuffers[imageIndex];
+    renderPassInfo.renderArea.extent = swapchainExtent;
+
+    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, subpassContents);
+    RenderOverlay(commandBuffer, frameIndex);
+    vkCmdEndRenderPass(commandBuffer);
 
-    glm::vec3 movementVector(0.0f);
-    if (Input::IsDown(Input::Key::W))
-    {
-        movementVector += cameraForward;
-    }
-    else if (Input::IsDown(Input::S))
-    {
-        movementVector -= cameraForward;
-    }
+    return true;
+}
 
-    if (Input::IsDown(Input::Key::A))
-    {
-        movementVector -= cameraRight;
-    }
-    else if (Input::IsDown(Input::Key::D))
+/**
+ * @brief Updates the resolution scale from the GPU time of the frame slot's previous frame, and picks the scale of the next frame.
+ * The next frame is rendered at full resolution unless dynamic resolution is enabled and the camera is being moved.
+ * @param[in] frameIndex Index of the frame in flight
+ * @return Resolution scale of the next frame
+ */
+float Application::UpdateRenderScale(uint32_t frameIndex)
+{
+    // The slot's previous frame has completed, and its scale is known, so the scale that would have
+    // hit the target can be estimated from it. The GPU time grows with the number of pixels, i.e., the square of the scale.
+    const std::vector<GpuProfiler::ScopeTiming>& timings = m_gpuProfiler.GetFrameTimings(frameIndex);
+    if (!timings.empty() && (timings[0].time > 0.0))
     {
-        movementVector += cameraRight;
-    }
+        m_lastGpuFrameTime = static_cast<float>(timings[0].time);
 
-    if (glm::dot(movementVector, movementVector) > 0.0f)
-    {
-        movementVector = glm::normalize(movementVector);
-        m_camera.SetLookTarget(m_camera.GetLookTarget() + movementVector * moveSpeed * deltaTime);
+        float idealScale = m_frameRenderScales[frameIndex] * std::sqrt(m_targetFrameTime / m_lastGpuFrameTime);
+        m_renderScale += (idealScale - m_renderScale) * RENDER_SCALE_DAMPING;
     }
+    m_renderScale = std::clamp(m_renderScale, m_minRenderScale, m_maxRenderScale);
+
+    // Full resolution returns as soon as the camera stops moving. The view matrix is compared rather than the input,
+    // so keys and drags that do not move the camera (e.g., on the overlay windows) keep full resolution.
+    glm::mat4 viewMatrix = m_camera.GetViewMatrix();
+    bool isCameraMoving = (viewMatrix != m_previousViewMatrix);
+    m_previousViewMatrix = viewMatrix;
+    float frameScale = (m_isDynamicResolutionSupported && m_isDynamicResolutionEnabled && isCameraMoving) ? m_renderScale : 1.0f;
+    m_frameRenderScales[frameIndex] = frameScale;
+
+    return frameScale;
 }
 
 /**
- * @brief Renders the next frame.
- * @param[in] commandBuffer Command buffer
- * @param[in] imageIndex Frame index
+ * @brief Copies the GPU times of the last collected use of a command buffer into a benchmark sample.
+ * @param[in] frameIndex Index of the frame in flight the command buffer belongs to
+ * @param[out] outSample Benchmark sample. The GPU time is set to -1 if it is unavailable.
  */
-void Application::Render(VkCommandBuffer commandBuffer, uint32_t imageIndex)
+void Application::GetFrameGpuTimes(uint32_t frameIndex, BenchmarkReport::FrameSample& outSample)
 {
-    m_renderer.Begin();
-
-    m_renderer.DrawModel(m_currentModel, m_currentModelTransform);
+    // The outermost scope covers the whole command buffer
+    const std::vector<GpuProfiler::ScopeTiming>& timings = m_gpuProfiler.GetFrameTimings(frameIndex);
+    outSample.gpuTime = timings.empty() ? -1.0 : timings[0].time;
 
-    m_renderer.End();
-
-    m_renderer.Render(commandBuffer, imageIndex, m_camera.GetViewMatrix(), m_camera.GetProjectionMatrix());
+    outSample.gpuScopeTimes.clear();
+    for (const GpuProfiler::ScopeTiming& timing : timings)
+    {
+        outSample.gpuScopeTimes.emplace_back(timing.name, timing.time);
+    }
+}
 
-    ImGui_ImplVulkan_NewFrame();
-    ImGui_ImplGlfw_NewFrame();
-    ImGui::NewFrame();
+/**
+ * @brief Copies an offscreen color image to the CPU and writes it into a PPM file.
+ * @param[in] imageIndex Index of the offscreen color image
+ * @param[in] filePath Output file path
+ * @return Returns true if the image was written successfully. Returns false otherwise.
+ */
+bool Application::SaveOffscreenImage(uint32_t imageIndex, const std::string& filePath)
+{
+    const uint32_t width = m_vkSwapchainImageExtent.width;
+    const uint32_t height = m_vkSwapchainImageExtent.height;
+    const VkDeviceSize imageSize = static_cast<VkDeviceSize>(width) * height * 4;
 
-    if (m_currentModel != nullptr)
+    VulkanBuffer readbackBuffer;
+    if (!readbackBuffer.Create(imageSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
     {
-        ImGui::SetNextWindowSize({250, 100});
-        ImGui::Begin("Model info");
+        std::cout << "Failed to create readback buffer for the offscreen image!" << std::endl;
+        return false;
+    }
 
-        ImGui::Text("Vertices: %u", m_currentModel->GetTotalVertexCount());
-        ImGui::Text("Triangles: %u", m_currentModel->GetTotalTriangleCount());
+    VkCommandBuffer commandBuffer = VulkanContext::BeginSingleUseCommandBuffer();
+
+    // Make the color attachment writes of the render pass visible to the copy.
+    // The render pass already left the image in the transfer source layout.
+    VkImageMemoryBarrier imageBarrier = {};
+    imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    imageBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    imageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    imageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    imageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    imageBarrier.image = m_vkSwapchainImages[imageIndex];
+    imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    imageBarrier.subresourceRange.baseMipLevel = 0;
+    imageBarrier.subresourceRange.levelCount = 1;
+    imageBarrier.subresourceRange.baseArrayLayer = 0;
+    imageBarrier.subresourceRange.layerCount = 1;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageBarrier);
+
+    VkBufferImageCopy copyRegion = {};
+    copyRegion.bufferOffset = 0;
+    copyRegion.bufferRowLength = 0; // Tightly packed
+    copyRegion.bufferImageHeight = 0;
+    copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    copyRegion.imageSubresource.mipLevel = 0;
+    copyRegion.imageSubresource.baseArrayLayer = 0;
+    copyRegion.imageSubresource.layerCount = 1;
+    copyRegion.imageOffset = { 0, 0, 0 };
+    copyRegion.imageExtent = { width, height, 1 };
+    vkCmdCopyImageToBuffer(commandBuffer, m_vkSwapchainImages[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readbackBuffer.GetHandle(), 1, &copyRegion);
+
+    // Make the copied pixels visible to the host
+    VkMemoryBarrier hostBarrier = {};
+    hostBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &hostBarrier, 0, nullptr, 0, nullptr);
+
+    VulkanContext::EndSingleUseCommandBuffer(commandBuffer);
+
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cout << "Failed to open " << filePath << " for writing!" << std::endl;
+        readbackBuffer.Cleanup();
+        return false;
+    }
 
-        ImGui::End();
+    // Binary PPM only stores RGB, so the alpha channel is dropped
+    file << "P6\n" << width << " " << height << "\n255\n";
+    const uint8_t* pixels = reinterpret_cast<const uint8_t*>(readbackBuffer.MapMemory(0, imageSize));
+    std::vector<char> row(static_cast<size_t>(width) * 3);
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        const uint8_t* srcRow = pixels + static_cast<size_t>(y) * width * 4;
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            row[x * 3 + 0] = static_cast<char>(srcRow[x * 4 + 0]);
+            row[x * 3 + 1] = static_cast<char>(srcRow[x * 4 + 1]);
+            row[x * 3 + 2] = static_cast<char>(srcRow[x * 4 + 2]);
+        }
+        file.write(row.data(), row.size());
     }
+    readbackBuffer.UnmapMemory();
+    readbackBuffer.Cleanup();
 
-    ImGui::Render();
-    ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), commandBuffer);
+    std::cout << "Wrote the last rendered frame to " << filePath << std::endl;
 
-    ImGui::EndFrame();
+    return true;
 }
 
 void Application::Cleanup()
 {
     vkDeviceWaitIdle(VulkanContext::GetLogicalDevice());
-    vkDestroyDescriptorPool(VulkanContext::GetLogicalDevice(), m_vkImguiPool, nullptr);
-	ImGui_ImplVulkan_Shutdown();
+    if (m_vkImguiPool != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorPool(VulkanContext::GetLogicalDevice(), m_vkImguiPool, nullptr);
+        m_vkImguiPool = VK_NULL_HANDLE;
+        ImGui_ImplVulkan_Shutdown();
+    }
 
     CleanupSwapchain();
 
@@ -436,12 +2044,8 @@ void Application::Cleanup()
     }
 
     // Destroy synchronization tools
-    for (uint32_t i = 0; i < m_maxFramesInFlight; ++i)
+    for (size_t i = 0; i < m_vkImageAvailableSemaphores.size(); ++i)
     {
-        if (m_vkFrameInFlightFences[i] != VK_NULL_HANDLE)
-        {
-            vkDestroyFence(VulkanContext::GetLogicalDevice(), m_vkFrameInFlightFences[i], nullptr);
-        }
         if (m_vkRenderFinishedSemaphores[i] != VK_NULL_HANDLE)
         {
             vkDestroySemaphore(VulkanContext::GetLogicalDevice(), m_vkRenderFinishedSemaphores[i], nullptr);
@@ -451,8 +2055,8 @@ void Application::Cleanup()
             vkDestroySemaphore(VulkanContext::GetLogicalDevice(), m_vkImageAvailableSemaphores[i], nullptr);
         }
     }
-    m_vkImageInFlightFences.clear();
-    m_vkFrameInFlightFences.clear();
+    m_imageSubmissions.clear();
+    m_frameSubmissions.clear();
     m_vkRenderFinishedSemaphores.clear();
     m_vkImageAvailableSemaphores.clear();
 
@@ -469,7 +2073,10 @@ void Application::Cleanup()
         m_window = nullptr;
     }
 
-    glfwTerminate();
+    if (!m_launchOptions.headless)
+    {
+        glfwTerminate();
+    }
 }
 
 /**
@@ -595,13 +2202,13 @@ bool Application::InitSwapchain()
         }
     }
 
-    // Select preferred present mode.
-    // By default, GPUs should support VK_PRESENT_MODE_FIFO_KHR at the bare minimum, but
-    // if we can find VK_PRESENT_MODE_MAILBOX_KHR, then we use that
+    // Select the requested present mode.
+    // By default, GPUs should support VK_PRESENT_MODE_FIFO_KHR at the bare minimum, so we
+    // fall back to that if the requested mode is not available
     VkPresentModeKHR selectedPresentMode = VK_PRESENT_MODE_FIFO_KHR;
     for (size_t i = 0; i < availablePresentModes.size(); ++i)
     {
-        if (availablePresentModes[i] == VK_PRESENT_MODE_MAILBOX_KHR)
+        if (availablePresentModes[i] == m_requestedPresentMode)
         {
             selectedPresentMode = availablePresentModes[i];
             break;
@@ -626,10 +2233,21 @@ bool Application::InitSwapchain()
         swapchainImageExtent.height = std::clamp(static_cast<uint32_t>(height), surfaceCapabilities.minImageExtent.height, surfaceCapabilities.maxImageExtent.height);
     }
 
+    // Dynamic resolution upscales the render targets into the swapchain images with a filtered blit
+    VkFormatProperties formatProperties;
+    vkGetPhysicalDeviceFormatProperties(VulkanContext::GetPhysicalDevice(), selectedSurfaceFormat.format, &formatProperties);
+    VkFormatFeatureFlags blitFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    m_isDynamicResolutionSupported = ((surfaceCapabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT) != 0)
+        && ((formatProperties.optimalTilingFeatures & blitFeatures) == blitFeatures);
+
     // --- Create swapchain ---
 
     // Prepare swapchain create struct
     uint32_t numSwapchainImages = surfaceCapabilities.minImageCount + 1;
+    if (m_requestedSwapchainImageCount > 0)
+    {
+        numSwapchainImages = std::max(m_requestedSwapchainImageCount, surfaceCapabilities.minImageCount);
+    }
     if (surfaceCapabilities.maxImageCount > 0)
     {
         numSwapchainImages = std::min(numSwapchainImages, surfaceCapabilities.maxImageCount);
@@ -645,7 +2263,12 @@ bool Application::InitSwapchain()
     swapchainCreateInfo.clipped = VK_TRUE; // Clip pixels that are obscured, e.g., by other windows
     swapchainCreateInfo.imageExtent = swapchainImageExtent;
     swapchainCreateInfo.imageArrayLayers = 1;
-    swapchainCreateInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT; // Can use VK_IMAGE_USAGE_TRANSFER_DST_BIT for rendering to an offscreen buffer (e.g., post-processing)
+    swapchainCreateInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    if (m_isDynamicResolutionSupported)
+    {
+        // A model pass rendered at a reduced resolution is upscaled into the swapchain image
+        swapchainCreateInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    }
     if (VulkanContext::GetGraphicsQueueIndex() != VulkanContext::GetPresentQueueIndex())
     {
         // Graphics queue and present queue are different (in some GPUs, they can be the same).
@@ -669,15 +2292,18 @@ bool Application::InitSwapchain()
     swapchainCreateInfo.preTransform = surfaceCapabilities.currentTransform;
     // Blending with other windows. (We almost always ignore)
     swapchainCreateInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-    // In case the previous swap chain becomes invalid. In that case, we need to supply the old swapchain
-    swapchainCreateInfo.oldSwapchain = VK_NULL_HANDLE;
+    // When recreating, the current swapchain is supplied as the old swapchain, so that the driver can reuse its
+    // resources and the images it still holds can be presented. It is retired, and destroyed by the caller later on.
+    swapchainCreateInfo.oldSwapchain = m_vkSwapchain;
 
     // Actually create the swapchain
-    if (vkCreateSwapchainKHR(VulkanContext::GetLogicalDevice(), &swapchainCreateInfo, nullptr, &m_vkSwapchain) != VK_SUCCESS)
+    VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+    if (vkCreateSwapchainKHR(VulkanContext::GetLogicalDevice(), &swapchainCreateInfo, nullptr, &swapchain) != VK_SUCCESS)
     {
         std::cout << "Failed to create swapchain!" << std::endl;
         return false;
     }
+    m_vkSwapchain = swapchain;
 
     // Retrieve swapchain images, and store the image format and extent
     vkGetSwapchainImagesKHR(VulkanContext::GetLogicalDevice(), m_vkSwapchain, &numSwapchainImages, nullptr);
@@ -685,6 +2311,10 @@ bool Application::InitSwapchain()
     vkGetSwapchainImagesKHR(VulkanContext::GetLogicalDevice(), m_vkSwapchain, &numSwapchainImages, m_vkSwapchainImages.data());
     m_vkSwapchainImageFormat = selectedSurfaceFormat.format;
     m_vkSwapchainImageExtent = swapchainImageExtent;
+    m_vkSwapchainPresentMode = selectedPresentMode;
+    m_availablePresentModes = availablePresentModes;
+    m_minSwapchainImageCount = surfaceCapabilities.minImageCount;
+    m_maxSwapchainImageCount = surfaceCapabilities.maxImageCount;
 
     m_vkSwapchainImageViews.resize(m_vkSwapchainImages.size());
     for (size_t i = 0; i < m_vkSwapchainImages.size(); ++i)
@@ -696,7 +2326,43 @@ bool Application::InitSwapchain()
         }
     }
 
-    m_maxFramesInFlight = static_cast<uint32_t>(m_vkSwapchainImages.size());
+    return true;
+}
+
+/**
+ * @brief Initializes the offscreen color images used in place of the swapchain in headless mode.
+ * @return Returns true if the initialization was successful. Returns false otherwise.
+ */
+bool Application::InitOffscreenTargets()
+{
+    m_vkSwapchainImageFormat = VK_FORMAT_R8G8B8A8_SRGB;
+    m_vkSwapchainImageExtent = { m_launchOptions.width, m_launchOptions.height };
+
+    // One color image per frame in flight, so that consecutive frames never write into the same image
+    m_offscreenColorImages.resize(m_maxFramesInFlight);
+    m_vkSwapchainImages.resize(m_maxFramesInFlight);
+    m_vkSwapchainImageViews.resize(m_maxFramesInFlight);
+    for (uint32_t i = 0; i < m_maxFramesInFlight; ++i)
+    {
+        if (!m_offscreenColorImages[i].Create(
+                m_vkSwapchainImageExtent.width,
+                m_vkSwapchainImageExtent.height,
+                m_vkSwapchainImageFormat,
+                VK_IMAGE_TILING_OPTIMAL,
+                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT))
+        {
+            std::cout << "Failed to create offscreen color image!" << std::endl;
+            return false;
+        }
+        m_vkSwapchainImages[i] = m_offscreenColorImages[i].GetHandle();
+
+        if (!m_vkSwapchainImageViews[i].Create(m_vkSwapchainImages[i], m_vkSwapchainImageFormat, VK_IMAGE_ASPECT_COLOR_BIT))
+        {
+            std::cout << "Failed to create offscreen color image views!" << std::endl;
+            return false;
+        }
+    }
 
     return true;
 }
@@ -707,23 +2373,21 @@ bool Application::InitSwapchain()
  */
 bool Application::InitSynchronizationTools()
 {
+    // Frame completion is tracked with the context's submission timeline, so no fences are needed.
+    // Submission 0 counts as already completed, so the first frames do not wait.
+    m_frameSubmissions.assign(m_maxFramesInFlight, 0);
+    m_imageSubmissions.assign(m_vkSwapchainImages.size(), 0);
+
     // --- Create semaphores that we use for rendering ---
-    m_vkImageAvailableSemaphores.resize(m_maxFramesInFlight);
-    m_vkRenderFinishedSemaphores.resize(m_maxFramesInFlight);
-    m_vkFrameInFlightFences.resize(m_maxFramesInFlight);
-    m_vkImageInFlightFences.resize(m_vkSwapchainImages.size(), VK_NULL_HANDLE);
+    m_vkImageAvailableSemaphores.resize(m_maxFramesInFlight, VK_NULL_HANDLE);
+    m_vkRenderFinishedSemaphores.resize(m_maxFramesInFlight, VK_NULL_HANDLE);
     for (uint32_t i = 0; i < m_maxFramesInFlight; ++i)
     {
         VkSemaphoreCreateInfo semaphoreCreateInfo = {};
         semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-        VkFenceCreateInfo fenceCreateInfo = {};
-        fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT; // Set the flag to be already signalled at the start
-
         if ((vkCreateSemaphore(VulkanContext::GetLogicalDevice(), &semaphoreCreateInfo, nullptr, &m_vkImageAvailableSemaphores[i]) != VK_SUCCESS) 
-                || (vkCreateSemaphore(VulkanContext::GetLogicalDevice(), &semaphoreCreateInfo, nullptr, &m_vkRenderFinishedSemaphores[i]) != VK_SUCCESS)
-                || (vkCreateFence(VulkanContext::GetLogicalDevice(), &fenceCreateInfo, nullptr, &m_vkFrameInFlightFences[i]) != VK_SUCCESS))
+                || (vkCreateSemaphore(VulkanContext::GetLogicalDevice(), &semaphoreCreateInfo, nullptr, &m_vkRenderFinishedSemaphores[i]) != VK_SUCCESS))
         {
             std::cout << "Failed to create synchronization tools!" << std::endl;
             return false;
@@ -759,13 +2423,14 @@ bool Application::InitCommandPool()
  */
 bool Application::InitCommandBuffers()
 {
-    m_vkCommandBuffers.resize(GetSwapchainImageCount());
+    // Command buffers belong to frame slots, so they are only reused once their frame's fence has signaled
+    m_vkCommandBuffers.resize(m_maxFramesInFlight);
 
     VkCommandBufferAllocateInfo commandBufferInfo = {};
     commandBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
     commandBufferInfo.commandPool = m_vkCommandPool;
     commandBufferInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    commandBufferInfo.commandBufferCount = GetSwapchainImageCount();
+    commandBufferInfo.commandBufferCount = m_maxFramesInFlight;
 
     if (vkAllocateCommandBuffers(VulkanContext::GetLogicalDevice(), &commandBufferInfo, m_vkCommandBuffers.data()) != VK_SUCCESS)
     {
@@ -773,6 +2438,14 @@ bool Application::InitCommandBuffers()
         return false;
     }
 
+    m_vkImGuiCommandBuffers.resize(m_maxFramesInFlight);
+    commandBufferInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+    if (vkAllocateCommandBuffers(VulkanContext::GetLogicalDevice(), &commandBufferInfo, m_vkImGuiCommandBuffers.data()) != VK_SUCCESS)
+    {
+        std::cout << "Failed to create ImGui command buffers!" << std::endl;
+        return false;
+    }
+
     return true;
 }
 
@@ -827,7 +2500,8 @@ bool Application::InitRenderPass()
     colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE; // We don't use stencil testing, so we don't care for now
     colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE; // We don't use stencil testing, so we don't care for now
     colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    // Offscreen images are only ever read back, so they end up in the transfer source layout instead
+    colorAttachment.finalLayout = m_launchOptions.headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
     VkAttachmentReference colorAttachmentReference = {};
     colorAttachmentReference.attachment = 0; // This is reflected in the "layout(location = 0) out color" in the fragment shader
@@ -879,6 +2553,50 @@ bool Application::InitRenderPass()
         return false;
     }
 
+    // The scene and overlay passes only differ from the main render pass in their layouts, load operations and
+    // dependencies, so they are compatible with it and share its pipelines and framebuffers.
+    // The scene pass leaves the render target ready to be blitted from.
+    VkSubpassDependency blitSourceDependency = {};
+    blitSourceDependency.srcSubpass = 0;
+    blitSourceDependency.dstSubpass = VK_SUBPASS_EXTERNAL;
+    blitSourceDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    blitSourceDependency.dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    blitSourceDependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    blitSourceDependency.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+    std::array<VkSubpassDependency, 2> sceneDependencies = { subpassDependency, blitSourceDependency };
+    attachments[0].finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    renderPassCreateInfo.dependencyCount = static_cast<uint32_t>(sceneDependencies.size());
+    renderPassCreateInfo.pDependencies = sceneDependencies.data();
+
+    if (vkCreateRenderPass(VulkanContext::GetLogicalDevice(), &renderPassCreateInfo, nullptr, &m_vkScenePass) != VK_SUCCESS)
+    {
+        std::cout << "Failed to create scene render pass!" << std::endl;
+        return false;
+    }
+
+    // The overlay pass keeps the upscaled image that was blitted into the swapchain image
+    VkSubpassDependency blitDestinationDependency = {};
+    blitDestinationDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    blitDestinationDependency.dstSubpass = 0;
+    blitDestinationDependency.srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    blitDestinationDependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    blitDestinationDependency.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    blitDestinationDependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+    std::array<VkSubpassDependency, 2> overlayDependencies = { subpassDependency, blitDestinationDependency };
+    attachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    attachments[0].initialLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    attachments[0].finalLayout = colorAttachment.finalLayout;
+    renderPassCreateInfo.dependencyCount = static_cast<uint32_t>(overlayDependencies.size());
+    renderPassCreateInfo.pDependencies = overlayDependencies.data();
+
+    if (vkCreateRenderPass(VulkanContext::GetLogicalDevice(), &renderPassCreateInfo, nullptr, &m_vkOverlayPass) != VK_SUCCESS)
+    {
+        std::cout << "Failed to create overlay render pass!" << std::endl;
+        return false;
+    }
+
     return true;
 }
 
@@ -915,6 +2633,62 @@ bool Application::InitFramebuffers()
     return true;
 }
 
+/**
+ * @brief Initializes the render targets the model pass is rendered into at a reduced resolution.
+ * @return Returns true if the initialization was successful. Returns false otherwise.
+ */
+bool Application::InitRenderTargets()
+{
+    // The render targets have the size of the window, and the model is rendered into their top-left corner,
+    // so changing the resolution scale never recreates them
+    m_renderTargetImages.resize(m_maxFramesInFlight);
+    m_renderTargetImageViews.resize(m_maxFramesInFlight);
+    m_renderTargetFramebuffers.resize(m_maxFramesInFlight, VK_NULL_HANDLE);
+    for (uint32_t i = 0; i < m_maxFramesInFlight; ++i)
+    {
+        if (!m_renderTargetImages[i].Create(
+                m_vkSwapchainImageExtent.width,
+                m_vkSwapchainImageExtent.height,
+                m_vkSwapchainImageFormat,
+                VK_IMAGE_TILING_OPTIMAL,
+                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT))
+        {
+            std::cout << "Failed to create render target image!" << std::endl;
+            return false;
+        }
+
+        if (!m_renderTargetImageViews[i].Create(m_renderTargetImages[i].GetHandle(), m_vkSwapchainImageFormat, VK_IMAGE_ASPECT_COLOR_BIT))
+        {
+            std::cout << "Failed to create render target image view!" << std::endl;
+            return false;
+        }
+
+        std::array<VkImageView, 2> attachments =
+        {
+            m_renderTargetImageViews[i].GetHandle(),
+            m_vkDepthBufferImageView.GetHandle()
+        };
+
+        VkFramebufferCreateInfo framebufferCreateInfo = {};
+        framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebufferCreateInfo.renderPass = m_vkScenePass;
+        framebufferCreateInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+        framebufferCreateInfo.pAttachments = attachments.data();
+        framebufferCreateInfo.width = m_vkSwapchainImageExtent.width;
+        framebufferCreateInfo.height = m_vkSwapchainImageExtent.height;
+        framebufferCreateInfo.layers = 1;
+
+        if (vkCreateFramebuffer(VulkanContext::GetLogicalDevice(), &framebufferCreateInfo, nullptr, &m_renderTargetFramebuffers[i]) != VK_SUCCESS)
+        {
+            std::cout << "Failed to create render target framebuffer!" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
 /**
  * @brief Recreates the Vulkan swapchain and the related objects.
  * @return Returns true if the swapchain was successfully recreated. Returns false otherwise.
@@ -930,20 +2704,111 @@ bool Application::RecreateSwapchain()
         glfwWaitEvents();
     }
 
-    CleanupSwapchain();
+    // Only the objects that depend on the swapchain images or their size are replaced. The old ones are retired
+    // instead of destroyed, so the frames in flight that still use them keep running without waiting for the device.
+    RetiredSwapchain retiredSwapchain;
+    retiredSwapchain.swapchain = m_vkSwapchain;
+    retiredSwapchain.imageViews.swap(m_vkSwapchainImageViews);
+    retiredSwapchain.framebuffers.swap(m_vkSwapchainFramebuffers);
+    retiredSwapchain.depthBufferImage = m_vkDepthBufferImage;
+    retiredSwapchain.depthBufferImageView = m_vkDepthBufferImageView;
+    retiredSwapchain.renderTargetImages.swap(m_renderTargetImages);
+    retiredSwapchain.renderTargetImageViews.swap(m_renderTargetImageViews);
+    retiredSwapchain.renderTargetFramebuffers.swap(m_renderTargetFramebuffers);
+    retiredSwapchain.submission = VulkanContext::GetLastSubmission();
+    m_vkDepthBufferImage = VulkanImage();
+    m_vkDepthBufferImageView = VulkanImageView();
+
+    VkFormat previousImageFormat = m_vkSwapchainImageFormat;
+    bool wasSwapchainCreated = InitSwapchain();
+    if (m_vkSwapchain == retiredSwapchain.swapchain)
+    {
+        // The swapchain could not be replaced, so it must not be destroyed with the retired objects
+        retiredSwapchain.swapchain = VK_NULL_HANDLE;
+    }
+    if (wasSwapchainCreated && (m_vkSwapchainImageFormat != previousImageFormat))
+    {
+        // The render passes are only compatible with the format they were created with
+        retiredSwapchain.renderPasses = { m_vkRenderPass, m_vkScenePass, m_vkOverlayPass };
+        m_vkRenderPass = VK_NULL_HANDLE;
+        m_vkScenePass = VK_NULL_HANDLE;
+        m_vkOverlayPass = VK_NULL_HANDLE;
+    }
+    m_retiredSwapchains.push_back(retiredSwapchain);
 
-    if (!InitSwapchain()
-            || !InitCommandBuffers()
+    if (!wasSwapchainCreated
+            || ((m_vkRenderPass == VK_NULL_HANDLE) && !InitRenderPass())
             || !InitDepthStencil()
-            || !InitRenderPass()
             || !InitFramebuffers())
     {
         return false;
     }
 
+    // The images of the new swapchain have not been rendered into yet, and their number may differ
+    m_imageSubmissions.assign(GetSwapchainImageCount(), 0);
+    m_lastPresentTime = 0.0;
+    m_renderer.SetRenderPass(m_vkRenderPass);
+
     return true;
 }
 
+/**
+ * @brief Destroys the objects of retired swapchains that are no longer used by any frame.
+ * @param[in] isDeviceIdle Flag indicating whether the device is idle, in which case every retired swapchain is destroyed
+ */
+void Application::DestroyRetiredSwapchains(const bool& isDeviceIdle)
+{
+    if (m_retiredSwapchains.empty())
+    {
+        return;
+    }
+
+    // Presentation is not tracked by the submission timeline. A retired swapchain is only destroyed once a submission
+    // made after it was retired has completed, by which point the last present of its images has been processed
+    // (presents are made on the graphics queue).
+    uint64_t completedSubmission = VulkanContext::GetCompletedSubmission();
+
+    size_t numRemainingSwapchains = 0;
+    for (size_t i = 0; i < m_retiredSwapchains.size(); ++i)
+    {
+        RetiredSwapchain& retiredSwapchain = m_retiredSwapchains[i];
+        if (!isDeviceIdle && (completedSubmission <= retiredSwapchain.submission))
+        {
+            m_retiredSwapchains[numRemainingSwapchains++] = retiredSwapchain;
+            continue;
+        }
+
+        for (size_t j = 0; j < retiredSwapchain.framebuffers.size(); ++j)
+        {
+            vkDestroyFramebuffer(VulkanContext::GetLogicalDevice(), retiredSwapchain.framebuffers[j], nullptr);
+        }
+        for (size_t j = 0; j < retiredSwapchain.renderTargetFramebuffers.size(); ++j)
+        {
+            vkDestroyFramebuffer(VulkanContext::GetLogicalDevice(), retiredSwapchain.renderTargetFramebuffers[j], nullptr);
+        }
+        for (size_t j = 0; j < retiredSwapchain.renderTargetImages.size(); ++j)
+        {
+            retiredSwapchain.renderTargetImageViews[j].Cleanup();
+            retiredSwapchain.renderTargetImages[j].Cleanup();
+        }
+        for (size_t j = 0; j < retiredSwapchain.renderPasses.size(); ++j)
+        {
+            vkDestroyRenderPass(VulkanContext::GetLogicalDevice(), retiredSwapchain.renderPasses[j], nullptr);
+        }
+        retiredSwapchain.depthBufferImageView.Cleanup();
+        retiredSwapchain.depthBufferImage.Cleanup();
+        for (size_t j = 0; j < retiredSwapchain.imageViews.size(); ++j)
+        {
+            retiredSwapchain.imageViews[j].Cleanup();
+        }
+        if (retiredSwapchain.swapchain != VK_NULL_HANDLE)
+        {
+            vkDestroySwapchainKHR(VulkanContext::GetLogicalDevice(), retiredSwapchain.swapchain, nullptr);
+        }
+    }
+    m_retiredSwapchains.resize(numRemainingSwapchains);
+}
+
 /**
  * @brief Cleans up the resources used by the Vulkan swapchain and the related objects.
  */
@@ -952,6 +2817,8 @@ void Application::CleanupSwapchain()
     // Wait for all pending operations to be done
     vkDeviceWaitIdle(VulkanContext::GetLogicalDevice());
 
+    DestroyRetiredSwapchains(true);
+
     // Destroy framebuffers
     for (size_t i = 0; i < m_vkSwapchainFramebuffers.size(); ++i)
     {
@@ -959,19 +2826,47 @@ void Application::CleanupSwapchain()
     }
     m_vkSwapchainFramebuffers.clear();
 
-    // Destroy render pass
+    // Destroy reduced resolution render targets
+    for (size_t i = 0; i < m_renderTargetFramebuffers.size(); ++i)
+    {
+        vkDestroyFramebuffer(VulkanContext::GetLogicalDevice(), m_renderTargetFramebuffers[i], nullptr);
+    }
+    m_renderTargetFramebuffers.clear();
+    for (size_t i = 0; i < m_renderTargetImages.size(); ++i)
+    {
+        m_renderTargetImageViews[i].Cleanup();
+        m_renderTargetImages[i].Cleanup();
+    }
+    m_renderTargetImageViews.clear();
+    m_renderTargetImages.clear();
+
+    // Destroy render passes
     if (m_vkRenderPass != VK_NULL_HANDLE)
     {
         vkDestroyRenderPass(VulkanContext::GetLogicalDevice(), m_vkRenderPass, nullptr);
         m_vkRenderPass = VK_NULL_HANDLE;
     }
+    if (m_vkScenePass != VK_NULL_HANDLE)
+    {
+        vkDestroyRenderPass(VulkanContext::GetLogicalDevice(), m_vkScenePass, nullptr);
+        m_vkScenePass = VK_NULL_HANDLE;
+    }
+    if (m_vkOverlayPass != VK_NULL_HANDLE)
+    {
+        vkDestroyRenderPass(VulkanContext::GetLogicalDevice(), m_vkOverlayPass, nullptr);
+        m_vkOverlayPass = VK_NULL_HANDLE;
+    }
 
     // Destroy depth/stencil resources
     m_vkDepthBufferImageView.Cleanup();
     m_vkDepthBufferImage.Cleanup();
 
+    // Destroy timestamp query pools
+    m_gpuProfiler.Cleanup();
+
     // Free command buffers
     vkFreeCommandBuffers(VulkanContext::GetLogicalDevice(), m_vkCommandPool, static_cast<uint32_t>(m_vkCommandBuffers.size()), m_vkCommandBuffers.data());
+    vkFreeCommandBuffers(VulkanContext::GetLogicalDevice(), m_vkCommandPool, static_cast<uint32_t>(m_vkImGuiCommandBuffers.size()), m_vkImGuiCommandBuffers.data());
 
     // Destroy swapchain image views
     // Note: No need to destroy the images since they were not explicitly created by us
@@ -981,6 +2876,13 @@ void Application::CleanupSwapchain()
     }
     m_vkSwapchainImageViews.clear();
 
+    // Destroy offscreen color images
+    for (size_t i = 0; i < m_offscreenColorImages.size(); ++i)
+    {
+        m_offscreenColorImages[i].Cleanup();
+    }
+    m_offscreenColorImages.clear();
+
     // Destroy swapchain
     if (m_vkSwapchain != VK_NULL_HANDLE)
     {
@@ -999,6 +2901,17 @@ void Application::FramebufferResizeCallback(GLFWwindow* window, int width, int h
 {
     Application* application = reinterpret_cast<Application*>(glfwGetWindowUserPointer(window));
     application->m_wasFramebufferResized = true;
+    application->InvalidateFrame();
+}
+
+/**
+ * @brief Callback function for when the contents of the window need to be redrawn (e.g., after being uncovered).
+ * @param[in] window Reference to the window that needs to be redrawn
+ */
+void Application::WindowRefreshCallback(GLFWwindow* window)
+{
+    Application* application = reinterpret_cast<Application*>(glfwGetWindowUserPointer(window));
+    application->InvalidateFrame();
 }
 
 /**
@@ -1031,39 +2944,6 @@ void Application::DropCallback(GLFWwindow* window, int count, const char** paths
         return;
     }
 
-    if (application->m_currentModel == nullptr)
-    {
-        application->m_currentModel = new Model();
-    }
-
-    Model* model = application->m_currentModel;
-    model->Load(paths[0]);
-    
-    // --- Scale model to have its largest dimension be of scale 1.0
-    if (model->GetTotalVertexCount() > 0)
-    {
-        // Calculate model bounding box
-        glm::vec3 min = model->GetMeshes()[0]->vertices[0].position;
-        glm::vec3 max = min;
-
-        for (size_t i = 0; i < model->GetMeshes().size(); ++i)
-        {
-            Mesh* mesh = model->GetMeshes()[i];
-            for (size_t j = 0; j < mesh->vertices.size(); ++j)
-            {
-                min.x = std::min(min.x, mesh->vertices[j].position.x);
-                min.y = std::min(min.y, mesh->vertices[j].position.y);
-                min.z = std::min(min.z, mesh->vertices[j].position.z);
-                max.x = std::max(max.x, mesh->vertices[j].position.x);
-                max.y = std::max(max.y, mesh->vertices[j].position.y);
-                max.z = std::max(max.z, mesh->vertices[j].position.z);
-            }
-        }
-
-        glm::vec3 dimensions = max - min;
-        float maxDimension = std::max({dimensions.x, dimensions.y, dimensions.z});
-        float modelScale = 2.0f / maxDimension;
-
-        application->m_currentModelTransform = glm::scale(glm::mat4(1.0f), glm::vec3(modelScale));
-    }
+    application->LoadModel(paths[0]);
+    application->InvalidateFrame();
 }
@@ -0,0 +1,371 @@
+#include "Benchmark/BenchmarkReport.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+/**
+ * @brief Constructor
+ * @param[in] name Name of the benchmark (e.g., the model file path)
+ */
+BenchmarkReport::BenchmarkReport(const std::string& name)
+    : m_name(name)
+    , m_frames()
+{
+}
+
+/**
+ * @brief Destructor
+ */
+BenchmarkReport::~BenchmarkReport()
+{
+}
+
+/**
+ * @brief Resizes the report to hold the specified number of frames. New frames are zeroed.
+ * @param[in] numFrames Number of frames
+ */
+void BenchmarkReport::SetFrameCount(const size_t& numFrames)
+{
+    m_frames.resize(numFrames, FrameSample {});
+}
+
+/**
+ * @brief Gets the measurements of a frame so that they can be filled in.
+ * @param[in] frameIndex Frame index
+ * @return Reference to the measurements of the frame
+ */
+BenchmarkReport::FrameSample& BenchmarkReport::GetFrame(const size_t& frameIndex)
+{
+    return m_frames[frameIndex];
+}
+
+/**
+ * @brief Prints the percentile summaries to the standard output.
+ */
+void BenchmarkReport::PrintSummary() const
+{
+    const std::pair<const char*, double FrameSample::*> quantities[] =
+    {
+        { "Frame time", &FrameSample::frameTime },
+        { "CPU time", &FrameSample::cpuTime },
+        { "GPU time", &FrameSample::gpuTime }
+    };
+
+    std::cout << "Benchmark " << m_name << " (" << m_frames.size() << " frames)" << std::endl;
+    for (const std::pair<const char*, double FrameSample::*>& quantity : quantities)
+    {
+        Summary summary = Summarize(quantity.second);
+        std::cout << "  " << quantity.first << ": avg " << summary.average << " ms, p50 " << summary.p50
+            << " ms, p95 " << summary.p95 << " ms, p99 " << summary.p99 << " ms, max " << summary.max << " ms" << std::endl;
+    }
+
+    for (const std::string& scopeName : GetGpuScopeNames())
+    {
+        Summary summary = SummarizeGpuScope(scopeName);
+        std::cout << "    GPU " << scopeName << ": avg " << summary.average << " ms, p50 " << summary.p50
+            << " ms, p95 " << summary.p95 << " ms, p99 " << summary.p99 << " ms, max " << summary.max << " ms" << std::endl;
+    }
+}
+
+/**
+ * @brief Writes the per-frame measurements and the summaries into a file. Files ending with ".json" are
+ * written as JSON, anything else as CSV.
+ * @param[in] filePath Output file path
+ * @return Returns true if the file was written successfully. Returns false otherwise.
+ */
+bool BenchmarkReport::WriteToFile(const std::string& filePath) const
+{
+    const std::string jsonExtension = ".json";
+    if ((filePath.size() >= jsonExtension.size()) && (filePath.compare(filePath.size() - jsonExtension.size(), jsonExtension.size(), jsonExtension) == 0))
+    {
+        return WriteJSON(filePath);
+    }
+    return WriteCSV(filePath);
+}
+
+/**
+ * @brief Computes a percentile of a set of values using linear interpolation between the closest ranks.
+ * @param[in] values Values. Does not need to be sorted.
+ * @param[in] percentile Percentile to compute, from 0 to 100
+ * @return Value at the percentile. Returns 0 if there are no values.
+ */
+double BenchmarkReport::ComputePercentile(std::vector<double> values, const double& percentile)
+{
+    if (values.empty())
+    {
+        return 0.0;
+    }
+
+    std::sort(values.begin(), values.end());
+    double rank = std::clamp(percentile, 0.0, 100.0) / 100.0 * (values.size() - 1);
+    size_t lowerRank = static_cast<size_t>(std::floor(rank));
+    size_t upperRank = std::min(lowerRank + 1, values.size() - 1);
+    return values[lowerRank] + (values[upperRank] - values[lowerRank]) * (rank - lowerRank);
+}
+
+/**
+ * @brief Summarizes one measured quantity over all frames. Negative values are treated as missing.
+ * @param[in] member Pointer to the measured quantity in FrameSample
+ * @return Summary of the quantity
+ */
+BenchmarkReport::Summary BenchmarkReport::Summarize(double FrameSample::* member) const
+{
+    std::vector<double> values;
+    values.reserve(m_frames.size());
+    for (const FrameSample& frame : m_frames)
+    {
+        if (frame.*member >= 0.0)
+        {
+            values.push_back(frame.*member);
+        }
+    }
+
+    return SummarizeValues(values);
+}
+
+/**
+ * @brief Summarizes the GPU time of one profiled region over all frames. Frames without the region are skipped.
+ * @param[in] scopeName Name of the profiled region
+ * @return Summary of the region's GPU time
+ */
+BenchmarkReport::Summary BenchmarkReport::SummarizeGpuScope(const std::string& scopeName) const
+{
+    std::vector<double> values;
+    values.reserve(m_frames.size());
+    for (const FrameSample& frame : m_frames)
+    {
+        double time = FindGpuScopeTime(frame, scopeName);
+        if (time >= 0.0)
+        {
+            values.push_back(time);
+        }
+    }
+
+    return SummarizeValues(values);
+}
+
+/**
+ * @brief Summarizes a set of values.
+ * @param[in] values Values
+ * @return Summary of the values
+ */
+BenchmarkReport::Summary BenchmarkReport::SummarizeValues(const std::vector<double>& values)
+{
+    Summary summary = {};
+    if (values.empty())
+    {
+        return summary;
+    }
+
+    double total = 0.0;
+    for (double value : values)
+    {
+        total += value;
+    }
+    summary.average = total / values.size();
+    summary.p50 = ComputePercentile(values, 50.0);
+    summary.p95 = ComputePercentile(values, 95.0);
+    summary.p99 = ComputePercentile(values, 99.0);
+    summary.max = *std::max_element(values.begin(), values.end());
+    return summary;
+}
+
+/**
+ * @brief Gets the names of the profiled regions that appear in any frame.
+ * @return Region names, in the order they were first seen
+ */
+std::vector<std::string> BenchmarkReport::GetGpuScopeNames() const
+{
+    std::vector<std::string> scopeNames;
+    for (const FrameSample& frame : m_frames)
+    {
+        for (const std::pair<std::string, double>& scopeTime : frame.gpuScopeTimes)
+        {
+            if (std::find(scopeNames.begin(), scopeNames.end(), scopeTime.first) == scopeNames.end())
+            {
+                scopeNames.push_back(scopeTime.first);
+            }
+        }
+    }
+    return scopeNames;
+}
+
+/**
+ * @brief Finds the GPU time of a profiled region in a frame.
+ * @param[in] frame Frame measurements
+ * @param[in] scopeName Name of the profiled region
+ * @return GPU time of the region (in milliseconds). Returns -1 if the frame does not have the region.
+ */
+double BenchmarkReport::FindGpuScopeTime(const FrameSample& frame, const std::string& scopeName)
+{
+    for (const std::pair<std::string, double>& scopeTime : frame.gpuScopeTimes)
+    {
+        if (scopeTime.first == scopeName)
+        {
+            return scopeTime.second;
+        }
+    }
+    return -1.0;
+}
+
+/**
+ * @brief Escapes a string for use inside a JSON string literal.
+ * @param[in] text Text to escape
+ * @return Escaped text
+ */
+std::string BenchmarkReport::EscapeJSON(const std::string& text)
+{
+    std::string escapedText;
+    for (char c : text)
+    {
+        if ((c == '"') || (c == '\\'))
+        {
+            escapedText += '\\';
+            escapedText += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            // Control characters are not allowed in JSON strings
+            const char* HEX_DIGITS = "0123456789abcdef";
+            escapedText += "\\u00";
+            escapedText += HEX_DIGITS[(c >> 4) & 0xF];
+            escapedText += HEX_DIGITS[c & 0xF];
+        }
+        else
+        {
+            escapedText += c;
+        }
+    }
+    return escapedText;
+}
+
+/**
+ * @brief Writes the report in CSV format.
+ * @param[in] filePath Output file path
+ * @return Returns true if the file was written successfully. Returns false otherwise.
+ */
+bool BenchmarkReport::WriteCSV(const std::string& filePath) const
+{
+    std::ofstream file(filePath);
+    if (file.fail())
+    {
+        std::cout << "Failed to open " << filePath << " for writing!" << std::endl;
+        return false;
+    }
+
+    // Each profiled GPU region gets its own column after the fixed ones
+    std::vector<std::string> scopeNames = GetGpuScopeNames();
+    file << "frame,frameTimeMs,cpuTimeMs,gpuTimeMs,drawCount,triangleCount,droppedDrawCount,allocationCount";
+    for (const std::string& scopeName : scopeNames)
+    {
+        file << ",gpu_" << scopeName << "Ms";
+    }
+    file << std::endl;
+    for (size_t i = 0; i < m_frames.size(); ++i)
+    {
+        const FrameSample& frame = m_frames[i];
+        file << i << "," << frame.frameTime << "," << frame.cpuTime << "," << frame.gpuTime << ","
+            << frame.drawCount << "," << frame.triangleCount << "," << frame.droppedDrawCount << "," << frame.allocationCount;
+        for (const std::string& scopeName : scopeNames)
+        {
+            file << "," << FindGpuScopeTime(frame, scopeName);
+        }
+        file << std::endl;
+    }
+
+    // Summary rows use the statistic name in place of the frame number
+    const std::pair<const char*, double Summary::*> statistics[] =
+    {
+        { "avg", &Summary::average },
+        { "p50", &Summary::p50 },
+        { "p95", &Summary::p95 },
+        { "p99", &Summary::p99 },
+        { "max", &Summary::max }
+    };
+    Summary frameTimeSummary = Summarize(&FrameSample::frameTime);
+    Summary cpuTimeSummary = Summarize(&FrameSample::cpuTime);
+    Summary gpuTimeSummary = Summarize(&FrameSample::gpuTime);
+    std::vector<Summary> scopeSummaries;
+    for (const std::string& scopeName : scopeNames)
+    {
+        scopeSummaries.push_back(SummarizeGpuScope(scopeName));
+    }
+    for (const std::pair<const char*, double Summary::*>& statistic : statistics)
+    {
+        file << statistic.first << "," << frameTimeSummary.*statistic.second << "," << cpuTimeSummary.*statistic.second
+            << "," << gpuTimeSummary.*statistic.second << ",,,,";
+        for (const Summary& scopeSummary : scopeSummaries)
+        {
+            file << "," << scopeSummary.*statistic.second;
+        }
+        file << std::endl;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Writes the report in JSON format.
+ * @param[in] filePath Output file path
+ * @return Returns true if the file was written successfully. Returns false otherwise.
+ */
+bool BenchmarkReport::WriteJSON(const std::string& filePath) const
+{
+    std::ofstream file(filePath);
+    if (file.fail())
+    {
+        std::cout << "Failed to open " << filePath << " for writing!" << std::endl;
+        return false;
+    }
+
+    const std::pair<const char*, double FrameSample::*> quantities[] =
+    {
+        { "frameTimeMs", &FrameSample::frameTime },
+        { "cpuTimeMs", &FrameSample::cpuTime },
+        { "gpuTimeMs", &FrameSample::gpuTime }
+    };
+
+    file << "{" << std::endl;
+    file << "  \"name\": \"" << EscapeJSON(m_name) << "\"," << std::endl;
+    file << "  \"frameCount\": " << m_frames.size() << "," << std::endl;
+    file << "  \"summary\": {" << std::endl;
+    for (size_t i = 0; i < std::size(quantities); ++i)
+    {
+        Summary summary = Summarize(quantities[i].second);
+        file << "    \"" << quantities[i].first << "\": { \"avg\": " << summary.average << ", \"p50\": " << summary.p50
+            << ", \"p95\": " << summary.p95 << ", \"p99\": " << summary.p99 << ", \"max\": " << summary.max << " },"
+            << std::endl;
+    }
+    std::vector<std::string> scopeNames = GetGpuScopeNames();
+    file << "    \"gpuScopesMs\": {" << std::endl;
+    for (size_t i = 0; i < scopeNames.size(); ++i)
+    {
+        Summary summary = SummarizeGpuScope(scopeNames[i]);
+        file << "      \"" << EscapeJSON(scopeNames[i]) << "\": { \"avg\": " << summary.average << ", \"p50\": " << summary.p50
+            << ", \"p95\": " << summary.p95 << ", \"p99\": " << summary.p99 << ", \"max\": " << summary.max << " }"
+            << ((i + 1 < scopeNames.size()) ? "," : "") << std::endl;
+    }
+    file << "    }" << std::endl;
+    file << "  }," << std::endl;
+    file << "  \"frames\": [" << std::endl;
+    for (size_t i = 0; i < m_frames.size(); ++i)
+    {
+        const FrameSample& frame = m_frames[i];
+        file << "    { \"frameTimeMs\": " << frame.frameTime << ", \"cpuTimeMs\": " << frame.cpuTime
+            << ", \"gpuTimeMs\": " << frame.gpuTime << ", \"drawCount\": " << frame.drawCount
+            << ", \"triangleCount\": " << frame.triangleCount << ", \"droppedDrawCount\": " << frame.droppedDrawCount
+            << ", \"allocationCount\": " << frame.allocationCount
+            << ", \"gpuScopesMs\": {";
+        for (size_t j = 0; j < frame.gpuScopeTimes.size(); ++j)
+        {
+            file << ((j > 0) ? ", " : " ") << "\"" << EscapeJSON(frame.gpuScopeTimes[j].first) << "\": " << frame.gpuScopeTimes[j].second;
+        }
+        file << " } }" << ((i + 1 < m_frames.size()) ? "," : "") << std::endl;
+    }
+    file << "  ]" << std::endl;
+    file << "}" << std::endl;
+
+    return true;
+}
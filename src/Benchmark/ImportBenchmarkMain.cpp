@@ -0,0 +1,268 @@
+#include "Benchmark/BenchmarkReport.hpp"
+#include "Benchmark/MemoryTracker.hpp"
+
+#include "Graphics/Model.hpp"
+
+#include <assimp/Importer.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * Struct containing the results of importing one model file
+ */
+struct ImportResult
+{
+    /**
+     * Model file path, relative to the benchmarked directory
+     */
+    std::string filePath;
+
+    /**
+     * Flag indicating whether every import of the file succeeded
+     */
+    bool isSuccessful;
+
+    /**
+     * Number of meshes
+     */
+    size_t numMeshes;
+
+    /**
+     * Number of vertices
+     */
+    uint32_t numVertices;
+
+    /**
+     * Number of triangles
+     */
+    uint32_t numTriangles;
+
+    /**
+     * Median time of each stage over all iterations (in milliseconds)
+     */
+    Model::LoadStatistics medianStatistics;
+
+    /**
+     * Heap allocation counters of the last iteration
+     */
+    MemoryTracker::AllocationCounters allocations;
+
+    /**
+     * Highest peak resident set size over all iterations (in bytes)
+     */
+    uint64_t peakResidentSetSize;
+};
+
+/**
+ * @brief Parses a command line value as an unsigned 32-bit integer.
+ * @param[in] text Value text
+ * @param[out] outValue Parsed value. Left untouched if parsing fails.
+ * @return Returns true if the whole text is a valid unsigned integer that fits in 32 bits. Returns false otherwise.
+ */
+bool ParseUnsigned(const char* text, uint32_t& outValue)
+{
+    // from_chars rejects signs and whitespace, so negative values cannot wrap around
+    const char* end = text + std::strlen(text);
+    uint32_t value = 0;
+    std::from_chars_result result = std::from_chars(text, end, value);
+    if ((result.ec != std::errc()) || (result.ptr != end))
+    {
+        return false;
+    }
+
+    outValue = value;
+    return true;
+}
+
+/**
+ * @brief Imports a model file several times, recording the time spent in each stage and the memory used.
+ * @param[in] filePath Model file path
+ * @param[in] numIterations Number of times to import the file
+ * @param[in] options Import options
+ * @param[out] outResult Import results. The file path is left untouched.
+ */
+void BenchmarkImport(const std::string& filePath, const uint32_t& numIterations, const Model::ImportOptions& options, ImportResult& outResult)
+{
+    double Model::LoadStatistics::* stages[] =
+    {
+        &Model::LoadStatistics::readFileTime,
+        &Model::LoadStatistics::nodeTraversalTime,
+        &Model::LoadStatistics::processMeshTime,
+        &Model::LoadStatistics::texturePathResolutionTime,
+        &Model::LoadStatistics::embeddedTextureWaitTime,
+        &Model::LoadStatistics::textureAtlasPackingTime,
+        &Model::LoadStatistics::materialClassificationTime,
+        &Model::LoadStatistics::totalTime
+    };
+    std::vector<std::vector<double>> stageTimes(std::size(stages));
+
+    outResult.isSuccessful = true;
+    outResult.peakResidentSetSize = 0;
+    for (uint32_t i = 0; i < numIterations; ++i)
+    {
+        MemoryTracker::ResetPeakResidentSetSize();
+        MemoryTracker::ResetAllocationCounters();
+
+        // The model is destroyed inside the measured scope, so that the peak includes the whole import
+        {
+            Model model;
+            outResult.isSuccessful = model.Load(filePath, options) && outResult.isSuccessful;
+
+            for (size_t j = 0; j < std::size(stages); ++j)
+            {
+                stageTimes[j].push_back(model.GetLoadStatistics().*stages[j]);
+            }
+            outResult.numMeshes = model.GetMeshes().size();
+            outResult.numVertices = model.GetTotalVertexCount();
+            outResult.numTriangles = model.GetTotalTriangleCount();
+        }
+
+        outResult.allocations = MemoryTracker::GetAllocationCounters();
+        outResult.peakResidentSetSize = std::max(outResult.peakResidentSetSize, MemoryTracker::GetPeakResidentSetSize());
+    }
+
+    for (size_t j = 0; j < std::size(stages); ++j)
+    {
+        outResult.medianStatistics.*stages[j] = BenchmarkReport::ComputePercentile(stageTimes[j], 50.0);
+    }
+}
+
+/**
+ * @brief Writes the import results into a JSON file.
+ * @param[in] filePath Output file path
+ * @param[in] results Import results
+ * @return Returns true if the file was written successfully. Returns false otherwise.
+ */
+bool WriteResults(const std::string& filePath, const std::vector<ImportResult>& results)
+{
+    std::ofstream file(filePath);
+    if (file.fail())
+    {
+        std::cout << "Failed to open " << filePath << " for writing!" << std::endl;
+        return false;
+    }
+
+    file << "{" << std::endl;
+    file << "  \"files\": [" << std::endl;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const ImportResult& result = results[i];
+        const Model::LoadStatistics& statistics = result.medianStatistics;
+
+        file << "    {" << std::endl;
+        file << "      \"file\": \"" << BenchmarkReport::EscapeJSON(result.filePath) << "\"," << std::endl;
+        file << "      \"success\": " << (result.isSuccessful ? "true" : "false") << "," << std::endl;
+        file << "      \"meshes\": " << result.numMeshes << ", \"vertices\": " << result.numVertices << ", \"triangles\": " << result.numTriangles << "," << std::endl;
+        file << "      \"stagesMs\": { \"readFile\": " << statistics.readFileTime
+            << ", \"nodeTraversal\": " << statistics.nodeTraversalTime
+            << ", \"processMesh\": " << statistics.processMeshTime
+            << ", \"texturePathResolution\": " << statistics.texturePathResolutionTime
+            << ", \"embeddedTextureWait\": " << statistics.embeddedTextureWaitTime
+            << ", \"textureAtlasPacking\": " << statistics.textureAtlasPackingTime
+            << ", \"materialClassification\": " << statistics.materialClassificationTime
+            << ", \"total\": " << statistics.totalTime << " }," << std::endl;
+        file << "      \"allocations\": " << result.allocations.numAllocations
+            << ", \"allocatedBytes\": " << result.allocations.allocatedBytes
+            << ", \"peakHeapBytes\": " << result.allocations.peakBytes
+            << ", \"peakRssBytes\": " << result.peakResidentSetSize << std::endl;
+        file << "    }" << ((i + 1 < results.size()) ? "," : "") << std::endl;
+    }
+    file << "  ]" << std::endl;
+    file << "}" << std::endl;
+
+    return true;
+}
+
+/**
+ * Imports every supported model file in a directory and reports per-stage timings, heap allocations and peak
+ * memory per file, so that results can be compared between builds.
+ */
+int main(int argc, char** argv)
+{
+    std::string directoryPath;
+    std::string outputPath = "import_benchmark.json";
+    uint32_t numIterations = 5;
+    Model::ImportOptions options = {};
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if ((argument == "--iterations") && hasValue)
+        {
+            if (!ParseUnsigned(argv[++i], numIterations) || (numIterations == 0))
+            {
+                std::cout << "Invalid value for " << argument << ": " << argv[i] << std::endl;
+                directoryPath.clear();
+                break;
+            }
+        }
+        else if ((argument == "--output") && hasValue)
+        {
+            outputPath = argv[++i];
+        }
+        else if (argument == "--pack-texture-atlases")
+        {
+            options.packTextureAtlases = true;
+        }
+        else if (directoryPath.empty() && (argument.rfind("--", 0) != 0))
+        {
+            directoryPath = argument;
+        }
+        else
+        {
+            std::cout << "Unknown or incomplete argument: " << argument << std::endl;
+            directoryPath.clear();
+            break;
+        }
+    }
+
+    if (directoryPath.empty() || !std::filesystem::is_directory(directoryPath))
+    {
+        std::cout << "Usage: " << argv[0] << " <model directory> [--iterations <count>] [--output <file.json>] [--pack-texture-atlases]" << std::endl;
+        return 1;
+    }
+
+    // Collect the model files first, sorted so that the output is stable between runs
+    Assimp::Importer importer;
+    std::vector<std::filesystem::path> modelFilePaths;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(directoryPath))
+    {
+        if (entry.is_regular_file() && importer.IsExtensionSupported(entry.path().extension().string()))
+        {
+            modelFilePaths.push_back(entry.path());
+        }
+    }
+    std::sort(modelFilePaths.begin(), modelFilePaths.end());
+
+    std::vector<ImportResult> results(modelFilePaths.size(), ImportResult {});
+    for (size_t i = 0; i < modelFilePaths.size(); ++i)
+    {
+        results[i].filePath = std::filesystem::relative(modelFilePaths[i], directoryPath).generic_string();
+        BenchmarkImport(modelFilePaths[i].string(), numIterations, options, results[i]);
+
+        std::cout << results[i].filePath << ": " << results[i].medianStatistics.totalTime << " ms"
+            << " (read " << results[i].medianStatistics.readFileTime
+            << ", nodes " << results[i].medianStatistics.nodeTraversalTime
+            << ", meshes " << results[i].medianStatistics.processMeshTime
+            << ", texture paths " << results[i].medianStatistics.texturePathResolutionTime << ")"
+            << ", " << results[i].allocations.numAllocations << " allocations"
+            << ", peak heap " << results[i].allocations.peakBytes / (1024 * 1024) << " MiB"
+            << ", peak RSS " << results[i].peakResidentSetSize / (1024 * 1024) << " MiB" << std::endl;
+    }
+
+    if (!WriteResults(outputPath, results))
+    {
+        return 1;
+    }
+
+    return 0;
+}
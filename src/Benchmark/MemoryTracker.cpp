@@ -0,0 +1,162 @@
+#include "Benchmark/MemoryTracker.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <string>
+
+namespace
+{
+    /**
+     * Size of the header placed in front of each allocation to remember its size.
+     * Keeps the returned pointers aligned like the ones returned by malloc.
+     */
+    constexpr size_t ALLOCATION_HEADER_SIZE = alignof(std::max_align_t);
+
+    std::atomic<uint64_t> g_numAllocations(0);
+    std::atomic<uint64_t> g_allocatedBytes(0);
+    std::atomic<uint64_t> g_currentBytes(0);
+    std::atomic<uint64_t> g_peakBytes(0);
+
+    /**
+     * @brief Allocates a block of memory and records it in the counters.
+     * @param[in] size Size of the block in bytes
+     * @return Pointer to the block. Returns nullptr if the allocation failed.
+     */
+    void* TrackedAllocate(size_t size)
+    {
+        void* block = std::malloc(size + ALLOCATION_HEADER_SIZE);
+        if (block == nullptr)
+        {
+            return nullptr;
+        }
+        *static_cast<size_t*>(block) = size;
+
+        g_numAllocations.fetch_add(1, std::memory_order_relaxed);
+        g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        uint64_t currentBytes = g_currentBytes.fetch_add(size, std::memory_order_relaxed) + size;
+        uint64_t peakBytes = g_peakBytes.load(std::memory_order_relaxed);
+        while ((currentBytes > peakBytes) && !g_peakBytes.compare_exchange_weak(peakBytes, currentBytes, std::memory_order_relaxed))
+        {
+        }
+
+        return static_cast<char*>(block) + ALLOCATION_HEADER_SIZE;
+    }
+
+    /**
+     * @brief Frees a block of memory allocated by TrackedAllocate.
+     * @param[in] pointer Pointer to the block
+     */
+    void TrackedFree(void* pointer)
+    {
+        if (pointer == nullptr)
+        {
+            return;
+        }
+
+        void* block = static_cast<char*>(pointer) - ALLOCATION_HEADER_SIZE;
+        g_currentBytes.fetch_sub(*static_cast<size_t*>(block), std::memory_order_relaxed);
+        std::free(block);
+    }
+}
+
+void* operator new(size_t size)
+{
+    void* pointer = TrackedAllocate(size);
+    if (pointer == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    TrackedFree(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    TrackedFree(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    TrackedFree(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+    TrackedFree(pointer);
+}
+
+namespace MemoryTracker
+{
+    /**
+     * @brief Resets the allocation counters. The peak starts from the number of bytes that are currently allocated.
+     */
+    void ResetAllocationCounters()
+    {
+        g_numAllocations.store(0, std::memory_order_relaxed);
+        g_allocatedBytes.store(0, std::memory_order_relaxed);
+        g_peakBytes.store(g_currentBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets the allocation counters accumulated since the last reset.
+     * @return Allocation counters
+     */
+    AllocationCounters GetAllocationCounters()
+    {
+        AllocationCounters counters = {};
+        counters.numAllocations = g_numAllocations.load(std::memory_order_relaxed);
+        counters.allocatedBytes = g_allocatedBytes.load(std::memory_order_relaxed);
+        counters.peakBytes = g_peakBytes.load(std::memory_order_relaxed);
+        return counters;
+    }
+
+    /**
+     * @brief Resets the peak resident set size of the process to its current resident set size.
+     * @return Returns true if the peak was reset. Returns false if the platform does not support it.
+     */
+    bool ResetPeakResidentSetSize()
+    {
+#ifdef __linux__
+        // Writing 5 to clear_refs resets VmHWM (Linux 4.0 and later)
+        std::ofstream clearRefs("/proc/self/clear_refs");
+        clearRefs << "5";
+        return clearRefs.good();
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Gets the peak resident set size of the process since the last reset.
+     * @return Peak resident set size (in bytes). Returns 0 if the platform does not support it.
+     */
+    uint64_t GetPeakResidentSetSize()
+    {
+#ifdef __linux__
+        std::ifstream status("/proc/self/status");
+        std::string key;
+        while (status >> key)
+        {
+            if (key == "VmHWM:")
+            {
+                uint64_t peakKilobytes = 0;
+                status >> peakKilobytes;
+                return peakKilobytes * 1024;
+            }
+        }
+#endif
+        return 0;
+    }
+}
@@ -0,0 +1,42 @@
+#include "Application.hpp"
+
+#include "Benchmark/MemoryTracker.hpp"
+
+#include <iostream>
+
+/**
+ * Renders a model (or a generated synthetic scene) headlessly along a camera path and writes per-frame timings and counters.
+ * Accepts the same arguments as the viewer, with benchmark-friendly defaults.
+ */
+int main(int argc, char** argv)
+{
+    Application::LaunchOptions launchOptions;
+    launchOptions.headless = true;
+    launchOptions.frameCount = 1000;
+    launchOptions.width = 1920;
+    launchOptions.height = 1080;
+    launchOptions.benchmarkOutputPath = "render_benchmark.csv";
+    launchOptions.allocationCounter = []() { return MemoryTracker::GetAllocationCounters().numAllocations; };
+
+    if (!Application::ParseLaunchOptions(argc, argv, launchOptions))
+    {
+        Application::PrintUsage(argv[0]);
+        return 1;
+    }
+
+    if (launchOptions.modelFilePath.empty() && !launchOptions.useSyntheticScene)
+    {
+        std::cout << "No model to benchmark. Specify one with --model <path> or --synthetic-scene <m,t,i,x>." << std::endl;
+        return 1;
+    }
+
+    // Benchmarks always run without a window, so that the results do not depend on the display
+    launchOptions.headless = true;
+
+    {
+        Application application(launchOptions);
+        application.Run();
+    }
+
+    return 0;
+}
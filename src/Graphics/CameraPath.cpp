@@ -0,0 +1,153 @@
+#include "Graphics/CameraPath.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+/**
+ * @brief Constructor
+ */
+CameraPath::CameraPath()
+    : m_keyframes()
+{
+}
+
+/**
+ * @brief Destructor
+ */
+CameraPath::~CameraPath()
+{
+}
+
+/**
+ * @brief Appends the current state of an orbit camera to the end of the path.
+ * @param[in] camera Orbit camera
+ */
+void CameraPath::AddKeyframe(OrbitCamera& camera)
+{
+    Keyframe keyframe = {};
+    keyframe.yaw = camera.GetYaw();
+    keyframe.pitch = camera.GetPitch();
+    keyframe.orbitDistance = camera.GetOrbitDistance();
+    keyframe.lookTarget = camera.GetLookTarget();
+    m_keyframes.push_back(keyframe);
+}
+
+/**
+ * @brief Replaces the path with a procedurally generated orbit: one full turn around the look target
+ * while the pitch and orbit distance sway back and forth.
+ * @param[in] numKeyframes Number of keyframes to generate
+ */
+void CameraPath::GenerateOrbit(const uint32_t& numKeyframes)
+{
+    m_keyframes.clear();
+    m_keyframes.resize(std::max(numKeyframes, 2u));
+    for (size_t i = 0; i < m_keyframes.size(); ++i)
+    {
+        float t = static_cast<float>(i) / (m_keyframes.size() - 1);
+        m_keyframes[i].yaw = 360.0f * t;
+        m_keyframes[i].pitch = 30.0f * glm::sin(glm::radians(720.0f * t));
+        m_keyframes[i].orbitDistance = 3.0f - glm::sin(glm::radians(360.0f * t));
+        m_keyframes[i].lookTarget = glm::vec3(0.0f);
+    }
+}
+
+/**
+ * @brief Applies the state at a point of the path to an orbit camera, interpolating between keyframes.
+ * @param[in] t Point of the path, from 0 (first keyframe) to 1 (last keyframe)
+ * @param[out] outCamera Orbit camera
+ */
+void CameraPath::Apply(const float& t, OrbitCamera& outCamera) const
+{
+    if (m_keyframes.empty())
+    {
+        return;
+    }
+
+    float position = std::clamp(t, 0.0f, 1.0f) * (m_keyframes.size() - 1);
+    size_t index = std::min(static_cast<size_t>(position), m_keyframes.size() - 1);
+    size_t nextIndex = std::min(index + 1, m_keyframes.size() - 1);
+    float blend = position - index;
+
+    const Keyframe& a = m_keyframes[index];
+    const Keyframe& b = m_keyframes[nextIndex];
+    // Turn the shortest way around, so that e.g. going from 170 to -170 degrees crosses 180 instead of 0
+    float yawDifference = std::remainder(b.yaw - a.yaw, 360.0f);
+    outCamera.SetYaw(a.yaw + yawDifference * blend);
+    outCamera.SetPitch(glm::mix(a.pitch, b.pitch, blend));
+    outCamera.SetOrbitDistance(glm::mix(a.orbitDistance, b.orbitDistance, blend));
+    outCamera.SetLookTarget(glm::mix(a.lookTarget, b.lookTarget, blend));
+}
+
+/**
+ * @brief Checks whether the path has no keyframes.
+ * @return Returns true if the path has no keyframes. Returns false otherwise.
+ */
+bool CameraPath::IsEmpty() const
+{
+    return m_keyframes.empty();
+}
+
+/**
+ * @brief Loads a path from a text file with one "yaw pitch orbitDistance lookTargetX lookTargetY lookTargetZ" keyframe per line.
+ * @param[in] filePath File path
+ * @return Returns true if the path was loaded successfully. Returns false otherwise.
+ */
+bool CameraPath::LoadFromFile(const std::string& filePath)
+{
+    std::ifstream file(filePath);
+    if (file.fail())
+    {
+        std::cout << "Failed to open camera path " << filePath << std::endl;
+        return false;
+    }
+
+    std::vector<Keyframe> keyframes;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || (line[0] == '#'))
+        {
+            continue;
+        }
+
+        Keyframe keyframe = {};
+        std::istringstream lineStream(line);
+        if (!(lineStream >> keyframe.yaw >> keyframe.pitch >> keyframe.orbitDistance
+                >> keyframe.lookTarget.x >> keyframe.lookTarget.y >> keyframe.lookTarget.z))
+        {
+            std::cout << "Failed to parse camera path keyframe \"" << line << "\" in " << filePath << std::endl;
+            return false;
+        }
+        keyframes.push_back(keyframe);
+    }
+
+    m_keyframes = std::move(keyframes);
+    return true;
+}
+
+/**
+ * @brief Saves the path into a text file in the format read by LoadFromFile.
+ * @param[in] filePath File path
+ * @return Returns true if the path was saved successfully. Returns false otherwise.
+ */
+bool CameraPath::SaveToFile(const std::string& filePath) const
+{
+    std::ofstream file(filePath);
+    if (file.fail())
+    {
+        std::cout << "Failed to open " << filePath << " for writing!" << std::endl;
+        return false;
+    }
+
+    file << "# yaw pitch orbitDistance lookTargetX lookTargetY lookTargetZ" << std::endl;
+    for (const Keyframe& keyframe : m_keyframes)
+    {
+        file << keyframe.yaw << " " << keyframe.pitch << " " << keyframe.orbitDistance << " "
+            << keyframe.lookTarget.x << " " << keyframe.lookTarget.y << " " << keyframe.lookTarget.z << std::endl;
+    }
+
+    return true;
+}
@@ -0,0 +1,79 @@
+#include "Graphics/FrameArena.hpp"
+
+/**
+ * @brief Constructor
+ */
+FrameArena::FrameArena()
+    : m_block()
+    , m_capacity(0)
+    , m_head(0)
+    , m_overflowBlocks()
+    , m_overflowBytes(0)
+{
+}
+
+/**
+ * @brief Destructor
+ */
+FrameArena::~FrameArena()
+{
+}
+
+/**
+ * @brief Releases all allocations. Grows the block if the previous frame needed overflow blocks.
+ */
+void FrameArena::Reset()
+{
+    if (m_overflowBytes > 0)
+    {
+        // Make room for everything the previous frame allocated, so that a similar frame fits in the block
+        m_capacity += m_overflowBytes;
+        m_block = std::make_unique<uint8_t[]>(m_capacity);
+        m_overflowBlocks.clear();
+        m_overflowBytes = 0;
+    }
+    m_head = 0;
+}
+
+/**
+ * @brief Gets the number of bytes allocated since the last reset, including overflow blocks.
+ * @return Number of allocated bytes
+ */
+size_t FrameArena::GetUsedBytes() const
+{
+    return m_head + m_overflowBytes;
+}
+
+/**
+ * @brief Gets the size of the block.
+ * @return Capacity in bytes
+ */
+size_t FrameArena::GetCapacity() const
+{
+    return m_capacity;
+}
+
+/**
+ * @brief Allocates uninitialized memory.
+ * @param[in] size Size in bytes
+ * @param[in] alignment Required alignment, which must be a power of two
+ * @return Pointer to the memory
+ */
+void* FrameArena::AllocateBytes(const size_t& size, const size_t& alignment)
+{
+    uintptr_t blockAddress = reinterpret_cast<uintptr_t>(m_block.get());
+    uintptr_t address = (blockAddress + m_head + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    if ((m_block != nullptr) && (address + size <= blockAddress + m_capacity))
+    {
+        m_head = address + size - blockAddress;
+        return reinterpret_cast<void*>(address);
+    }
+
+    // Overflow blocks are padded so that any alignment up to the requested one can be honored
+    size_t overflowBlockSize = size + alignment;
+    m_overflowBlocks.push_back(std::make_unique<uint8_t[]>(overflowBlockSize));
+    m_overflowBytes += overflowBlockSize;
+
+    uintptr_t overflowAddress = reinterpret_cast<uintptr_t>(m_overflowBlocks.back().get());
+    return reinterpret_cast<void*>((overflowAddress + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1));
+}
@@ -0,0 +1,300 @@
+#include "Graphics/GpuProfiler.hpp"
+
+#include "Graphics/Vulkan/VulkanContext.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+/**
+ * @brief Constructor
+ */
+GpuProfiler::GpuProfiler()
+    : m_frames()
+    , m_currentFrame(0)
+    , m_openScopes()
+    , m_latestFrame(0)
+    , m_scopeHistories()
+    , m_timestamps()
+    , m_timestampPeriod(1.0)
+    , m_timestampMask(~0ull)
+{
+}
+
+/**
+ * @brief Destructor
+ */
+GpuProfiler::~GpuProfiler()
+{
+}
+
+/**
+ * @brief Creates one query pool per frame in flight. If the device does not support timestamps,
+ * no query pool is created and scopes are ignored.
+ * @param[in] numFramesInFlight Number of frames in flight
+ * @return Returns true if the initialization was successful. Returns false otherwise.
+ */
+bool GpuProfiler::Initialize(const uint32_t& numFramesInFlight)
+{
+    m_frames.resize(numFramesInFlight);
+    for (FrameQueries& frame : m_frames)
+    {
+        frame.queryPool = VK_NULL_HANDLE;
+        frame.hasPendingResults = false;
+    }
+    m_openScopes.clear();
+    m_latestFrame = 0;
+    m_timestamps.assign(MAX_SCOPES * 2, 0);
+
+    VkPhysicalDeviceProperties physicalDeviceProperties;
+    vkGetPhysicalDeviceProperties(VulkanContext::GetPhysicalDevice(), &physicalDeviceProperties);
+
+    uint32_t numQueueFamilies = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(VulkanContext::GetPhysicalDevice(), &numQueueFamilies, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(numQueueFamilies);
+    vkGetPhysicalDeviceQueueFamilyProperties(VulkanContext::GetPhysicalDevice(), &numQueueFamilies, queueFamilies.data());
+    uint32_t timestampValidBits = queueFamilies[VulkanContext::GetGraphicsQueueIndex()].timestampValidBits;
+
+    if (!physicalDeviceProperties.limits.timestampComputeAndGraphics || (timestampValidBits == 0))
+    {
+        std::cout << "Timestamp queries are not supported. GPU times will not be available." << std::endl;
+        return true;
+    }
+    m_timestampPeriod = physicalDeviceProperties.limits.timestampPeriod;
+    m_timestampMask = (timestampValidBits >= 64) ? ~0ull : ((1ull << timestampValidBits) - 1);
+
+    // Two timestamps (start and end) per scope
+    VkQueryPoolCreateInfo queryPoolCreateInfo = {};
+    queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolCreateInfo.queryCount = MAX_SCOPES * 2;
+
+    for (FrameQueries& frame : m_frames)
+    {
+        if (vkCreateQueryPool(VulkanContext::GetLogicalDevice(), &queryPoolCreateInfo, nullptr, &frame.queryPool) != VK_SUCCESS)
+        {
+            std::cout << "Failed to create timestamp query pool!" << std::endl;
+            Cleanup();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Checks whether the device supports timestamps.
+ * @return Returns true if timestamps are supported. Returns false otherwise.
+ */
+bool GpuProfiler::IsSupported() const
+{
+    return !m_frames.empty() && (m_frames[0].queryPool != VK_NULL_HANDLE);
+}
+
+/**
+ * @brief Reads back the results of the previous use of a frame in flight and resets its queries.
+ * Must be called right after beginning the frame's command buffer, once its fence has been waited on.
+ * @param[in] commandBuffer Command buffer of the frame
+ * @param[in] frameIndex Index of the frame in flight
+ */
+void GpuProfiler::BeginFrame(VkCommandBuffer commandBuffer, const uint32_t& frameIndex)
+{
+    m_currentFrame = frameIndex;
+    m_openScopes.clear();
+    if (!IsSupported())
+    {
+        return;
+    }
+
+    CollectResults(frameIndex);
+
+    FrameQueries& frame = m_frames[frameIndex];
+    frame.scopes.clear();
+    vkCmdResetQueryPool(commandBuffer, frame.queryPool, 0, MAX_SCOPES * 2);
+}
+
+/**
+ * @brief Writes the start timestamp of a scope. Scopes can be nested.
+ * @param[in] commandBuffer Command buffer of the frame
+ * @param[in] name Scope name. Only the pointer is stored, so it must stay valid until the frame is collected
+ * (e.g., a string literal).
+ * @return Index of the scope, to pass to EndScope
+ */
+uint32_t GpuProfiler::BeginScope(VkCommandBuffer commandBuffer, const char* name)
+{
+    if (!IsSupported() || (m_frames[m_currentFrame].scopes.size() >= MAX_SCOPES))
+    {
+        return MAX_SCOPES;
+    }
+
+    FrameQueries& frame = m_frames[m_currentFrame];
+    uint32_t scopeIndex = static_cast<uint32_t>(frame.scopes.size());
+    frame.scopes.push_back({ name, static_cast<uint32_t>(m_openScopes.size()) });
+    m_openScopes.push_back(scopeIndex);
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.queryPool, scopeIndex * 2);
+    return scopeIndex;
+}
+
+/**
+ * @brief Writes the end timestamp of a scope.
+ * @param[in] commandBuffer Command buffer of the frame
+ * @param[in] scopeIndex Index returned by BeginScope
+ */
+void GpuProfiler::EndScope(VkCommandBuffer commandBuffer, const uint32_t& scopeIndex)
+{
+    if (!IsSupported() || (scopeIndex >= MAX_SCOPES))
+    {
+        return;
+    }
+
+    FrameQueries& frame = m_frames[m_currentFrame];
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.queryPool, scopeIndex * 2 + 1);
+    frame.hasPendingResults = true;
+
+    if (!m_openScopes.empty() && (m_openScopes.back() == scopeIndex))
+    {
+        m_openScopes.pop_back();
+    }
+}
+
+/**
+ * @brief Reads back the results of a frame in flight without waiting. Called by BeginFrame, and can be called
+ * directly once the device is idle to collect the frames that are still in flight.
+ * @param[in] frameIndex Index of the frame in flight
+ * @return Returns true if new results were read. Returns false otherwise.
+ */
+bool GpuProfiler::CollectResults(const uint32_t& frameIndex)
+{
+    if (!IsSupported())
+    {
+        return false;
+    }
+
+    FrameQueries& frame = m_frames[frameIndex];
+    if (!frame.hasPendingResults || frame.scopes.empty())
+    {
+        return false;
+    }
+    frame.hasPendingResults = false;
+
+    // No VK_QUERY_RESULT_WAIT_BIT: if the results are somehow not ready, the frame is skipped rather than stalling
+    uint32_t numQueries = static_cast<uint32_t>(frame.scopes.size()) * 2;
+    if (vkGetQueryPoolResults(VulkanContext::GetLogicalDevice(), frame.queryPool, 0, numQueries, numQueries * sizeof(uint64_t),
+            m_timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    // The scopes of a frame rarely change, so the history of each scope is only looked up when its name changes
+    size_t numPreviousTimings = frame.timings.size();
+    frame.timings.resize(frame.scopes.size());
+    frame.historyIndices.resize(frame.scopes.size());
+    for (size_t i = 0; i < frame.scopes.size(); ++i)
+    {
+        uint64_t startTimestamp = m_timestamps[i * 2] & m_timestampMask;
+        uint64_t endTimestamp = m_timestamps[i * 2 + 1] & m_timestampMask;
+        uint64_t numTicks = (endTimestamp - startTimestamp) & m_timestampMask;
+
+        if ((i >= numPreviousTimings) || (frame.timings[i].name != frame.scopes[i].name))
+        {
+            frame.timings[i].name = frame.scopes[i].name;
+            frame.historyIndices[i] = FindScopeHistory(frame.scopes[i].name);
+        }
+        frame.timings[i].depth = frame.scopes[i].depth;
+        frame.timings[i].time = numTicks * m_timestampPeriod / 1000000.0;
+    }
+
+    m_latestFrame = frameIndex;
+    AddToHistory(frame.timings, frame.historyIndices);
+    return true;
+}
+
+/**
+ * @brief Gets the scope times of the last collected use of a frame in flight.
+ * @param[in] frameIndex Index of the frame in flight
+ * @return Scope times, in the order the scopes began
+ */
+const std::vector<GpuProfiler::ScopeTiming>& GpuProfiler::GetFrameTimings(const uint32_t& frameIndex) const
+{
+    return m_frames[frameIndex].timings;
+}
+
+/**
+ * @brief Gets the scope times of the most recently collected frame.
+ * @return Scope times, in the order the scopes began
+ */
+const std::vector<GpuProfiler::ScopeTiming>& GpuProfiler::GetLatestTimings() const
+{
+    return m_frames[m_latestFrame].timings;
+}
+
+/**
+ * @brief Gets the recent times of every scope seen so far.
+ * @return Scope histories, in the order the scopes were first seen
+ */
+const std::vector<GpuProfiler::ScopeHistory>& GpuProfiler::GetScopeHistories() const
+{
+    return m_scopeHistories;
+}
+
+/**
+ * @brief Destroys the query pools.
+ */
+void GpuProfiler::Cleanup()
+{
+    for (FrameQueries& frame : m_frames)
+    {
+        if (frame.queryPool != VK_NULL_HANDLE)
+        {
+            vkDestroyQueryPool(VulkanContext::GetLogicalDevice(), frame.queryPool, nullptr);
+            frame.queryPool = VK_NULL_HANDLE;
+        }
+    }
+    m_frames.clear();
+    m_openScopes.clear();
+}
+
+/**
+ * @brief Finds the history of a scope, adding an empty one if the scope has not been seen before.
+ * @param[in] name Scope name
+ * @return Index of the scope history
+ */
+uint32_t GpuProfiler::FindScopeHistory(const std::string& name)
+{
+    for (size_t i = 0; i < m_scopeHistories.size(); ++i)
+    {
+        if (m_scopeHistories[i].name == name)
+        {
+            return static_cast<uint32_t>(i);
+        }
+    }
+
+    m_scopeHistories.push_back({ name, std::vector<float>(HISTORY_LENGTH, 0.0f), 0, 0, 0.0f });
+    return static_cast<uint32_t>(m_scopeHistories.size()) - 1;
+}
+
+/**
+ * @brief Adds the scope times of a collected frame to the scope histories.
+ * @param[in] timings Scope times
+ * @param[in] historyIndices Index of the history of each scope
+ */
+void GpuProfiler::AddToHistory(const std::vector<ScopeTiming>& timings, const std::vector<uint32_t>& historyIndices)
+{
+    for (size_t i = 0; i < timings.size(); ++i)
+    {
+        ScopeHistory* history = &m_scopeHistories[historyIndices[i]];
+        const ScopeTiming& timing = timings[i];
+
+        history->times[history->offset] = static_cast<float>(timing.time);
+        history->offset = (history->offset + 1) % HISTORY_LENGTH;
+        history->numTimes = std::min(history->numTimes + 1, HISTORY_LENGTH);
+
+        // Until the ring buffer is full, only the recorded times count towards the average
+        float total = 0.0f;
+        for (float time : history->times)
+        {
+            total += time;
+        }
+        history->average = total / history->numTimes;
+    }
+}
@@ -1,17 +1,34 @@
 #include "Graphics/Model.hpp"
 
+#include "Graphics/TextureStreamer.hpp"
+#include "IO/FileIO.hpp"
+
+#include "Profiling/CpuProfiler.hpp"
+
 #include <assimp/Importer.hpp>
 #include <assimp/material.h>
 #include <assimp/postprocess.h>
 
+#include <stbi/stb_image.h>
+
+#include <algorithm>
 #include <filesystem>
+#include <future>
 #include <iostream>
+#include <unordered_set>
 
 /**
  * @brief Constructor
  */
 Model::Model()
     : m_meshes()
+    , m_embeddedTextures()
+    , m_numTextureAtlases(0)
+    , m_numAtlasPackedTextures(0)
+    , m_totalVertexCount(0)
+    , m_totalTriangleCount(0)
+    , m_loadStatistics()
+    , m_textureTransparency()
 {
 }
 
@@ -26,14 +43,26 @@ Model::~Model()
 /**
  * @brief Loads the 3D model located in the specified file path.
  * @param[in] modelFilePath Model file path
+ * @param[in] options Import options
  * @return Returns true if the operation was successful. Returns false otherwise.
  */
-bool Model::Load(const std::string& modelFilePath)
+bool Model::Load(const std::string& modelFilePath, const ImportOptions& options)
 {
+    PROFILE_FUNCTION();
+
     Cleanup();
+    m_loadStatistics = {};
+
+    std::chrono::steady_clock::time_point loadStartTime = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point stageStartTime = loadStartTime;
     
     Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(modelFilePath.c_str(), aiProcess_PreTransformVertices | aiProcess_Triangulate | aiProcess_FlipUVs);
+    const aiScene* scene = nullptr;
+    {
+        PROFILE_ZONE("Assimp::Importer::ReadFile");
+        scene = importer.ReadFile(modelFilePath.c_str(), aiProcess_PreTransformVertices | aiProcess_Triangulate | aiProcess_FlipUVs);
+    }
+    m_loadStatistics.readFileTime = GetElapsedMilliseconds(stageStartTime);
 
     if ((scene == nullptr) || (scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) || (scene->mRootNode == nullptr))
     {
@@ -41,33 +70,96 @@ bool Model::Load(const std::string& modelFilePath)
         return false;
     }
 
+    // Take ownership of the scene, so that embedded texture data can outlive the importer
+    std::shared_ptr<const aiScene> sceneOwner(importer.GetOrphanedScene());
+
     std::filesystem::path modelDirPath = modelFilePath;
     modelDirPath = modelDirPath.make_preferred();
     modelDirPath = modelDirPath.remove_filename();
 
     std::cout << "Model directory: " << modelDirPath << std::endl;
 
+    // Decode embedded textures in the background while the meshes are being processed
+    std::vector<std::future<ImageData>> embeddedTextureFutures;
+    for (unsigned int i = 0; i < scene->mNumTextures; ++i)
+    {
+        embeddedTextureFutures.push_back(std::async(std::launch::async, &Model::DecodeEmbeddedTexture, sceneOwner, scene->mTextures[i]));
+    }
+
+    stageStartTime = std::chrono::steady_clock::now();
     ProcessNode(scene->mRootNode, scene);
+    m_loadStatistics.nodeTraversalTime = GetElapsedMilliseconds(stageStartTime) - m_loadStatistics.processMeshTime;
 
+    stageStartTime = std::chrono::steady_clock::now();
     for (size_t i = 0; i < m_meshes.size(); ++i)
     {
         for (size_t j = 0; j < m_meshes[i]->diffuseMapFilePaths.size(); ++j)
         {
-            std::filesystem::path diffuseMapFilePath = modelDirPath / m_meshes[i]->diffuseMapFilePaths[j];
-            m_meshes[i]->diffuseMapFilePaths[j] = diffuseMapFilePath.string();
+            m_meshes[i]->diffuseMapFilePaths[j] = ResolveTexturePath(m_meshes[i]->diffuseMapFilePaths[j], scene, modelFilePath, modelDirPath.string());
             std::cout << "Diffuse Texture " << j << ": " << m_meshes[i]->diffuseMapFilePaths[j] << std::endl;
         }
         for (size_t j = 0; j < m_meshes[i]->emissiveMapFilePaths.size(); ++j)
         {
-            std::filesystem::path emissiveMapFilePath = modelDirPath / m_meshes[i]->emissiveMapFilePaths[j];
-            m_meshes[i]->emissiveMapFilePaths[j] = emissiveMapFilePath.string();
+            m_meshes[i]->emissiveMapFilePaths[j] = ResolveTexturePath(m_meshes[i]->emissiveMapFilePaths[j], scene, modelFilePath, modelDirPath.string());
             std::cout << "Emissive Texture " << j << ": " << m_meshes[i]->emissiveMapFilePaths[j] << std::endl;
         }
     }
 
+    m_loadStatistics.texturePathResolutionTime = GetElapsedMilliseconds(stageStartTime);
+
+    stageStartTime = std::chrono::steady_clock::now();
+    {
+        PROFILE_ZONE("WaitForEmbeddedTextures");
+        for (size_t i = 0; i < embeddedTextureFutures.size(); ++i)
+        {
+            ImageData image = embeddedTextureFutures[i].get();
+            if (image.pixels != nullptr)
+            {
+                m_embeddedTextures[modelFilePath + "*" + std::to_string(i)] = image;
+            }
+        }
+    }
+
+    m_loadStatistics.embeddedTextureWaitTime = GetElapsedMilliseconds(stageStartTime);
+
+    if (options.packTextureAtlases)
+    {
+        stageStartTime = std::chrono::steady_clock::now();
+        PackTextureAtlases(modelFilePath);
+        m_loadStatistics.textureAtlasPackingTime = GetElapsedMilliseconds(stageStartTime);
+    }
+
+    stageStartTime = std::chrono::steady_clock::now();
+    ClassifyMaterials();
+    m_loadStatistics.materialClassificationTime = GetElapsedMilliseconds(stageStartTime);
+
+    m_loadStatistics.totalTime = GetElapsedMilliseconds(loadStartTime);
+
     return true;
 }
 
+/**
+ * @brief Adds a mesh that was built in memory rather than imported. The model takes ownership of the mesh.
+ * @param[in] mesh Mesh
+ */
+void Model::AddMesh(Mesh* mesh)
+{
+    m_meshes.push_back(mesh);
+    m_totalVertexCount += static_cast<uint32_t>(mesh->vertices.size());
+    m_totalTriangleCount += static_cast<uint32_t>(mesh->indices.size() / 3);
+}
+
+/**
+ * @brief Adds a texture that was built in memory rather than imported. Meshes refer to it by its key,
+ * the same way as textures embedded in a model file.
+ * @param[in] textureKey Texture key
+ * @param[in] image Decoded image
+ */
+void Model::AddEmbeddedTexture(const std::string& textureKey, const ImageData& image)
+{
+    m_embeddedTextures[textureKey] = image;
+}
+
 /**
  * @brief Gets all the meshes in the model.
  * @return Model meshes
@@ -83,12 +175,7 @@ const std::vector<Mesh*>& Model::GetMeshes() const
  */
 uint32_t Model::GetTotalVertexCount() const
 {
-    uint32_t ret = 0;
-    for (size_t i = 0; i < m_meshes.size(); ++i)
-    {
-        ret += m_meshes[i]->vertices.size();
-    }
-    return ret;
+    return m_totalVertexCount;
 }
 
 /**
@@ -97,13 +184,49 @@ uint32_t Model::GetTotalVertexCount() const
  */
 uint32_t Model::GetTotalTriangleCount() const
 {
-    uint32_t ret = 0;
-    for (size_t i = 0; i < m_meshes.size(); ++i)
+    return m_totalTriangleCount;
+}
+
+/**
+ * @brief Gets the decoded pixels of a texture embedded in the model file.
+ * @param[in] textureKey Texture key, as stored in the mesh texture paths
+ * @return Pointer to the embedded texture image. Returns nullptr if the key does not refer to an embedded texture.
+ */
+const ImageData* Model::GetEmbeddedTexture(const std::string& textureKey) const
+{
+    std::unordered_map<std::string, ImageData>::const_iterator it = m_embeddedTextures.find(textureKey);
+    if (it == m_embeddedTextures.end())
     {
-        ret += m_meshes[i]->indices.size();
+        return nullptr;
     }
-    ret /= 3;
-    return ret;
+    return &it->second;
+}
+
+/**
+ * @brief Gets the number of texture atlases created during the import.
+ * @return Texture atlas count
+ */
+uint32_t Model::GetTextureAtlasCount() const
+{
+    return m_numTextureAtlases;
+}
+
+/**
+ * @brief Gets the number of textures that were packed into texture atlases during the import.
+ * @return Packed texture count
+ */
+uint32_t Model::GetAtlasPackedTextureCount() const
+{
+    return m_numAtlasPackedTextures;
+}
+
+/**
+ * @brief Gets the time spent in each stage of the last import.
+ * @return Load statistics
+ */
+const Model::LoadStatistics& Model::GetLoadStatistics() const
+{
+    return m_loadStatistics;
 }
 
 /**
@@ -118,9 +241,11 @@ void Model::ProcessNode(aiNode* node, const aiScene* scene)
         unsigned int nodeMeshIndex = node->mMeshes[i];
         aiMesh* assimpMesh = scene->mMeshes[nodeMeshIndex];
 
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
         Mesh* mesh = new Mesh();
         ProcessMesh(assimpMesh, scene, mesh);
-        m_meshes.push_back(mesh);
+        AddMesh(mesh);
+        m_loadStatistics.processMeshTime += GetElapsedMilliseconds(startTime);
     }
 
     // Recurse through child nodes
@@ -138,6 +263,11 @@ void Model::ProcessNode(aiNode* node, const aiScene* scene)
  */
 void Model::ProcessMesh(aiMesh* mesh, const aiScene* scene, Mesh* outMesh)
 {
+    PROFILE_FUNCTION();
+
+    glm::vec3 boundsMin(0.0f);
+    glm::vec3 boundsMax(0.0f);
+
     outMesh->vertices.clear();
     for (unsigned int i = 0; i < mesh->mNumVertices; ++i)
     {
@@ -150,6 +280,9 @@ void Model::ProcessMesh(aiMesh* mesh, const aiScene* scene, Mesh* outMesh)
             mesh->mVertices[i].z
         );
 
+        boundsMin = (i == 0) ? vertex.position : glm::min(boundsMin, vertex.position);
+        boundsMax = (i == 0) ? vertex.position : glm::max(boundsMax, vertex.position);
+
         vertex.color = glm::vec4(
             1.0f, 1.0f, 1.0f, 1.0f
         );
@@ -163,6 +296,10 @@ void Model::ProcessMesh(aiMesh* mesh, const aiScene* scene, Mesh* outMesh)
         }
     }
 
+    // Bounding sphere, used to estimate how large the mesh appears on screen
+    outMesh->boundsCenter = (boundsMin + boundsMax) * 0.5f;
+    outMesh->boundsRadius = glm::length(boundsMax - boundsMin) * 0.5f;
+
     outMesh->indices.clear();
     for (unsigned int i = 0; i < mesh->mNumFaces; ++i)
     {
@@ -198,6 +335,399 @@ void Model::ProcessMesh(aiMesh* mesh, const aiScene* scene, Mesh* outMesh)
     }
 }
 
+/**
+ * @brief Resolves a material texture path to the key used to load the texture.
+ * @param[in] texturePath Texture path as stored in the material
+ * @param[in] scene Assimp scene
+ * @param[in] modelFilePath Model file path
+ * @param[in] modelDirPath Directory containing the model file
+ * @return Unique key of the embedded texture if the path refers to one. File path of the texture otherwise.
+ */
+std::string Model::ResolveTexturePath(const std::string& texturePath, const aiScene* scene, const std::string& modelFilePath, const std::string& modelDirPath)
+{
+    // Embedded textures are referenced either as "*<index>" or by their original file name.
+    // Both forms map to the same key, so that the texture is only loaded once.
+    std::pair<const aiTexture*, int> embeddedTexture = scene->GetEmbeddedTextureAndIndex(texturePath.c_str());
+    if (embeddedTexture.first != nullptr)
+    {
+        return modelFilePath + "*" + std::to_string(embeddedTexture.second);
+    }
+
+    std::filesystem::path textureFilePath = std::filesystem::path(modelDirPath) / texturePath;
+    return textureFilePath.string();
+}
+
+/**
+ * @brief Decodes a texture that is embedded in the model file.
+ * @param[in] scene Assimp scene that owns the embedded texture
+ * @param[in] texture Embedded texture
+ * @return Decoded image. The pixel pointer is null if decoding failed.
+ */
+ImageData Model::DecodeEmbeddedTexture(std::shared_ptr<const aiScene> scene, const aiTexture* texture)
+{
+    PROFILE_FUNCTION();
+
+    ImageData ret = {};
+
+    if (texture->mHeight == 0)
+    {
+        // Compressed image (PNG, JPEG, ...). mWidth is the size of the buffer in bytes. Decode straight from the Assimp buffer.
+        if (!TextureStreamer::DecodeImageFile(reinterpret_cast<const uint8_t*>(texture->pcData), texture->mWidth, ret))
+        {
+            std::cout << "Failed to decode embedded texture " << texture->mFilename.C_Str() << " (" << texture->achFormatHint << ")" << std::endl;
+            return {};
+        }
+    }
+    else
+    {
+        // Raw BGRA8 texels. Reference them in place, keeping the scene alive for as long as the pixels are in use.
+        ret.width = texture->mWidth;
+        ret.height = texture->mHeight;
+        ret.numChannels = 4;
+        ret.bytesPerChannel = 1;
+        ret.isBGRA = true;
+        ret.pixels = std::shared_ptr<const uint8_t>(scene, reinterpret_cast<const uint8_t*>(texture->pcData));
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Packs small diffuse textures into texture atlases, and remaps the UVs of the meshes using them.
+ * Only textures that are sampled within [0, 1] by meshes without an emissive map are packed.
+ * @param[in] modelFilePath Model file path, used to build the keys of the atlases
+ */
+void Model::PackTextureAtlases(const std::string& modelFilePath)
+{
+    PROFILE_FUNCTION();
+
+    // --- Find the textures that can be moved into an atlas ---
+    // Repeating textures cannot be packed, and neither can textures whose meshes also sample an emissive map
+    // with the same UVs, or textures that are used as emissive maps themselves.
+    std::unordered_map<std::string, std::vector<Mesh*>> candidateMeshes;
+    std::unordered_set<std::string> rejectedTextures;
+    for (size_t i = 0; i < m_meshes.size(); ++i)
+    {
+        Mesh* mesh = m_meshes[i];
+        rejectedTextures.insert(mesh->emissiveMapFilePaths.begin(), mesh->emissiveMapFilePaths.end());
+        if (mesh->diffuseMapFilePaths.empty())
+        {
+            continue;
+        }
+
+        const std::string& textureKey = mesh->diffuseMapFilePaths[0];
+        if (!mesh->emissiveMapFilePaths.empty() || !AreTextureCoordinatesNormalized(mesh))
+        {
+            rejectedTextures.insert(textureKey);
+            continue;
+        }
+        candidateMeshes[textureKey].push_back(mesh);
+    }
+
+    // --- Decode the small textures in parallel ---
+    struct AtlasTile
+    {
+        std::string textureKey;
+        ImageData image;
+        std::future<ImageData> future;
+        uint32_t page, x, y, width, height;
+    };
+
+    std::vector<AtlasTile> tiles;
+    for (const std::pair<const std::string, std::vector<Mesh*>>& pair : candidateMeshes)
+    {
+        if (rejectedTextures.find(pair.first) != rejectedTextures.end())
+        {
+            continue;
+        }
+
+        AtlasTile tile = {};
+        tile.textureKey = pair.first;
+
+        const ImageData* embeddedTexture = GetEmbeddedTexture(pair.first);
+        if (embeddedTexture != nullptr)
+        {
+            tile.image = *embeddedTexture;
+            if ((tile.image.width > TEXTURE_ATLAS_MAX_TILE_SIZE) || (tile.image.height > TEXTURE_ATLAS_MAX_TILE_SIZE))
+            {
+                continue;
+            }
+        }
+        else
+        {
+            // Only read the header to check the size, and leave large textures to the streamer
+            int width, height, numChannels;
+            if (!stbi_info(pair.first.c_str(), &width, &height, &numChannels)
+                || (static_cast<uint32_t>(width) > TEXTURE_ATLAS_MAX_TILE_SIZE) || (static_cast<uint32_t>(height) > TEXTURE_ATLAS_MAX_TILE_SIZE))
+            {
+                continue;
+            }
+            tile.future = std::async(std::launch::async, &Model::LoadImageFile, pair.first);
+        }
+        tiles.push_back(std::move(tile));
+    }
+
+    for (size_t i = 0; i < tiles.size(); ++i)
+    {
+        if (tiles[i].future.valid())
+        {
+            tiles[i].image = tiles[i].future.get();
+        }
+    }
+    tiles.erase(std::remove_if(tiles.begin(), tiles.end(), [](const AtlasTile& tile) { return tile.image.pixels == nullptr; }), tiles.end());
+
+    // --- Place the tiles on shelves, tallest first ---
+    // Tiles are aligned so that each mip level of the atlas still has whole tiles and at least one pixel of padding
+    const uint32_t alignment = 1u << (TEXTURE_ATLAS_MAX_MIP_LEVELS - 1);
+    std::sort(tiles.begin(), tiles.end(), [](const AtlasTile& a, const AtlasTile& b) { return a.image.height > b.image.height; });
+
+    std::vector<uint32_t> pageWidths(1, 0), pageHeights(1, 0), pageTileCounts(1, 0);
+    uint32_t shelfX = 0, shelfY = 0, shelfHeight = 0;
+    for (size_t i = 0; i < tiles.size(); ++i)
+    {
+        AtlasTile& tile = tiles[i];
+        tile.width = (tile.image.width + TEXTURE_ATLAS_PADDING * 2 + alignment - 1) / alignment * alignment;
+        tile.height = (tile.image.height + TEXTURE_ATLAS_PADDING * 2 + alignment - 1) / alignment * alignment;
+
+        if (shelfX + tile.width > TEXTURE_ATLAS_SIZE)
+        {
+            // Start a new shelf
+            shelfX = 0;
+            shelfY += shelfHeight;
+            shelfHeight = 0;
+        }
+        if (shelfY + tile.height > TEXTURE_ATLAS_SIZE)
+        {
+            // Start a new atlas
+            pageWidths.push_back(0);
+            pageHeights.push_back(0);
+            pageTileCounts.push_back(0);
+            shelfX = 0;
+            shelfY = 0;
+            shelfHeight = 0;
+        }
+
+        tile.page = static_cast<uint32_t>(pageWidths.size()) - 1;
+        tile.x = shelfX;
+        tile.y = shelfY;
+        shelfX += tile.width;
+        shelfHeight = std::max(shelfHeight, tile.height);
+
+        pageWidths[tile.page] = std::max(pageWidths[tile.page], tile.x + tile.width);
+        pageHeights[tile.page] = std::max(pageHeights[tile.page], tile.y + tile.height);
+        ++pageTileCounts[tile.page];
+    }
+
+    // --- Copy the tiles into the atlases, replicating their edges into the padding ---
+    std::vector<std::shared_ptr<uint8_t>> pagePixels(pageWidths.size());
+    for (size_t i = 0; i < pageWidths.size(); ++i)
+    {
+        // An atlas holding a single texture would not save anything
+        if (pageTileCounts[i] > 1)
+        {
+            pagePixels[i] = std::shared_ptr<uint8_t>(new uint8_t[static_cast<size_t>(pageWidths[i]) * pageHeights[i] * 4](), std::default_delete<uint8_t[]>());
+        }
+    }
+
+    for (size_t i = 0; i < tiles.size(); ++i)
+    {
+        const AtlasTile& tile = tiles[i];
+        if (pagePixels[tile.page] == nullptr)
+        {
+            continue;
+        }
+
+        uint8_t* pixels = pagePixels[tile.page].get();
+        const uint32_t pageWidth = pageWidths[tile.page];
+        for (uint32_t y = 0; y < tile.height; ++y)
+        {
+            uint32_t srcY = static_cast<uint32_t>(std::clamp(static_cast<int>(y) - static_cast<int>(TEXTURE_ATLAS_PADDING), 0, static_cast<int>(tile.image.height) - 1));
+            for (uint32_t x = 0; x < tile.width; ++x)
+            {
+                uint32_t srcX = static_cast<uint32_t>(std::clamp(static_cast<int>(x) - static_cast<int>(TEXTURE_ATLAS_PADDING), 0, static_cast<int>(tile.image.width) - 1));
+                ReadPixelRGBA8(tile.image, srcX, srcY, pixels + (static_cast<size_t>(tile.y + y) * pageWidth + tile.x + x) * 4);
+            }
+        }
+
+        // Remap the UVs of the meshes into the tile
+        const std::string atlasKey = modelFilePath + "*atlas" + std::to_string(tile.page);
+        glm::vec2 uvOffset(static_cast<float>(tile.x + TEXTURE_ATLAS_PADDING) / pageWidth, static_cast<float>(tile.y + TEXTURE_ATLAS_PADDING) / pageHeights[tile.page]);
+        glm::vec2 uvScale(static_cast<float>(tile.image.width) / pageWidth, static_cast<float>(tile.image.height) / pageHeights[tile.page]);
+        std::vector<Mesh*>& meshes = candidateMeshes[tile.textureKey];
+        for (size_t j = 0; j < meshes.size(); ++j)
+        {
+            for (size_t k = 0; k < meshes[j]->vertices.size(); ++k)
+            {
+                meshes[j]->vertices[k].uv = uvOffset + meshes[j]->vertices[k].uv * uvScale;
+            }
+            meshes[j]->diffuseMapFilePaths[0] = atlasKey;
+        }
+
+        // Packed embedded textures are no longer referenced by any mesh
+        m_embeddedTextures.erase(tile.textureKey);
+        ++m_numAtlasPackedTextures;
+    }
+
+    for (size_t i = 0; i < pagePixels.size(); ++i)
+    {
+        if (pagePixels[i] == nullptr)
+        {
+            continue;
+        }
+
+        ImageData atlas = {};
+        atlas.width = pageWidths[i];
+        atlas.height = pageHeights[i];
+        atlas.numChannels = 4;
+        atlas.bytesPerChannel = 1;
+        atlas.isBGRA = false;
+        atlas.maxMipLevels = TEXTURE_ATLAS_MAX_MIP_LEVELS;
+        atlas.pixels = pagePixels[i];
+        m_embeddedTextures[modelFilePath + "*atlas" + std::to_string(i)] = atlas;
+        ++m_numTextureAtlases;
+
+        std::cout << "Texture atlas " << i << ": " << atlas.width << "x" << atlas.height << std::endl;
+    }
+}
+
+/**
+ * @brief Decodes an image file for packing into a texture atlas.
+ * @param[in] filePath Image file path
+ * @return Decoded image. The pixel pointer is null if decoding failed.
+ */
+ImageData Model::LoadImageFile(const std::string& filePath)
+{
+    ImageData ret = {};
+
+    std::vector<char> fileContents;
+    if (!FileIO::ReadFileAsBinary(filePath, fileContents)
+        || !TextureStreamer::DecodeImageFile(reinterpret_cast<const uint8_t*>(fileContents.data()), fileContents.size(), ret))
+    {
+        std::cout << "Failed to load image " << filePath << std::endl;
+        return {};
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Classifies the material of each mesh as opaque or alpha-masked based on its textures.
+ */
+void Model::ClassifyMaterials()
+{
+    PROFILE_FUNCTION();
+
+    for (size_t i = 0; i < m_meshes.size(); ++i)
+    {
+        Mesh* mesh = m_meshes[i];
+        mesh->isAlphaMasked = (!mesh->diffuseMapFilePaths.empty() && IsTextureTransparent(mesh->diffuseMapFilePaths[0]))
+            || (!mesh->emissiveMapFilePaths.empty() && IsTextureTransparent(mesh->emissiveMapFilePaths[0]));
+    }
+}
+
+/**
+ * @brief Checks whether a texture may have transparent texels. Embedded textures are scanned, while
+ * texture files are classified by whether they have an alpha channel, without decoding them.
+ * @param[in] textureKey Texture key, as stored in the mesh texture paths
+ * @return Returns true if the texture may have transparent texels. Returns false otherwise.
+ */
+bool Model::IsTextureTransparent(const std::string& textureKey)
+{
+    auto it = m_textureTransparency.find(textureKey);
+    if (it != m_textureTransparency.end())
+    {
+        return it->second;
+    }
+
+    bool isTransparent = false;
+    const ImageData* embeddedTexture = GetEmbeddedTexture(textureKey);
+    if (embeddedTexture != nullptr)
+    {
+        isTransparent = TextureStreamer::HasTransparentPixels(*embeddedTexture);
+    }
+    else
+    {
+        // Files that cannot be read are replaced by the opaque default textures
+        int width, height, numChannels;
+        isTransparent = stbi_info(textureKey.c_str(), &width, &height, &numChannels) && ((numChannels == 2) || (numChannels == 4));
+    }
+
+    m_textureTransparency[textureKey] = isTransparent;
+    return isTransparent;
+}
+
+/**
+ * @brief Checks whether all the UVs of a mesh are within [0, 1].
+ * @param[in] mesh Mesh
+ * @return Returns true if all the UVs are within [0, 1]. Returns false otherwise.
+ */
+bool Model::AreTextureCoordinatesNormalized(const Mesh* mesh)
+{
+    const float epsilon = 1e-4f;
+    for (size_t i = 0; i < mesh->vertices.size(); ++i)
+    {
+        const glm::vec2& uv = mesh->vertices[i].uv;
+        if ((uv.x < -epsilon) || (uv.x > 1.0f + epsilon) || (uv.y < -epsilon) || (uv.y > 1.0f + epsilon))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Reads a pixel of an image and converts it to 8-bit RGBA.
+ * @param[in] image Image
+ * @param[in] x Pixel column
+ * @param[in] y Pixel row
+ * @param[out] outPixel Pixel in 8-bit RGBA
+ */
+void Model::ReadPixelRGBA8(const ImageData& image, const uint32_t& x, const uint32_t& y, uint8_t* outPixel)
+{
+    // 16-bit color channels are linear and are encoded back to sRGB, 16-bit alpha keeps its most significant byte
+    const uint8_t* pixel = image.pixels.get() + (static_cast<size_t>(y) * image.width + x) * image.numChannels * image.bytesPerChannel;
+    const uint32_t numColorChannels = (image.numChannels <= 2) ? 1 : 3;
+    uint8_t channels[4] = { 0, 0, 0, 255 };
+    for (uint32_t c = 0; c < image.numChannels; ++c)
+    {
+        if (image.bytesPerChannel == 2)
+        {
+            const uint16_t value = reinterpret_cast<const uint16_t*>(pixel)[c];
+            channels[c] = (c < numColorChannels) ? TextureStreamer::EncodeSRGB8(value) : static_cast<uint8_t>(value >> 8);
+        }
+        else
+        {
+            channels[c] = pixel[c];
+        }
+    }
+
+    if (image.numChannels <= 2)
+    {
+        // Grayscale (+ alpha)
+        outPixel[0] = channels[0];
+        outPixel[1] = channels[0];
+        outPixel[2] = channels[0];
+        outPixel[3] = (image.numChannels == 2) ? channels[1] : 255;
+    }
+    else
+    {
+        outPixel[0] = image.isBGRA ? channels[2] : channels[0];
+        outPixel[1] = channels[1];
+        outPixel[2] = image.isBGRA ? channels[0] : channels[2];
+        outPixel[3] = channels[3];
+    }
+}
+
+/**
+ * @brief Gets the time elapsed since a point in time.
+ * @param[in] startTime Point in time
+ * @return Elapsed time (in milliseconds)
+ */
+double Model::GetElapsedMilliseconds(const std::chrono::steady_clock::time_point& startTime)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
 /**
  * @brief Cleans up resources.
  */
@@ -208,4 +738,11 @@ void Model::Cleanup()
         delete m_meshes[i];
     }
     m_meshes.clear();
+
+    m_embeddedTextures.clear();
+    m_textureTransparency.clear();
+    m_numTextureAtlases = 0;
+    m_numAtlasPackedTextures = 0;
+    m_totalVertexCount = 0;
+    m_totalTriangleCount = 0;
 }
@@ -0,0 +1,300 @@
+#include "Graphics/ParallelCommandRecorder.hpp"
+
+#include "Graphics/Vulkan/VulkanContext.hpp"
+
+#include "Profiling/CpuProfiler.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+/**
+ * @brief Constructor
+ */
+ParallelCommandRecorder::ParallelCommandRecorder()
+    : m_commandPools()
+    , m_workerThreads()
+    , m_mutex()
+    , m_jobCondition()
+    , m_doneCondition()
+    , m_jobGeneration(0)
+    , m_numBusyWorkers(0)
+    , m_isRunning(false)
+    , m_jobFrameIndex(0)
+    , m_jobNumChunks(0)
+    , m_jobInheritanceInfo(nullptr)
+    , m_jobRecordFunction(nullptr)
+    , m_jobCommandBuffers(nullptr)
+    , m_nextChunk(0)
+    , m_hasJobFailed(false)
+{
+}
+
+/**
+ * @brief Destructor
+ */
+ParallelCommandRecorder::~ParallelCommandRecorder()
+{
+}
+
+/**
+ * @brief Creates the command pools and starts the worker threads. The calling thread also records chunks,
+ * so one thread less than the thread count is started.
+ * @param[in] numFramesInFlight Number of frames in flight
+ * @param[in] numThreads Number of recording threads, including the calling thread
+ * @return Returns true if the initialization was successful. Returns false otherwise.
+ */
+bool ParallelCommandRecorder::Initialize(const uint32_t& numFramesInFlight, const uint32_t& numThreads)
+{
+    VkCommandPoolCreateInfo commandPoolInfo = {};
+    commandPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    commandPoolInfo.queueFamilyIndex = VulkanContext::GetGraphicsQueueIndex();
+    commandPoolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT; // Command buffers are only reset through their pool
+
+    m_commandPools.resize(numFramesInFlight);
+    for (std::vector<ThreadCommandPool>& framePools : m_commandPools)
+    {
+        framePools.resize(std::max(numThreads, 1u), { VK_NULL_HANDLE, {}, 0 });
+        for (ThreadCommandPool& threadPool : framePools)
+        {
+            if (vkCreateCommandPool(VulkanContext::GetLogicalDevice(), &commandPoolInfo, nullptr, &threadPool.commandPool) != VK_SUCCESS)
+            {
+                std::cout << "Failed to create recording thread command pool!" << std::endl;
+                return false;
+            }
+        }
+    }
+
+    m_isRunning = true;
+    for (uint32_t i = 1; i < numThreads; ++i)
+    {
+        m_workerThreads.emplace_back(&ParallelCommandRecorder::WorkerLoop, this, i);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Stops the worker threads and destroys the command pools. The device must be idle.
+ */
+void ParallelCommandRecorder::Cleanup()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isRunning = false;
+    }
+    m_jobCondition.notify_all();
+
+    for (std::thread& workerThread : m_workerThreads)
+    {
+        if (workerThread.joinable())
+        {
+            workerThread.join();
+        }
+    }
+    m_workerThreads.clear();
+
+    // Destroying a pool frees its command buffers
+    for (std::vector<ThreadCommandPool>& framePools : m_commandPools)
+    {
+        for (ThreadCommandPool& threadPool : framePools)
+        {
+            if (threadPool.commandPool != VK_NULL_HANDLE)
+            {
+                vkDestroyCommandPool(VulkanContext::GetLogicalDevice(), threadPool.commandPool, nullptr);
+            }
+        }
+    }
+    m_commandPools.clear();
+}
+
+/**
+ * @brief Gets the number of recording threads, including the calling thread.
+ * @return Number of recording threads
+ */
+uint32_t ParallelCommandRecorder::GetThreadCount() const
+{
+    return static_cast<uint32_t>(m_workerThreads.size()) + 1;
+}
+
+/**
+ * @brief Resets the command pools of a frame in flight, recycling its secondary command buffers.
+ * The previous submission of the frame must have completed.
+ * @param[in] frameIndex Index of the frame in flight
+ */
+void ParallelCommandRecorder::BeginFrame(const uint32_t& frameIndex)
+{
+    for (ThreadCommandPool& threadPool : m_commandPools[frameIndex])
+    {
+        if (threadPool.numUsedCommandBuffers > 0)
+        {
+            vkResetCommandPool(VulkanContext::GetLogicalDevice(), threadPool.commandPool, 0);
+            threadPool.numUsedCommandBuffers = 0;
+        }
+    }
+}
+
+/**
+ * @brief Begins a secondary command buffer on the calling thread, for commands that must be ordered
+ * between parallel chunks. Must not be called while chunks are being recorded.
+ * @param[in] frameIndex Index of the frame in flight
+ * @param[in] inheritanceInfo Render pass state inherited from the primary command buffer
+ * @return Secondary command buffer, or VK_NULL_HANDLE if it could not be begun
+ */
+VkCommandBuffer ParallelCommandRecorder::BeginSecondary(const uint32_t& frameIndex, const VkCommandBufferInheritanceInfo& inheritanceInfo)
+{
+    return BeginCommandBuffer(frameIndex, 0, inheritanceInfo);
+}
+
+/**
+ * @brief Records chunks into secondary command buffers in parallel, and waits for all of them to finish.
+ * @param[in] frameIndex Index of the frame in flight
+ * @param[in] numChunks Number of chunks
+ * @param[in] inheritanceInfo Render pass state inherited from the primary command buffer
+ * @param[in] recordChunk Function recording a chunk. It is called concurrently from several threads.
+ * @param[out] outCommandBuffers Array of numChunks elements receiving the ended secondary command buffers, in chunk order
+ * @return Returns true if every chunk was recorded successfully. Returns false otherwise.
+ */
+bool ParallelCommandRecorder::Record(const uint32_t& frameIndex, const uint32_t& numChunks, const VkCommandBufferInheritanceInfo& inheritanceInfo,
+    const RecordFunction& recordChunk, VkCommandBuffer* outCommandBuffers)
+{
+    PROFILE_FUNCTION();
+
+    std::fill(outCommandBuffers, outCommandBuffers + numChunks, VK_NULL_HANDLE);
+    if (numChunks == 0)
+    {
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobFrameIndex = frameIndex;
+        m_jobNumChunks = numChunks;
+        m_jobInheritanceInfo = &inheritanceInfo;
+        m_jobRecordFunction = &recordChunk;
+        m_jobCommandBuffers = outCommandBuffers;
+        m_nextChunk = 0;
+        m_hasJobFailed = false;
+        m_numBusyWorkers = static_cast<uint32_t>(m_workerThreads.size());
+        ++m_jobGeneration;
+    }
+    m_jobCondition.notify_all();
+
+    // The calling thread records chunks too, instead of idling until the workers are done
+    RecordChunks(0);
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_doneCondition.wait(lock, [this]() { return m_numBusyWorkers == 0; });
+        m_jobRecordFunction = nullptr;
+        m_jobInheritanceInfo = nullptr;
+        m_jobCommandBuffers = nullptr;
+    }
+
+    return !m_hasJobFailed;
+}
+
+/**
+ * @brief Main loop of a worker thread.
+ * @param[in] threadIndex Index of the thread
+ */
+void ParallelCommandRecorder::WorkerLoop(const uint32_t threadIndex)
+{
+    CpuProfiler::SetThreadName("Command recorder " + std::to_string(threadIndex));
+
+    uint64_t lastJobGeneration = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobCondition.wait(lock, [this, lastJobGeneration]() { return !m_isRunning || (m_jobGeneration != lastJobGeneration); });
+            if (!m_isRunning)
+            {
+                return;
+            }
+            lastJobGeneration = m_jobGeneration;
+        }
+
+        RecordChunks(threadIndex);
+
+        // Every worker checks in, so that the next job cannot start before all workers have seen this one
+        bool isLastWorker = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            isLastWorker = (--m_numBusyWorkers == 0);
+        }
+        if (isLastWorker)
+        {
+            m_doneCondition.notify_one();
+        }
+    }
+}
+
+/**
+ * @brief Records chunks of the current job until none are left.
+ * @param[in] threadIndex Index of the recording thread
+ */
+void ParallelCommandRecorder::RecordChunks(const uint32_t& threadIndex)
+{
+    PROFILE_FUNCTION();
+
+    for (uint32_t chunkIndex = m_nextChunk++; chunkIndex < m_jobNumChunks; chunkIndex = m_nextChunk++)
+    {
+        VkCommandBuffer commandBuffer = BeginCommandBuffer(m_jobFrameIndex, threadIndex, *m_jobInheritanceInfo);
+        if (commandBuffer == VK_NULL_HANDLE)
+        {
+            m_hasJobFailed = true;
+            continue;
+        }
+
+        (*m_jobRecordFunction)(chunkIndex, commandBuffer);
+
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+        {
+            m_hasJobFailed = true;
+            continue;
+        }
+        m_jobCommandBuffers[chunkIndex] = commandBuffer;
+    }
+}
+
+/**
+ * @brief Takes an unused secondary command buffer of a thread, allocating a new one if needed, and begins it.
+ * @param[in] frameIndex Index of the frame in flight
+ * @param[in] threadIndex Index of the recording thread
+ * @param[in] inheritanceInfo Render pass state inherited from the primary command buffer
+ * @return Secondary command buffer, or VK_NULL_HANDLE if it could not be begun
+ */
+VkCommandBuffer ParallelCommandRecorder::BeginCommandBuffer(const uint32_t& frameIndex, const uint32_t& threadIndex, const VkCommandBufferInheritanceInfo& inheritanceInfo)
+{
+    ThreadCommandPool& threadPool = m_commandPools[frameIndex][threadIndex];
+    if (threadPool.numUsedCommandBuffers == threadPool.commandBuffers.size())
+    {
+        VkCommandBufferAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocateInfo.commandPool = threadPool.commandPool;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocateInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        if (vkAllocateCommandBuffers(VulkanContext::GetLogicalDevice(), &allocateInfo, &commandBuffer) != VK_SUCCESS)
+        {
+            std::cout << "Failed to allocate secondary command buffer!" << std::endl;
+            return VK_NULL_HANDLE;
+        }
+        threadPool.commandBuffers.push_back(commandBuffer);
+    }
+    VkCommandBuffer commandBuffer = threadPool.commandBuffers[threadPool.numUsedCommandBuffers++];
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+    {
+        std::cout << "Failed to begin secondary command buffer!" << std::endl;
+        return VK_NULL_HANDLE;
+    }
+
+    return commandBuffer;
+}
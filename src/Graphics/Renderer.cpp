@@ -7,10 +7,16 @@
 
 #include "IO/FileIO.hpp"
 
+#include "Profiling/CpuProfiler.hpp"
+
 #define STB_IMAGE_IMPLEMENTATION
 #include <stbi/stb_image.h>
 
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <cmath>
+#include <fstream>
 
 #define DEFAULT_EMISSIVE_MAP_PATH "resources/textures/default_emissive.png"
 #define DEFAULT_DIFFUSE_MAP_PATH "resources/textures/default_diffuse.png"
@@ -19,10 +25,39 @@
  * @brief Constructor
  */
 Renderer::Renderer()
-    : m_textureToVulkanImageMap()
-    , m_textureToVulkanImageViewMap()
-    , m_textureToDescriptorSetMap()
+    : m_vkRenderPass(VK_NULL_HANDLE)
+    , m_vkVertexShaderModule(VK_NULL_HANDLE)
+    , m_vkFragmentShaderModule(VK_NULL_HANDLE)
+    , m_vkPipelines()
+    , m_pipelineCreationTime(0.0)
+    , m_uniformRingBuffer()
+    , m_uniformBufferAlignment(1)
+    , m_vkPerFrameDescriptorSet(VK_NULL_HANDLE)
+    , m_vkPerObjectDescriptorSet(VK_NULL_HANDLE)
+    , m_frameUBOOffset(0)
+    , m_objectUBOOffset(0)
+    , m_textures()
+    , m_textureContentHashes()
+    , m_requestedTextures()
+    , m_numDeduplicatedTextures(0)
+    , m_textureLoadGeneration(0)
+    , m_textureStreamer()
+    , m_retiredTextureViews()
+    , m_pendingUploads()
+    , m_numFramesInFlight(1)
+    , m_frameNumber(0)
     , m_renderBatchUnits()
+    , m_producerBatches()
+    , m_frameArenas()
+    , m_currentFrameIndex(0)
+    , m_numUploadedBatchUnits(0)
+    , m_numOpaqueBatchUnits(0)
+    , m_isAlphaMaskSplitEnabled(true)
+    , m_gpuProfiler(nullptr)
+    , m_commandRecorder()
+    , m_frameStatistics()
+    , m_hasDroppedDraws(false)
+    , m_memoryStatistics()
 {
 }
 
@@ -35,14 +70,21 @@ Renderer::~Renderer()
 
 /**
  * @brief Initializes the mesh renderer system.
- * @param[in] numSwapchainImages Number of swapchain images
+ * @param[in] numFramesInFlight Number of frames in flight
+ * @param[in] numRecordingThreads Number of threads recording the draws. With more than one thread,
+ * the draws are recorded into secondary command buffers.
  * @param[in] renderPass Vulkan render pass
  * @return Returns true if the initialization was successful. Returns false otherwise.
  */
-bool Renderer::Initialize(const uint32_t& numSwapchainImages, VkRenderPass renderPass)
+bool Renderer::Initialize(const uint32_t& numFramesInFlight, const uint32_t& numRecordingThreads, VkRenderPass renderPass)
 {
+    m_vkRenderPass = renderPass;
+
+    // The pipeline with all features can render any material, so it is created up front.
+    // The cheaper permutations are created the first time a material needs them.
     if (!CreateDescriptorSetLayout()
-            || !CreateGraphicsPipeline(renderPass)
+            || !CreatePipelineLayout()
+            || (GetPipeline(PIPELINE_FEATURE_ALL) == VK_NULL_HANDLE)
             || !CreateTextureSampler()
             || !CreateDescriptorPool())
     {
@@ -51,10 +93,9 @@ bool Renderer::Initialize(const uint32_t& numSwapchainImages, VkRenderPass rende
         return false;
     }
 
-    m_frameInFlightData.resize(numSwapchainImages);
+    m_numFramesInFlight = numFramesInFlight;
+    m_frameInFlightData.resize(numFramesInFlight);
 
-    const uint32_t MAX_VERTICES = 250000;
-    const uint32_t MAX_INDICES = 1000000;
     for (size_t i = 0; i < m_frameInFlightData.size(); ++i)
     {
         VkDeviceSize bufferSize = sizeof(Vertex) * MAX_VERTICES;
@@ -67,382 +108,1173 @@ bool Renderer::Initialize(const uint32_t& numSwapchainImages, VkRenderPass rende
                 bufferSize, 
                 VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, 
                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-        
-    }
-    VkDeviceSize bufferSize = sizeof(Vertex) * MAX_VERTICES;
-    m_vertexStagingBuffer.Create(
+
+        // Each frame has its own staging buffers, since the copies now run as part of the frame's command buffer
+        bufferSize = sizeof(Vertex) * MAX_VERTICES;
+        m_frameInFlightData[i].vertexStagingBuffer.Create(
                 bufferSize,
                 VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-    bufferSize = sizeof(uint32_t) * MAX_INDICES;
-    m_indexStagingBuffer.Create(
+        bufferSize = sizeof(uint32_t) * MAX_INDICES;
+        m_frameInFlightData[i].indexStagingBuffer.Create(
                 bufferSize,
                 VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 
-    m_vkPerFrameDescriptorSets.resize(numSwapchainImages, VK_NULL_HANDLE);
-    m_vkPerObjectDescriptorSets.resize(numSwapchainImages, VK_NULL_HANDLE);
-    m_perFrameUBOs.resize(numSwapchainImages, {});
-    m_perObjectUBOs.resize(numSwapchainImages, {});
-    for (uint32_t i = 0; i < numSwapchainImages; ++i)
-    {
-        m_perFrameUBOs[i].Create(sizeof(FrameUBO), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-        m_perObjectUBOs[i].Create(sizeof(ObjectUBO) * MAX_OBJECTS, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        m_memoryStatistics.geometryBufferBytes += m_frameInFlightData[i].vertexBuffer.GetMemorySize() + m_frameInFlightData[i].indexBuffer.GetMemorySize();
+        m_memoryStatistics.stagingBufferBytes += m_frameInFlightData[i].vertexStagingBuffer.GetMemorySize() + m_frameInFlightData[i].indexStagingBuffer.GetMemorySize();
+    }
 
-        VkDescriptorSetAllocateInfo allocInfo = {};
-        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocInfo.descriptorPool = m_vkDescriptorPool;
-        allocInfo.descriptorSetCount = 1;
-        allocInfo.pSetLayouts = &m_vkPerFrameDescriptorSetLayout;
-        if (vkAllocateDescriptorSets(VulkanContext::GetLogicalDevice(), &allocInfo, &m_vkPerFrameDescriptorSets[i]) != VK_SUCCESS)
-        {
-            std::cout << "Failed to create per-frame descriptor sets!" << std::endl;
-            return false;
-        }
+    // The per-frame and per-object data of all frames in flight share one persistently mapped ring buffer.
+    // Each frame's allocations are addressed through dynamic offsets, so a single descriptor set of each kind is enough.
+    VkPhysicalDeviceProperties deviceProperties = {};
+    vkGetPhysicalDeviceProperties(VulkanContext::GetPhysicalDevice(), &deviceProperties);
+    m_uniformBufferAlignment = std::max(deviceProperties.limits.minUniformBufferOffsetAlignment, deviceProperties.limits.minStorageBufferOffsetAlignment);
 
-        allocInfo.pSetLayouts = &m_vkPerObjectDescriptorSetLayout;
-        if (vkAllocateDescriptorSets(VulkanContext::GetLogicalDevice(), &allocInfo, &m_vkPerObjectDescriptorSets[i]) != VK_SUCCESS)
-        {
-            std::cout << "Failed to create per-object descriptor sets!" << std::endl;
-            return false;
-        }
+    auto alignSize = [this](const VkDeviceSize& size) { return (size + m_uniformBufferAlignment - 1) & ~(m_uniformBufferAlignment - 1); };
+    VkDeviceSize frameRegionSize = alignSize(sizeof(FrameUBO)) + alignSize(sizeof(ObjectUBO) * MAX_OBJECTS);
+    if (!m_uniformRingBuffer.Create(frameRegionSize, numFramesInFlight, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT))
+    {
+        std::cout << "Failed to create uniform ring buffer!" << std::endl;
+        return false;
     }
-
-    // Configure descriptors for each descriptor set
-    for (uint32_t i = 0; i < numSwapchainImages; ++i)
+    m_memoryStatistics.uniformBufferBytes += m_uniformRingBuffer.GetMemorySize();
+
+    VkDescriptorSetAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_vkDescriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &m_vkPerFrameDescriptorSetLayout;
+    if (vkAllocateDescriptorSets(VulkanContext::GetLogicalDevice(), &allocInfo, &m_vkPerFrameDescriptorSet) != VK_SUCCESS)
     {
-        // Per-frame description set
-        VkDescriptorBufferInfo perFrameBufferInfo = {};
-        perFrameBufferInfo.buffer = m_perFrameUBOs[i].GetHandle();
-        perFrameBufferInfo.offset = 0;
-        perFrameBufferInfo.range = sizeof(FrameUBO); // Can also use VK_WHOLE_SIZE to overwrite the whole buffer
-
-        // Per-object description set
-        VkDescriptorBufferInfo perObjectBufferInfo = {};
-        perObjectBufferInfo.buffer = m_perObjectUBOs[i].GetHandle();
-        perObjectBufferInfo.offset = 0;
-        perObjectBufferInfo.range = sizeof(ObjectUBO) * MAX_OBJECTS;
+        std::cout << "Failed to create per-frame descriptor set!" << std::endl;
+        return false;
+    }
 
-        std::array<VkWriteDescriptorSet, 2> descriptorWrites = {};
-        descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrites[0].dstSet = m_vkPerFrameDescriptorSets[i];
-        descriptorWrites[0].dstBinding = 0;
-        descriptorWrites[0].dstArrayElement = 0;
-        descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        descriptorWrites[0].descriptorCount = 1;
-        descriptorWrites[0].pBufferInfo = &perFrameBufferInfo;
-        descriptorWrites[0].pImageInfo = nullptr;
-        descriptorWrites[0].pTexelBufferView = nullptr;
+    allocInfo.pSetLayouts = &m_vkPerObjectDescriptorSetLayout;
+    if (vkAllocateDescriptorSets(VulkanContext::GetLogicalDevice(), &allocInfo, &m_vkPerObjectDescriptorSet) != VK_SUCCESS)
+    {
+        std::cout << "Failed to create per-object descriptor set!" << std::endl;
+        return false;
+    }
 
-        descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrites[1].dstSet = m_vkPerObjectDescriptorSets[i];
-        descriptorWrites[1].dstBinding = 0;
-        descriptorWrites[1].dstArrayElement = 0;
-        descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-        descriptorWrites[1].descriptorCount = 1;
-        descriptorWrites[1].pBufferInfo = &perObjectBufferInfo;
-        descriptorWrites[1].pImageInfo = nullptr;
-        descriptorWrites[1].pTexelBufferView = nullptr;
+    // Per-frame description set. The offset is supplied as a dynamic offset when the set is bound.
+    VkDescriptorBufferInfo perFrameBufferInfo = {};
+    perFrameBufferInfo.buffer = m_uniformRingBuffer.GetHandle();
+    perFrameBufferInfo.offset = 0;
+    perFrameBufferInfo.range = sizeof(FrameUBO);
+
+    // Per-object description set
+    VkDescriptorBufferInfo perObjectBufferInfo = {};
+    perObjectBufferInfo.buffer = m_uniformRingBuffer.GetHandle();
+    perObjectBufferInfo.offset = 0;
+    perObjectBufferInfo.range = sizeof(ObjectUBO) * MAX_OBJECTS;
+
+    std::array<VkWriteDescriptorSet, 2> descriptorWrites = {};
+    descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrites[0].dstSet = m_vkPerFrameDescriptorSet;
+    descriptorWrites[0].dstBinding = 0;
+    descriptorWrites[0].dstArrayElement = 0;
+    descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    descriptorWrites[0].descriptorCount = 1;
+    descriptorWrites[0].pBufferInfo = &perFrameBufferInfo;
+    descriptorWrites[0].pImageInfo = nullptr;
+    descriptorWrites[0].pTexelBufferView = nullptr;
+
+    descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrites[1].dstSet = m_vkPerObjectDescriptorSet;
+    descriptorWrites[1].dstBinding = 0;
+    descriptorWrites[1].dstArrayElement = 0;
+    descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    descriptorWrites[1].descriptorCount = 1;
+    descriptorWrites[1].pBufferInfo = &perObjectBufferInfo;
+    descriptorWrites[1].pImageInfo = nullptr;
+    descriptorWrites[1].pTexelBufferView = nullptr;
+
+    vkUpdateDescriptorSets(VulkanContext::GetLogicalDevice(), static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+
+    m_frameArenas = std::vector<FrameArena>(numFramesInFlight);
+
+    // Default textures are used as placeholders while the actual textures are streamed in,
+    // so they are loaded in full right away.
+    if (!LoadTextureImmediate(DEFAULT_EMISSIVE_MAP_PATH) || !LoadTextureImmediate(DEFAULT_DIFFUSE_MAP_PATH))
+    {
+        std::cout << "Failed to load default textures!" << std::endl;
+        return false;
+    }
 
-        vkUpdateDescriptorSets(VulkanContext::GetLogicalDevice(), static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+    if ((numRecordingThreads > 1) && !m_commandRecorder.Initialize(numFramesInFlight, numRecordingThreads))
+    {
+        std::cout << "Failed to initialize the parallel command recorder!" << std::endl;
+        return false;
     }
 
+    m_textureStreamer.Start();
+
     return true;
 }
 
 /**
- * @brief Begins the render batch.
+ * @brief Begins the render batch. The previous submission of the frame in flight must have completed,
+ * since its transient data is released.
+ * @param[in] frameIndex Index of the frame in flight
+ * @param[in] numProducers Number of producers that add draws to the batch, each from at most one thread at a time
  */
-void Renderer::Begin()
+void Renderer::Begin(const uint32_t& frameIndex, const uint32_t& numProducers)
 {
+    m_currentFrameIndex = frameIndex;
+    m_frameArenas[frameIndex].Reset();
+    m_uniformRingBuffer.BeginFrame(frameIndex);
+
     m_renderBatchUnits.clear();
+    // The producer buffers keep their capacity across frames, so producers rarely allocate
+    m_producerBatches.resize(std::max(numProducers, 1u));
+    for (ProducerBatch& producerBatch : m_producerBatches)
+    {
+        producerBatch.renderBatchUnits.clear();
+        producerBatch.models.clear();
+    }
+    m_numUploadedBatchUnits = 0;
+    m_numOpaqueBatchUnits = 0;
+    m_frameStatistics = {};
+
+    ++m_frameNumber;
+    DestroyRetiredTextureViews(false);
+    ReleaseCompletedUploads(false);
 }
 
 /**
- * @brief Adds the model to the render batch.
+ * @brief Adds the model to the render batch. Different producers may call this concurrently,
+ * since each one appends to its own buffer.
  * @param[in] model Model to add to the render batch
  * @param[in] transform Transformation matrix
+ * @param[in] producerIndex Index of the producer adding the model, smaller than the count passed to Begin
  */
-void Renderer::DrawModel(Model* model, const glm::mat4& transform)
+void Renderer::DrawModel(Model* model, const glm::mat4& transform, const uint32_t& producerIndex)
 {
+    PROFILE_FUNCTION();
+
     if (model == nullptr)
     {
         return;
     }
 
+    ProducerBatch& producerBatch = m_producerBatches[producerIndex];
+
     const std::vector<Mesh*>& meshes = model->GetMeshes();
     for (size_t i = 0; i < meshes.size(); ++i)
     {
-        Mesh* mesh = meshes[i];
+        producerBatch.renderBatchUnits.emplace_back();
+        producerBatch.renderBatchUnits.back().mesh = meshes[i];
+        producerBatch.renderBatchUnits.back().transform = transform;
+    }
+
+    // Texture requests touch shared state, so they are deferred to End. Instances of a model
+    // are usually drawn back to back, which this check collapses into a single entry.
+    if (producerBatch.models.empty() || (producerBatch.models.back() != model))
+    {
+        producerBatch.models.push_back(model);
+    }
+}
+
+/**
+ * @brief Ends the render batch, merging the draws of all producers in producer order.
+ * No producer may be adding draws anymore.
+ */
+void Renderer::End()
+{
+    PROFILE_FUNCTION();
+
+    size_t numRenderBatchUnits = 0;
+    for (const ProducerBatch& producerBatch : m_producerBatches)
+    {
+        numRenderBatchUnits += producerBatch.renderBatchUnits.size();
+    }
+    m_renderBatchUnits.reserve(numRenderBatchUnits);
+
+    // Producers may draw the same model, so the models are deduplicated through a sorted array in the frame arena
+    FrameArena& frameArena = m_frameArenas[m_currentFrameIndex];
+    size_t numModels = 0;
+    for (const ProducerBatch& producerBatch : m_producerBatches)
+    {
+        numModels += producerBatch.models.size();
+    }
+    const Model** sortedModels = frameArena.Allocate<const Model*>(numModels);
+    bool* isModelRequested = frameArena.Allocate<bool>(numModels);
+    numModels = 0;
+    for (const ProducerBatch& producerBatch : m_producerBatches)
+    {
+        numModels = std::copy(producerBatch.models.begin(), producerBatch.models.end(), sortedModels + numModels) - sortedModels;
+    }
+    std::sort(sortedModels, sortedModels + numModels);
+    numModels = std::unique(sortedModels, sortedModels + numModels) - sortedModels;
+
+    for (const ProducerBatch& producerBatch : m_producerBatches)
+    {
+        m_renderBatchUnits.insert(m_renderBatchUnits.end(), producerBatch.renderBatchUnits.begin(), producerBatch.renderBatchUnits.end());
+
+        for (Model* model : producerBatch.models)
+        {
+            // Textures are requested in the order the models were drawn
+            size_t modelIndex = std::lower_bound(sortedModels, sortedModels + numModels, model) - sortedModels;
+            if (isModelRequested[modelIndex])
+            {
+                continue;
+            }
+            isModelRequested[modelIndex] = true;
+
+            for (const Mesh* mesh : model->GetMeshes())
+            {
+                if (mesh->emissiveMapFilePaths.size() > 0)
+                {
+                    RequestTexture(model, mesh->emissiveMapFilePaths[0]);
+                }
+                if (mesh->diffuseMapFilePaths.size() > 0)
+                {
+                    RequestTexture(model, mesh->diffuseMapFilePaths[0]);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Picks up decoded textures and refines the resolution of the textures in the render batch
+ * based on how large they appear on screen.
+ * @param[in] cameraPosition Camera position in world space
+ * @param[in] fieldOfView Vertical field of view of the camera (in degrees)
+ * @param[in] viewportHeight Height of the viewport in pixels
+ */
+void Renderer::UpdateTextureStreaming(const glm::vec3& cameraPosition, const float& fieldOfView, const uint32_t& viewportHeight)
+{
+    PROFILE_FUNCTION();
+
+    // --- Estimate the on-screen footprint of each texture ---
+    for (auto& pair : m_textures)
+    {
+        pair.second.footprint = 0.0f;
+    }
+    for (auto& pair : m_requestedTextures)
+    {
+        pair.second = 0.0f;
+    }
 
-        m_renderBatchUnits.emplace_back();
-        m_renderBatchUnits.back().mesh = mesh;
-        m_renderBatchUnits.back().transform = transform;
+    const float tanHalfFieldOfView = glm::tan(glm::radians(fieldOfView) * 0.5f);
+    for (size_t i = 0; i < m_renderBatchUnits.size(); ++i)
+    {
+        const Mesh* mesh = m_renderBatchUnits[i].mesh;
+        const glm::mat4& transform = m_renderBatchUnits[i].transform;
+
+        glm::vec3 center = glm::vec3(transform * glm::vec4(mesh->boundsCenter, 1.0f));
+        float scale = std::max({ glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2])) });
+        float radius = mesh->boundsRadius * scale;
+
+        // Projected diameter of the bounding sphere in pixels. If the camera is inside the sphere,
+        // treat the mesh as covering the whole viewport.
+        float distance = glm::length(center - cameraPosition);
+        float footprint = static_cast<float>(viewportHeight);
+        if (distance > radius)
+        {
+            footprint = std::min(footprint, radius / (distance * tanHalfFieldOfView) * viewportHeight);
+        }
 
-        std::string emissiveTexturePath = (mesh->emissiveMapFilePaths.size() > 0) 
-            ? mesh->emissiveMapFilePaths[0] : DEFAULT_EMISSIVE_MAP_PATH;
-        if (m_textureToDescriptorSetMap.find(emissiveTexturePath) == m_textureToDescriptorSetMap.end())
+        if (mesh->emissiveMapFilePaths.size() > 0)
         {
-            VulkanImage image;
-            CreateTextureImage(emissiveTexturePath, image);
-            m_textureToVulkanImageMap.insert({ emissiveTexturePath, image });
+            AddTextureFootprint(mesh->emissiveMapFilePaths[0], footprint);
+        }
+        if (mesh->diffuseMapFilePaths.size() > 0)
+        {
+            AddTextureFootprint(mesh->diffuseMapFilePaths[0], footprint);
+        }
+    }
 
-            VulkanImageView imageView;
-            imageView.Create(image.GetHandle(), VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT);
-            m_textureToVulkanImageViewMap.insert({ emissiveTexturePath, imageView });
+    // --- Pick up textures that finished decoding, and make them visible at a small mip level ---
+    TextureStreamer::DecodedTexture decodedTexture;
+    while (m_textureStreamer.PopDecodedTexture(decodedTexture))
+    {
+        auto it = m_requestedTextures.find(decodedTexture.key);
+        if ((it == m_requestedTextures.end()) || !decodedTexture.isValid)
+        {
+            // Failed textures stay in the requested list, so that they are not requested again
+            continue;
+        }
 
-            VkDescriptorSet imageDescriptorSet = {};
+        float footprint = it->second;
+        m_requestedTextures.erase(it);
 
-            VkDescriptorSetAllocateInfo allocInfo = {};
-            allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-            allocInfo.descriptorPool = m_vkDescriptorPool;
-            allocInfo.descriptorSetCount = 1;
-            allocInfo.pSetLayouts = &m_vkSingleTextureDescriptorSetLayout;
-            vkAllocateDescriptorSets(VulkanContext::GetLogicalDevice(), &allocInfo, &imageDescriptorSet);
+        // Textures with the same contents share the GPU image that was created for the first one
+        auto textureIt = m_textures.find(decodedTexture.contentHash);
+        if (textureIt != m_textures.end())
+        {
+            m_textureContentHashes[decodedTexture.key] = decodedTexture.contentHash;
+            textureIt->second.footprint = std::max(textureIt->second.footprint, footprint);
+            if (decodedTexture.generation == m_textureLoadGeneration)
+            {
+                ++m_numDeduplicatedTextures;
+            }
+            continue;
+        }
+        if (decodedTexture.isDuplicate)
+        {
+            // The texture it duplicates failed to be created, so it is requested again next frame.
+            // The streamer has forgotten the failed content hash by then, and decodes it in full.
+            continue;
+        }
 
-            VkDescriptorImageInfo imageInfo = {};
-            imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            imageInfo.imageView = imageView.GetHandle();
-            imageInfo.sampler = m_vkTextureSampler;
+        std::string key = decodedTexture.key;
+        uint64_t contentHash = decodedTexture.contentHash;
+        m_textureContentHashes[key] = contentHash;
+        Texture& texture = m_textures[contentHash];
+        texture = {};
+        texture.footprint = footprint;
+        if (!CreateTextureImage(std::move(decodedTexture), STREAMING_INITIAL_MIP_SIZE, texture))
+        {
+            // Drop the entry, so that duplicates of the texture do not share a texture that never loads
+            std::cout << "Failed to create texture image for " << key << std::endl;
+            m_textures.erase(contentHash);
+            m_textureStreamer.ForgetContentHash(contentHash);
+        }
+    }
 
-            VkWriteDescriptorSet descriptorWrite = {};
-            descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            descriptorWrite.dstSet = imageDescriptorSet;
-            descriptorWrite.dstBinding = 0;
-            descriptorWrite.dstArrayElement = 0;
-            descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-            descriptorWrite.descriptorCount = 1;
-            descriptorWrite.pBufferInfo = nullptr;
-            descriptorWrite.pImageInfo = &imageInfo;
-            descriptorWrite.pTexelBufferView = nullptr;
+    // --- Determine the mip level needed by each texture, and the order in which to refine them ---
+    for (auto& pair : m_requestedTextures)
+    {
+        // Textures that appear larger on screen get decoded first
+        m_textureStreamer.SetPriority(pair.first, pair.second);
+    }
 
-            vkUpdateDescriptorSets(VulkanContext::GetLogicalDevice(), 1, &descriptorWrite, 0, nullptr);
+    std::pair<float, Texture*>* texturesToRefine = m_frameArenas[m_currentFrameIndex].Allocate<std::pair<float, Texture*>>(m_textures.size());
+    size_t numTexturesToRefine = 0;
+    for (auto& pair : m_textures)
+    {
+        Texture& texture = pair.second;
+        if (!texture.isLoaded)
+        {
+            continue;
+        }
 
-            m_textureToDescriptorSetMap.insert({ emissiveTexturePath, imageDescriptorSet });
+        if (texture.footprint <= 0.0f)
+        {
+            // Not visible this frame, so keep whatever is resident
+            texture.desiredMipLevel = texture.residentMipLevel;
+            continue;
         }
 
+        const TextureStreamer::MipLevel& baseMipLevel = texture.decodedTexture.mipLevels.empty()
+            ? TextureStreamer::MipLevel{ 0, 0, 0, 0 } : texture.decodedTexture.mipLevels[0];
+        float textureSize = static_cast<float>(std::max(baseMipLevel.width, baseMipLevel.height));
+        float ratio = textureSize / texture.footprint;
+        uint32_t desiredMipLevel = (ratio > 1.0f) ? static_cast<uint32_t>(std::floor(std::log2(ratio))) : 0;
+        texture.desiredMipLevel = std::min(desiredMipLevel, texture.numMipLevels - 1);
 
-        std::string texturePath = (mesh->diffuseMapFilePaths.size() > 0) 
-            ? mesh->diffuseMapFilePaths[0] : DEFAULT_DIFFUSE_MAP_PATH;
-        if (m_textureToDescriptorSetMap.find(texturePath) == m_textureToDescriptorSetMap.end())
+        if (texture.residentMipLevel > texture.desiredMipLevel)
         {
-            VulkanImage image;
-            CreateTextureImage(texturePath, image);
-            m_textureToVulkanImageMap.insert({ texturePath, image });
+            // Textures whose resident resolution is furthest below their footprint get refined first
+            const TextureStreamer::MipLevel& residentMipLevel = texture.decodedTexture.mipLevels[texture.residentMipLevel];
+            float priority = texture.footprint / std::max(residentMipLevel.width, residentMipLevel.height);
+            texturesToRefine[numTexturesToRefine++] = { priority, &texture };
+        }
+    }
 
-            VulkanImageView imageView;
-            imageView.Create(image.GetHandle(), VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT);
-            m_textureToVulkanImageViewMap.insert({ texturePath, imageView });
+    std::sort(texturesToRefine, texturesToRefine + numTexturesToRefine,
+        [](const std::pair<float, Texture*>& a, const std::pair<float, Texture*>& b) { return a.first > b.first; });
 
-            VkDescriptorSet imageDescriptorSet = {};
+    // --- Upload finer mip levels within the per-frame budget ---
+    size_t uploadedBytes = 0;
+    for (size_t i = 0; i < numTexturesToRefine; ++i)
+    {
+        Texture& texture = *texturesToRefine[i].second;
 
-            VkDescriptorSetAllocateInfo allocInfo = {};
-            allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-            allocInfo.descriptorPool = m_vkDescriptorPool;
-            allocInfo.descriptorSetCount = 1;
-            allocInfo.pSetLayouts = &m_vkSingleTextureDescriptorSetLayout;
-            vkAllocateDescriptorSets(VulkanContext::GetLogicalDevice(), &allocInfo, &imageDescriptorSet);
+        // Always upload at least one mip level per frame so that streaming makes progress
+        uint32_t firstMipLevel = texture.residentMipLevel;
+        while (firstMipLevel > texture.desiredMipLevel)
+        {
+            size_t mipLevelSize = texture.decodedTexture.mipLevels[firstMipLevel - 1].size;
+            if ((uploadedBytes > 0) && (uploadedBytes + mipLevelSize > STREAMING_UPLOAD_BUDGET))
+            {
+                break;
+            }
+            uploadedBytes += mipLevelSize;
+            --firstMipLevel;
+        }
 
-            VkDescriptorImageInfo imageInfo = {};
-            imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            imageInfo.imageView = imageView.GetHandle();
-            imageInfo.sampler = m_vkTextureSampler;
+        if (firstMipLevel == texture.residentMipLevel)
+        {
+            break;
+        }
 
-            VkWriteDescriptorSet descriptorWrite = {};
-            descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            descriptorWrite.dstSet = imageDescriptorSet;
-            descriptorWrite.dstBinding = 0;
-            descriptorWrite.dstArrayElement = 0;
-            descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-            descriptorWrite.descriptorCount = 1;
-            descriptorWrite.pBufferInfo = nullptr;
-            descriptorWrite.pImageInfo = &imageInfo;
-            descriptorWrite.pTexelBufferView = nullptr;
+        if (!UploadTextureMipLevels(texture, firstMipLevel, texture.residentMipLevel - 1))
+        {
+            continue;
+        }
 
-            vkUpdateDescriptorSets(VulkanContext::GetLogicalDevice(), 1, &descriptorWrite, 0, nullptr);
+        // If the new view cannot be created, the previous one stays in use and the levels are uploaded again later
+        uint32_t previousMipLevel = texture.residentMipLevel;
+        texture.residentMipLevel = firstMipLevel;
+        if (!RefreshTextureView(texture))
+        {
+            texture.residentMipLevel = previousMipLevel;
+            continue;
+        }
 
-            m_textureToDescriptorSetMap.insert({ texturePath, imageDescriptorSet });
+        // Once the full mip chain is on the GPU, the decoded pixels are no longer needed
+        if (texture.residentMipLevel == 0)
+        {
+            texture.decodedTexture = {};
         }
     }
 }
 
 /**
- * @brief Ends the render batch.
+ * @brief Gets the number of textures decoded since the last model load that turned out to be identical
+ * to another texture and therefore share its GPU image.
+ * @return Number of deduplicated textures
  */
-void Renderer::End()
+uint32_t Renderer::GetDeduplicatedTextureCount() const
+{
+    return m_numDeduplicatedTextures;
+}
+
+/**
+ * @brief Resets the number of deduplicated textures and starts a new load generation, so that it only counts the textures of the next model.
+ */
+void Renderer::ResetDeduplicatedTextureCount()
+{
+    m_numDeduplicatedTextures = 0;
+    ++m_textureLoadGeneration;
+}
+
+/**
+ * @brief Checks whether texture streaming has settled: nothing is waiting to be decoded or picked up,
+ * and every visible texture is at its desired resolution.
+ * @return Returns true if texture streaming has settled. Returns false otherwise.
+ */
+bool Renderer::IsTextureStreamingSettled()
+{
+    return m_textureStreamer.IsIdle() && !IsStreamingTextures();
+}
+
+/**
+ * @brief Checks whether texture streaming needs more frames to make progress, because decoded textures
+ * are waiting to be picked up or visible textures are not at their desired resolution yet.
+ * Textures that are still being decoded do not count, since they report their completion through
+ * the texture decoded callback.
+ * @return Returns true if texture streaming needs more frames. Returns false otherwise.
+ */
+bool Renderer::IsStreamingTextures()
+{
+    if (m_textureStreamer.HasDecodedTextures())
+    {
+        return true;
+    }
+
+    for (const auto& pair : m_textures)
+    {
+        if (pair.second.isLoaded && (pair.second.residentMipLevel > pair.second.desiredMipLevel))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Sets a function that is called from the decoding thread whenever a texture finishes decoding.
+ * @param[in] callback Function to call, or nullptr to call nothing
+ */
+void Renderer::SetTextureDecodedCallback(void (*callback)())
 {
+    m_textureStreamer.SetDecodedCallback(callback);
 }
 
 /**
- * @brief Renders all entities with a MeshComponent and a TransformComponent.
+ * @brief Culls the render batch against the view frustum and records the copies of the remaining
+ * vertex and index data into the frame's buffers. Must be recorded outside of a render pass, before Render.
  * @param[in] commandBuffer Vulkan command buffer
- * @param[in] imageIndex Swapchain image index
+ * @param[in] frameIndex Index of the frame in flight
  * @param[in] viewMatrix View matrix
  * @param[in] projMatrix Projection matrix
  */
-void Renderer::Render(VkCommandBuffer commandBuffer, const uint32_t& imageIndex, const glm::mat4& viewMatrix, const glm::mat4& projMatrix)
+void Renderer::Upload(VkCommandBuffer commandBuffer, const uint32_t& frameIndex, const glm::mat4& viewMatrix, const glm::mat4& projMatrix)
 {
-    if (m_renderBatchUnits.size() == 0)
+    PROFILE_FUNCTION();
+
+    FrameInFlightData& frameData = m_frameInFlightData[frameIndex];
+
+    // Extract the frustum planes from the rows of the view-projection matrix (Gribb-Hartmann).
+    // The near plane is left out, since it depends on the depth range convention and rarely culls anything.
+    glm::mat4 viewProjMatrix = projMatrix * viewMatrix;
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; ++i)
     {
-        return;
+        rows[i] = glm::vec4(viewProjMatrix[0][i], viewProjMatrix[1][i], viewProjMatrix[2][i], viewProjMatrix[3][i]);
+    }
+    std::array<glm::vec4, 5> frustumPlanes = { rows[3] + rows[0], rows[3] - rows[0], rows[3] + rows[1], rows[3] - rows[1], rows[3] - rows[2] };
+    for (size_t i = 0; i < frustumPlanes.size(); ++i)
+    {
+        frustumPlanes[i] /= glm::length(glm::vec3(frustumPlanes[i]));
     }
-    
-    glm::mat4 projectionCorrectionMatrix(1.0f); // Since Vulkan's NDC has the +y-axis going downwards, we need to flip the y-axis
-    projectionCorrectionMatrix[1][1] = -1.0f;
-
-    // Bind graphics pipeline
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vkPipeline);
 
-    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vkPipelineLayout, 0, 1, &m_vkPerFrameDescriptorSets[imageIndex], 0, nullptr);
-    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vkPipelineLayout, 1, 1, &m_vkPerObjectDescriptorSets[imageIndex], 0, nullptr);
+    // Move the visible units to the front of the batch, keeping their order. The culled units are set aside
+    // in the frame arena, since std::stable_partition would allocate a temporary buffer on the heap.
+    FrameArena& frameArena = m_frameArenas[frameIndex];
+    RenderBatchUnit* culledUnits = frameArena.Allocate<RenderBatchUnit>(m_renderBatchUnits.size());
+    size_t numVisibleUnits = 0;
+    size_t numCulledUnits = 0;
+    for (size_t i = 0; i < m_renderBatchUnits.size(); ++i)
+    {
+        const RenderBatchUnit unit = m_renderBatchUnits[i];
+        const glm::mat4& transform = unit.transform;
+        glm::vec3 center = glm::vec3(transform * glm::vec4(unit.mesh->boundsCenter, 1.0f));
+        float scale = std::max({ glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2])) });
+        if (IsSphereInFrustum(frustumPlanes, center, unit.mesh->boundsRadius * scale))
+        {
+            m_renderBatchUnits[numVisibleUnits++] = unit;
+        }
+        else
+        {
+            culledUnits[numCulledUnits++] = unit;
+        }
+    }
+    std::copy(culledUnits, culledUnits + numCulledUnits, m_renderBatchUnits.begin() + numVisibleUnits);
+    for (size_t i = numVisibleUnits; i < m_renderBatchUnits.size(); ++i)
+    {
+        ++m_frameStatistics.culledMeshCount;
+        m_frameStatistics.culledTriangleCount += static_cast<uint32_t>(m_renderBatchUnits[i].mesh->indices.size() / 3);
+    }
 
-    // Bind per-frame descriptor set
-    FrameUBO frameUBO = {};
-    frameUBO.proj = projectionCorrectionMatrix * projMatrix;
-    frameUBO.view = viewMatrix;
+    // Sort the visible units by pipeline features. Since the alpha test is the highest feature bit,
+    // the opaque units end up in front of the alpha-masked ones, and pipeline binds are minimized.
+    // The pipelines are looked up here rather than while recording, since a missing permutation is created
+    // on first use and the draws may be recorded on several threads.
+    for (size_t i = 0; i < numVisibleUnits; ++i)
+    {
+        uint32_t features = GetPipelineFeatures(m_renderBatchUnits[i].mesh);
+        m_renderBatchUnits[i].pipelineFeatures = m_isAlphaMaskSplitEnabled ? features : (features | PIPELINE_FEATURE_ALPHA_TEST);
+        m_renderBatchUnits[i].pipeline = GetPipeline(m_renderBatchUnits[i].pipelineFeatures);
+        if (m_renderBatchUnits[i].pipeline == VK_NULL_HANDLE)
+        {
+            m_renderBatchUnits[i].pipeline = GetPipeline(PIPELINE_FEATURE_ALL);
+        }
+    }
+    if (m_isAlphaMaskSplitEnabled)
+    {
+        // There are only a few feature combinations, so a counting sort keeps the order stable
+        // without the heap buffer of std::stable_sort
+        size_t featureOffsets[PIPELINE_FEATURE_ALL + 2] = {};
+        for (size_t i = 0; i < numVisibleUnits; ++i)
+        {
+            ++featureOffsets[m_renderBatchUnits[i].pipelineFeatures + 1];
+        }
+        for (size_t features = 1; features < std::size(featureOffsets); ++features)
+        {
+            featureOffsets[features] += featureOffsets[features - 1];
+        }
 
-    void* data = m_perFrameUBOs[imageIndex].MapMemory(0, sizeof(FrameUBO));
-    memcpy(data, &frameUBO, sizeof(FrameUBO));
-    m_perFrameUBOs[imageIndex].UnmapMemory();
+        RenderBatchUnit* sortedUnits = frameArena.Allocate<RenderBatchUnit>(numVisibleUnits);
+        for (size_t i = 0; i < numVisibleUnits; ++i)
+        {
+            sortedUnits[featureOffsets[m_renderBatchUnits[i].pipelineFeatures]++] = m_renderBatchUnits[i];
+        }
+        std::copy(sortedUnits, sortedUnits + numVisibleUnits, m_renderBatchUnits.begin());
+    }
 
     VkDeviceSize vertexBufferOffset = 0;
     VkDeviceSize indexBufferOffset = 0;
-    ObjectUBO* objectUBOData = reinterpret_cast<ObjectUBO*>(m_perObjectUBOs[imageIndex].MapMemory(0, sizeof(ObjectUBO) * MAX_OBJECTS));
-    for (size_t i = 0; i < m_renderBatchUnits.size(); ++i)
+    m_numUploadedBatchUnits = 0;
+    for (size_t i = 0; i < numVisibleUnits; ++i)
     {
         Mesh* mesh = m_renderBatchUnits[i].mesh;
+        VkDeviceSize vertexBufferSize = mesh->vertices.size() * sizeof(Vertex);
+        VkDeviceSize indexBufferSize = mesh->indices.size() * sizeof(uint32_t);
 
-        objectUBOData[i].model = m_renderBatchUnits[i].transform;
+        // Whatever does not fit in the per-frame buffers is not drawn
+        if ((i >= MAX_OBJECTS)
+            || (vertexBufferOffset + vertexBufferSize > sizeof(Vertex) * MAX_VERTICES)
+            || (indexBufferOffset + indexBufferSize > sizeof(uint32_t) * MAX_INDICES))
+        {
+            m_frameStatistics.droppedDrawCount = static_cast<uint32_t>(numVisibleUnits - i);
+            if (!m_hasDroppedDraws)
+            {
+                std::cout << "Dropped " << m_frameStatistics.droppedDrawCount << " of " << numVisibleUnits
+                    << " draws that do not fit in the per-frame buffers" << std::endl;
+                m_hasDroppedDraws = true;
+            }
+            break;
+        }
 
-        VkDeviceSize vertexBufferSize = mesh->vertices.size() * sizeof(Vertex);
-        void* data = m_vertexStagingBuffer.MapMemory(vertexBufferOffset, vertexBufferSize);
+        void* data = frameData.vertexStagingBuffer.MapMemory(vertexBufferOffset, vertexBufferSize);
         memcpy(data, mesh->vertices.data(), vertexBufferSize);
-        m_vertexStagingBuffer.UnmapMemory();
-        
-        VkBuffer vertexBuffers[] = { m_frameInFlightData[imageIndex].vertexBuffer.GetHandle() };
-        VkDeviceSize offsets[] = { vertexBufferOffset };
-        vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+        frameData.vertexStagingBuffer.UnmapMemory();
+        m_renderBatchUnits[i].vertexBufferOffset = vertexBufferOffset;
         vertexBufferOffset += vertexBufferSize;
 
-        VkDeviceSize indexBufferSize = mesh->indices.size() * sizeof(uint32_t);
-        data = m_indexStagingBuffer.MapMemory(indexBufferOffset, indexBufferSize);
+        data = frameData.indexStagingBuffer.MapMemory(indexBufferOffset, indexBufferSize);
         memcpy(data, mesh->indices.data(), indexBufferSize);
-        m_indexStagingBuffer.UnmapMemory();
-
-        vkCmdBindIndexBuffer(commandBuffer, m_frameInFlightData[imageIndex].indexBuffer.GetHandle(), indexBufferOffset, VK_INDEX_TYPE_UINT32);
+        frameData.indexStagingBuffer.UnmapMemory();
+        m_renderBatchUnits[i].indexBufferOffset = indexBufferOffset;
         indexBufferOffset += indexBufferSize;
-        
-        std::string emissiveTexturePath = (mesh->emissiveMapFilePaths.size() > 0) 
-            ? mesh->emissiveMapFilePaths[0] : DEFAULT_EMISSIVE_MAP_PATH;
-        VkDescriptorSet emissiveTextureDescriptorSet = m_textureToDescriptorSetMap[emissiveTexturePath];
-        std::string diffuseTexturePath = (mesh->diffuseMapFilePaths.size() > 0) 
-            ? mesh->diffuseMapFilePaths[0] : DEFAULT_DIFFUSE_MAP_PATH;
-        VkDescriptorSet diffuseTextureDescriptorSet = m_textureToDescriptorSetMap[diffuseTexturePath];
-        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vkPipelineLayout, 2, 1, &emissiveTextureDescriptorSet, 0, nullptr);
-        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vkPipelineLayout, 3, 1, &diffuseTextureDescriptorSet, 0, nullptr);
-
-        // Draw the geometry
-        // vertexCount -> instanceCount -> firstVertex -> firstInstance
-        //vkCmdDraw(m_vkCommandBuffers[i], static_cast<uint32_t>(m_vertices.size()), 1, 0, 0);
-        // Draw the geometry using the index buffer
-        vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(mesh->indices.size()), 1, 0, 0, static_cast<uint32_t>(i));
+
+        ++m_numUploadedBatchUnits;
+    }
+
+    m_numOpaqueBatchUnits = 0;
+    while ((m_numOpaqueBatchUnits < m_numUploadedBatchUnits)
+        && !(m_renderBatchUnits[m_numOpaqueBatchUnits].pipelineFeatures & PIPELINE_FEATURE_ALPHA_TEST))
+    {
+        ++m_numOpaqueBatchUnits;
+    }
+
+    if (m_numUploadedBatchUnits == 0)
+    {
+        return;
     }
-    m_perObjectUBOs[imageIndex].UnmapMemory();
 
-    // vertexBufferOffset and indexBufferOffset should point to the data location just after all the data, which means
-    // it's also the size.
-    CopyBuffer(m_vertexStagingBuffer.GetHandle(), m_frameInFlightData[imageIndex].vertexBuffer.GetHandle(), vertexBufferOffset);
-    CopyBuffer(m_indexStagingBuffer.GetHandle(), m_frameInFlightData[imageIndex].indexBuffer.GetHandle(), indexBufferOffset);
+    // vertexBufferOffset and indexBufferOffset point to the data location just after all the data, which means
+    // they are also the sizes.
+    VkBufferCopy copyRegion = {};
+    copyRegion.size = vertexBufferOffset;
+    vkCmdCopyBuffer(commandBuffer, frameData.vertexStagingBuffer.GetHandle(), frameData.vertexBuffer.GetHandle(), 1, &copyRegion);
+    copyRegion.size = indexBufferOffset;
+    vkCmdCopyBuffer(commandBuffer, frameData.indexStagingBuffer.GetHandle(), frameData.indexBuffer.GetHandle(), 1, &copyRegion);
+    m_frameStatistics.uploadedBytes += vertexBufferOffset + indexBufferOffset;
+
+    // The draws must not read the buffers before the copies finish
+    VkMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
 }
 
 /**
- * @brief Cleans up all resources used by the RenderSystem
+ * @brief Renders all entities with a MeshComponent and a TransformComponent. When recording in parallel,
+ * the render pass must have been begun with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS.
+ * @param[in] commandBuffer Vulkan command buffer
+ * @param[in] frameIndex Index of the frame in flight
+ * @param[in] extent Size of the render area
+ * @param[in] viewMatrix View matrix
+ * @param[in] projMatrix Projection matrix
  */
-void Renderer::Cleanup()
+void Renderer::Render(VkCommandBuffer commandBuffer, const uint32_t& frameIndex, const VkExtent2D& extent, const glm::mat4& viewMatrix, const glm::mat4& projMatrix)
 {
-    for (auto& pair : m_textureToVulkanImageViewMap)
-    {
-        pair.second.Cleanup();
-    }
-    for (auto& pair : m_textureToVulkanImageMap)
-    {
-        pair.second.Cleanup();
-    }
+    PROFILE_FUNCTION();
 
-    for (size_t i = 0; i < m_perFrameUBOs.size(); ++i)
+    if (m_numUploadedBatchUnits == 0)
     {
-        m_perFrameUBOs[i].Cleanup();
-    }
-    m_perFrameUBOs.clear();
-    for (size_t i = 0; i < m_perObjectUBOs.size(); ++i)
-    {
-        m_perObjectUBOs[i].Cleanup();
+        return;
     }
-    m_perObjectUBOs.clear();
+    
+    glm::mat4 projectionCorrectionMatrix(1.0f); // Since Vulkan's NDC has the +y-axis going downwards, we need to flip the y-axis
+    projectionCorrectionMatrix[1][1] = -1.0f;
 
-    for (size_t i = 0; i < m_frameInFlightData.size(); ++i)
+    // Bind per-frame descriptor set
+    FrameUBO frameUBO = {};
+    frameUBO.proj = projectionCorrectionMatrix * projMatrix;
+    frameUBO.view = viewMatrix;
+
+    // The per-object allocation covers the whole descriptor range, which must stay within the frame's region
+    void* frameUBOData = m_uniformRingBuffer.Allocate(sizeof(FrameUBO), m_uniformBufferAlignment, m_frameUBOOffset);
+    ObjectUBO* objectUBOData = static_cast<ObjectUBO*>(m_uniformRingBuffer.Allocate(sizeof(ObjectUBO) * MAX_OBJECTS, m_uniformBufferAlignment, m_objectUBOOffset));
+    if ((frameUBOData == nullptr) || (objectUBOData == nullptr))
     {
-        m_frameInFlightData[i].vertexBuffer.Cleanup();
-        m_vertexStagingBuffer.Cleanup();
-        m_frameInFlightData[i].indexBuffer.Cleanup();
-        m_indexStagingBuffer.Cleanup();
+        std::cout << "Failed to allocate uniform data from the ring buffer!" << std::endl;
+        return;
     }
-    m_frameInFlightData.clear();
+    memcpy(frameUBOData, &frameUBO, sizeof(FrameUBO));
+    m_frameStatistics.uploadedBytes += sizeof(FrameUBO) + sizeof(ObjectUBO) * m_numUploadedBatchUnits;
 
-    if (m_vkDescriptorPool != VK_NULL_HANDLE)
+    // Opaque meshes are drawn first with discard-free pipelines, which keeps early depth testing enabled.
+    // The alpha-masked meshes drawn after them are then rejected before shading wherever they are hidden.
+    const char* passNames[] = { "Opaque", "Masked" };
+    const size_t passBegins[] = { 0, m_numOpaqueBatchUnits };
+    const size_t passEnds[] = { m_numOpaqueBatchUnits, m_numUploadedBatchUnits };
+
+    if (!IsRecordingInParallel())
     {
-        vkDestroyDescriptorPool(VulkanContext::GetLogicalDevice(), m_vkDescriptorPool, nullptr);
-        m_vkDescriptorPool = VK_NULL_HANDLE;
+        uint32_t modelScope = (m_gpuProfiler != nullptr) ? m_gpuProfiler->BeginScope(commandBuffer, "Model") : 0;
+        for (size_t pass = 0; pass < std::size(passEnds); ++pass)
+        {
+            if (passBegins[pass] == passEnds[pass])
+            {
+                continue;
+            }
+
+            uint32_t passScope = (m_gpuProfiler != nullptr) ? m_gpuProfiler->BeginScope(commandBuffer, passNames[pass]) : 0;
+            RecordDraws(commandBuffer, frameIndex, extent, passBegins[pass], passEnds[pass], objectUBOData, m_frameStatistics);
+            if (m_gpuProfiler != nullptr)
+            {
+                m_gpuProfiler->EndScope(commandBuffer, passScope);
+            }
+        }
+        if (m_gpuProfiler != nullptr)
+        {
+            m_gpuProfiler->EndScope(commandBuffer, modelScope);
+        }
+        return;
     }
 
-    // Destroy texture sampler
-    if (m_vkTextureSampler != VK_NULL_HANDLE)
+    // The previous submission of this frame in flight has completed, so its secondary command buffers can be reused
+    m_commandRecorder.BeginFrame(frameIndex);
+
+    VkCommandBufferInheritanceInfo inheritanceInfo = {};
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritanceInfo.renderPass = m_vkRenderPass;
+    inheritanceInfo.subpass = 0;
+    inheritanceInfo.framebuffer = VK_NULL_HANDLE; // The framebuffer is optional, and not known to the renderer
+
+    // Split each pass into at most one chunk per thread, without making chunks too small to be worth a command buffer.
+    // Chunks do not cross passes, so that the pass timings stay exact. The per-frame arrays live in the frame arena.
+    FrameArena& frameArena = m_frameArenas[frameIndex];
+    const size_t maxNumChunks = std::size(passEnds) * m_commandRecorder.GetThreadCount();
+    std::pair<size_t, size_t>* chunkRanges = frameArena.Allocate<std::pair<size_t, size_t>>(maxNumChunks);
+    size_t* passFirstChunks = frameArena.Allocate<size_t>(std::size(passEnds) + 1);
+    size_t numChunks = 0;
+    for (size_t pass = 0; pass < std::size(passEnds); ++pass)
     {
-        vkDestroySampler(VulkanContext::GetLogicalDevice(), m_vkTextureSampler, nullptr);
-        m_vkTextureSampler = VK_NULL_HANDLE;
+        passFirstChunks[pass] = numChunks;
+
+        size_t numDraws = passEnds[pass] - passBegins[pass];
+        size_t numPassChunks = std::min((numDraws + MIN_DRAWS_PER_CHUNK - 1) / MIN_DRAWS_PER_CHUNK, static_cast<size_t>(m_commandRecorder.GetThreadCount()));
+        for (size_t chunk = 0; chunk < numPassChunks; ++chunk)
+        {
+            chunkRanges[numChunks++] = { passBegins[pass] + numDraws * chunk / numPassChunks, passBegins[pass] + numDraws * (chunk + 1) / numPassChunks };
+        }
     }
+    passFirstChunks[std::size(passEnds)] = numChunks;
+
+    // Each chunk counts into its own statistics, which are summed once all threads are done
+    ChunkRecordingJob job = {};
+    job.frameIndex = frameIndex;
+    job.extent = extent;
+    job.chunkRanges = chunkRanges;
+    job.objectUBOData = objectUBOData;
+    job.chunkStatistics = frameArena.Allocate<FrameStatistics>(numChunks);
+    VkCommandBuffer* chunkCommandBuffers = frameArena.Allocate<VkCommandBuffer>(numChunks);
+
+    // Capturing only two pointers keeps the function within std::function's inline storage, so recording does not allocate
+    bool isRecorded = m_commandRecorder.Record(frameIndex, static_cast<uint32_t>(numChunks), inheritanceInfo,
+        [this, &job](const uint32_t& chunkIndex, VkCommandBuffer chunkCommandBuffer)
+        {
+            RecordDraws(chunkCommandBuffer, job.frameIndex, job.extent, job.chunkRanges[chunkIndex].first, job.chunkRanges[chunkIndex].second,
+                job.objectUBOData, job.chunkStatistics[chunkIndex]);
+        },
+        chunkCommandBuffers);
 
-    // Destroy pipeline
-    if (m_vkPipeline != VK_NULL_HANDLE)
+    if (!isRecorded)
     {
-        vkDestroyPipeline(VulkanContext::GetLogicalDevice(), m_vkPipeline, nullptr);
-        m_vkPipeline = VK_NULL_HANDLE;
+        std::cout << "Failed to record draws in parallel!" << std::endl;
+        return;
     }
 
-    // Destroy pipeline layout
-    if (m_vkPipelineLayout != VK_NULL_HANDLE)
+    for (size_t chunk = 0; chunk < numChunks; ++chunk)
     {
-        vkDestroyPipelineLayout(VulkanContext::GetLogicalDevice(), m_vkPipelineLayout, nullptr);
-        m_vkPipelineLayout = VK_NULL_HANDLE;
+        const FrameStatistics& statistics = job.chunkStatistics[chunk];
+        m_frameStatistics.drawCount += statistics.drawCount;
+        m_frameStatistics.triangleCount += statistics.triangleCount;
+        m_frameStatistics.maskedDrawCount += statistics.maskedDrawCount;
+        m_frameStatistics.maskedTriangleCount += statistics.maskedTriangleCount;
+        m_frameStatistics.pipelineBindCount += statistics.pipelineBindCount;
+        m_frameStatistics.descriptorSetBindCount += statistics.descriptorSetBindCount;
     }
 
-    if (m_vkPerFrameDescriptorSetLayout != VK_NULL_HANDLE)
+    // Nothing but vkCmdExecuteCommands can be recorded into the primary command buffer inside this subpass,
+    // so the GPU timestamps are written by small secondary command buffers placed between the chunks
+    VkCommandBuffer* commandBuffers = frameArena.Allocate<VkCommandBuffer>(numChunks + std::size(passEnds) + 1);
+    uint32_t numCommandBuffers = 0;
+    VkCommandBuffer markerCommandBuffer = VK_NULL_HANDLE;
+    uint32_t modelScope = 0;
+    if (m_gpuProfiler != nullptr)
     {
-        vkDestroyDescriptorSetLayout(VulkanContext::GetLogicalDevice(), m_vkPerFrameDescriptorSetLayout, nullptr);
-        m_vkPerFrameDescriptorSetLayout = VK_NULL_HANDLE;
+        markerCommandBuffer = m_commandRecorder.BeginSecondary(frameIndex, inheritanceInfo);
+        modelScope = m_gpuProfiler->BeginScope(markerCommandBuffer, "Model");
     }
-    if (m_vkPerObjectDescriptorSetLayout != VK_NULL_HANDLE)
+    for (size_t pass = 0; pass < std::size(passEnds); ++pass)
     {
-        vkDestroyDescriptorSetLayout(VulkanContext::GetLogicalDevice(), m_vkPerObjectDescriptorSetLayout, nullptr);
-        m_vkPerObjectDescriptorSetLayout = VK_NULL_HANDLE;
+        if (passFirstChunks[pass] == passFirstChunks[pass + 1])
+        {
+            continue;
+        }
+
+        uint32_t passScope = 0;
+        if (m_gpuProfiler != nullptr)
+        {
+            passScope = m_gpuProfiler->BeginScope(markerCommandBuffer, passNames[pass]);
+            vkEndCommandBuffer(markerCommandBuffer);
+            commandBuffers[numCommandBuffers++] = markerCommandBuffer;
+            markerCommandBuffer = m_commandRecorder.BeginSecondary(frameIndex, inheritanceInfo);
+        }
+        for (size_t chunk = passFirstChunks[pass]; chunk < passFirstChunks[pass + 1]; ++chunk)
+        {
+            commandBuffers[numCommandBuffers++] = chunkCommandBuffers[chunk];
+        }
+        if (m_gpuProfiler != nullptr)
+        {
+            m_gpuProfiler->EndScope(markerCommandBuffer, passScope);
+        }
     }
-    if (m_vkSingleTextureDescriptorSetLayout != VK_NULL_HANDLE)
+    if (m_gpuProfiler != nullptr)
     {
-        vkDestroyDescriptorSetLayout(VulkanContext::GetLogicalDevice(), m_vkSingleTextureDescriptorSetLayout, nullptr);
-        m_vkSingleTextureDescriptorSetLayout = VK_NULL_HANDLE;
+        m_gpuProfiler->EndScope(markerCommandBuffer, modelScope);
+        vkEndCommandBuffer(markerCommandBuffer);
+        commandBuffers[numCommandBuffers++] = markerCommandBuffer;
     }
+
+    vkCmdExecuteCommands(commandBuffer, numCommandBuffers, commandBuffers);
 }
 
 /**
- * @brief Create descriptor set layout.
- * @return Returns true if the creation was successful. Returns false otherwise.
+ * @brief Checks whether the draws are recorded into secondary command buffers on several threads.
+ * @return Returns true if the draws are recorded in parallel. Returns false otherwise.
  */
-bool Renderer::CreateDescriptorSetLayout()
+bool Renderer::IsRecordingInParallel() const
+{
+    return (m_commandRecorder.GetThreadCount() > 1);
+}
+
+/**
+ * @brief Sets the render pass that pipelines and secondary command buffers are created for,
+ * after the render pass has been recreated. The new render pass must be compatible with the old one.
+ * @param[in] renderPass Vulkan render pass
+ */
+void Renderer::SetRenderPass(VkRenderPass renderPass)
+{
+    m_vkRenderPass = renderPass;
+}
+
+/**
+ * @brief Sets the GPU profiler used to time the opaque and alpha-masked passes.
+ * @param[in] gpuProfiler GPU profiler, or nullptr to disable the pass timings
+ */
+void Renderer::SetGpuProfiler(GpuProfiler* gpuProfiler)
+{
+    m_gpuProfiler = gpuProfiler;
+}
+
+/**
+ * @brief Enables or disables drawing opaque meshes with discard-free pipelines before the alpha-masked meshes.
+ * When disabled, every mesh is drawn in batch order with the alpha test, for comparison.
+ * @param[in] isEnabled Flag indicating whether the split is enabled
+ */
+void Renderer::SetAlphaMaskSplitEnabled(const bool& isEnabled)
+{
+    m_isAlphaMaskSplitEnabled = isEnabled;
+}
+
+/**
+ * @brief Checks whether opaque meshes are drawn with discard-free pipelines before the alpha-masked meshes.
+ * @return Returns true if the split is enabled. Returns false otherwise.
+ */
+bool Renderer::IsAlphaMaskSplitEnabled() const
+{
+    return m_isAlphaMaskSplitEnabled;
+}
+
+/**
+ * @brief Gets the counters describing the work submitted in the last rendered frame.
+ * @return Frame statistics
+ */
+const Renderer::FrameStatistics& Renderer::GetFrameStatistics() const
+{
+    return m_frameStatistics;
+}
+
+/**
+ * @brief Gets the GPU memory allocated by the renderer, by category.
+ * @return Memory statistics
+ */
+const Renderer::MemoryStatistics& Renderer::GetMemoryStatistics() const
+{
+    return m_memoryStatistics;
+}
+
+/**
+ * @brief Gets the number of frames rendered so far.
+ * @return Frame number
+ */
+uint64_t Renderer::GetFrameNumber() const
+{
+    return m_frameNumber;
+}
+
+/**
+ * @brief Gets the number of graphics pipelines created so far, one per combination of pipeline features in use.
+ * @return Number of graphics pipelines
+ */
+uint32_t Renderer::GetPipelineCount() const
+{
+    return static_cast<uint32_t>(m_vkPipelines.size());
+}
+
+/**
+ * @brief Gets the total time spent creating graphics pipelines, which is lower with a warm pipeline cache.
+ * @return Pipeline creation time (in milliseconds)
+ */
+double Renderer::GetPipelineCreationTime() const
+{
+    return m_pipelineCreationTime;
+}
+
+/**
+ * @brief Writes the frame, memory and pipeline statistics to a JSON file.
+ * @param[in] filePath Output file path
+ * @return Returns true if the file was written successfully. Returns false otherwise.
+ */
+bool Renderer::WriteStatisticsToFile(const std::string& filePath) const
+{
+    std::ofstream file(filePath);
+    if (file.fail())
+    {
+        std::cout << "Failed to open " << filePath << " for writing!" << std::endl;
+        return false;
+    }
+
+    file << "{" << std::endl;
+    file << "  \"frameNumber\": " << m_frameNumber << "," << std::endl;
+    file << "  \"frame\": {" << std::endl;
+    file << "    \"drawCount\": " << m_frameStatistics.drawCount << "," << std::endl;
+    file << "    \"triangleCount\": " << m_frameStatistics.triangleCount << "," << std::endl;
+    file << "    \"pipelineBindCount\": " << m_frameStatistics.pipelineBindCount << "," << std::endl;
+    file << "    \"descriptorSetBindCount\": " << m_frameStatistics.descriptorSetBindCount << "," << std::endl;
+    file << "    \"culledMeshCount\": " << m_frameStatistics.culledMeshCount << "," << std::endl;
+    file << "    \"culledTriangleCount\": " << m_frameStatistics.culledTriangleCount << "," << std::endl;
+    file << "    \"droppedDrawCount\": " << m_frameStatistics.droppedDrawCount << "," << std::endl;
+    file << "    \"maskedDrawCount\": " << m_frameStatistics.maskedDrawCount << "," << std::endl;
+    file << "    \"maskedTriangleCount\": " << m_frameStatistics.maskedTriangleCount << "," << std::endl;
+    file << "    \"uploadedBytes\": " << m_frameStatistics.uploadedBytes << std::endl;
+    file << "  }," << std::endl;
+    file << "  \"memory\": {" << std::endl;
+    file << "    \"geometryBufferBytes\": " << m_memoryStatistics.geometryBufferBytes << "," << std::endl;
+    file << "    \"stagingBufferBytes\": " << m_memoryStatistics.stagingBufferBytes << "," << std::endl;
+    file << "    \"uniformBufferBytes\": " << m_memoryStatistics.uniformBufferBytes << "," << std::endl;
+    file << "    \"textureBytes\": " << m_memoryStatistics.textureBytes << "," << std::endl;
+    file << "    \"textureCount\": " << m_memoryStatistics.textureCount << std::endl;
+    file << "  }," << std::endl;
+    file << "  \"pipelines\": {" << std::endl;
+    file << "    \"pipelineCount\": " << m_vkPipelines.size() << "," << std::endl;
+    file << "    \"creationTime\": " << m_pipelineCreationTime << std::endl;
+    file << "  }" << std::endl;
+    file << "}" << std::endl;
+
+    return !file.fail();
+}
+
+/**
+ * @brief Cleans up all resources used by the RenderSystem
+ */
+void Renderer::Cleanup()
+{
+    m_textureStreamer.Stop();
+    m_commandRecorder.Cleanup();
+
+    DestroyRetiredTextureViews(true);
+    ReleaseCompletedUploads(true);
+    for (auto& pair : m_textures)
+    {
+        pair.second.imageView.Cleanup();
+        pair.second.image.Cleanup();
+    }
+    m_textures.clear();
+    m_textureContentHashes.clear();
+    m_requestedTextures.clear();
+    m_numDeduplicatedTextures = 0;
+    m_memoryStatistics = {};
+
+    m_uniformRingBuffer.Cleanup();
+    m_frameArenas.clear();
+
+    for (size_t i = 0; i < m_frameInFlightData.size(); ++i)
+    {
+        m_frameInFlightData[i].vertexBuffer.Cleanup();
+        m_frameInFlightData[i].vertexStagingBuffer.Cleanup();
+        m_frameInFlightData[i].indexBuffer.Cleanup();
+        m_frameInFlightData[i].indexStagingBuffer.Cleanup();
+    }
+    m_frameInFlightData.clear();
+
+    if (m_vkDescriptorPool != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorPool(VulkanContext::GetLogicalDevice(), m_vkDescriptorPool, nullptr);
+        m_vkDescriptorPool = VK_NULL_HANDLE;
+    }
+
+    // Destroy texture sampler
+    if (m_vkTextureSampler != VK_NULL_HANDLE)
+    {
+        vkDestroySampler(VulkanContext::GetLogicalDevice(), m_vkTextureSampler, nullptr);
+        m_vkTextureSampler = VK_NULL_HANDLE;
+    }
+
+    // Destroy pipelines
+    for (auto& pair : m_vkPipelines)
+    {
+        vkDestroyPipeline(VulkanContext::GetLogicalDevice(), pair.second, nullptr);
+    }
+    m_vkPipelines.clear();
+    m_pipelineCreationTime = 0.0;
+
+    // Destroy shader modules
+    if (m_vkVertexShaderModule != VK_NULL_HANDLE)
+    {
+        vkDestroyShaderModule(VulkanContext::GetLogicalDevice(), m_vkVertexShaderModule, nullptr);
+        m_vkVertexShaderModule = VK_NULL_HANDLE;
+    }
+    if (m_vkFragmentShaderModule != VK_NULL_HANDLE)
+    {
+        vkDestroyShaderModule(VulkanContext::GetLogicalDevice(), m_vkFragmentShaderModule, nullptr);
+        m_vkFragmentShaderModule = VK_NULL_HANDLE;
+    }
+
+    // Destroy pipeline layout
+    if (m_vkPipelineLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyPipelineLayout(VulkanContext::GetLogicalDevice(), m_vkPipelineLayout, nullptr);
+        m_vkPipelineLayout = VK_NULL_HANDLE;
+    }
+
+    if (m_vkPerFrameDescriptorSetLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorSetLayout(VulkanContext::GetLogicalDevice(), m_vkPerFrameDescriptorSetLayout, nullptr);
+        m_vkPerFrameDescriptorSetLayout = VK_NULL_HANDLE;
+    }
+    if (m_vkPerObjectDescriptorSetLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorSetLayout(VulkanContext::GetLogicalDevice(), m_vkPerObjectDescriptorSetLayout, nullptr);
+        m_vkPerObjectDescriptorSetLayout = VK_NULL_HANDLE;
+    }
+    if (m_vkSingleTextureDescriptorSetLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorSetLayout(VulkanContext::GetLogicalDevice(), m_vkSingleTextureDescriptorSetLayout, nullptr);
+        m_vkSingleTextureDescriptorSetLayout = VK_NULL_HANDLE;
+    }
+}
+
+/**
+ * @brief Checks whether a bounding sphere intersects the view frustum.
+ * @param[in] frustumPlanes Frustum planes, with their normals pointing inwards
+ * @param[in] center Sphere center in world space
+ * @param[in] radius Sphere radius
+ * @return Returns true if the sphere is at least partially inside the frustum. Returns false otherwise.
+ */
+bool Renderer::IsSphereInFrustum(const std::array<glm::vec4, 5>& frustumPlanes, const glm::vec3& center, const float& radius)
+{
+    for (size_t i = 0; i < frustumPlanes.size(); ++i)
+    {
+        if (glm::dot(glm::vec3(frustumPlanes[i]), center) + frustumPlanes[i].w < -radius)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Records the draws of a range of render batch units. Only reads shared renderer state,
+ * so ranges can be recorded concurrently into different command buffers.
+ * @param[in] commandBuffer Vulkan command buffer, inside the render pass
+ * @param[in] frameIndex Index of the frame in flight
+ * @param[in] extent Size of the render area
+ * @param[in] begin Index of the first render batch unit
+ * @param[in] end Index after the last render batch unit
+ * @param[out] objectUBOData Mapped per-object storage buffer, written at the indices of the range
+ * @param[in,out] statistics Counters that the draws are added to
+ */
+void Renderer::RecordDraws(VkCommandBuffer commandBuffer, const uint32_t& frameIndex, const VkExtent2D& extent, const size_t& begin, const size_t& end,
+    ObjectUBO* objectUBOData, FrameStatistics& statistics)
+{
+    // The default paths are turned into strings once, instead of for every draw
+    static const std::string defaultEmissiveMapPath = DEFAULT_EMISSIVE_MAP_PATH;
+    static const std::string defaultDiffuseMapPath = DEFAULT_DIFFUSE_MAP_PATH;
+
+    // Secondary command buffers do not inherit dynamic state, so each range sets the viewport and scissors itself
+    VkViewport viewport = {};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = static_cast<float>(extent.width);
+    viewport.height = static_cast<float>(extent.height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+
+    VkRect2D scissor = {};
+    scissor.offset = { 0, 0 };
+    scissor.extent = extent;
+
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vkPipelineLayout, 0, 1, &m_vkPerFrameDescriptorSet, 1, &m_frameUBOOffset);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vkPipelineLayout, 1, 1, &m_vkPerObjectDescriptorSet, 1, &m_objectUBOOffset);
+    statistics.descriptorSetBindCount += 2;
+
+    VkPipeline boundPipeline = VK_NULL_HANDLE;
+    VkDescriptorSet boundEmissiveTextureDescriptorSet = VK_NULL_HANDLE;
+    VkDescriptorSet boundDiffuseTextureDescriptorSet = VK_NULL_HANDLE;
+    for (size_t i = begin; i < end; ++i)
+    {
+        Mesh* mesh = m_renderBatchUnits[i].mesh;
+
+        objectUBOData[i].model = m_renderBatchUnits[i].transform;
+
+        // Bind the cheapest pipeline permutation for the mesh's material. All permutations share
+        // the pipeline layout, so the bound descriptor sets stay valid across pipeline binds.
+        if (m_renderBatchUnits[i].pipeline != boundPipeline)
+        {
+            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_renderBatchUnits[i].pipeline);
+            boundPipeline = m_renderBatchUnits[i].pipeline;
+            ++statistics.pipelineBindCount;
+        }
+
+        VkBuffer vertexBuffers[] = { m_frameInFlightData[frameIndex].vertexBuffer.GetHandle() };
+        VkDeviceSize offsets[] = { m_renderBatchUnits[i].vertexBufferOffset };
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+
+        vkCmdBindIndexBuffer(commandBuffer, m_frameInFlightData[frameIndex].indexBuffer.GetHandle(), m_renderBatchUnits[i].indexBufferOffset, VK_INDEX_TYPE_UINT32);
+    
+        const std::string& emissiveTexturePath = (mesh->emissiveMapFilePaths.size() > 0)
+            ? mesh->emissiveMapFilePaths[0] : defaultEmissiveMapPath;
+        VkDescriptorSet emissiveTextureDescriptorSet = GetTextureDescriptorSet(emissiveTexturePath, defaultEmissiveMapPath);
+        const std::string& diffuseTexturePath = (mesh->diffuseMapFilePaths.size() > 0)
+            ? mesh->diffuseMapFilePaths[0] : defaultDiffuseMapPath;
+        VkDescriptorSet diffuseTextureDescriptorSet = GetTextureDescriptorSet(diffuseTexturePath, defaultDiffuseMapPath);
+
+        // Meshes sharing a texture (e.g., through a texture atlas) do not need to rebind it
+        if (emissiveTextureDescriptorSet != boundEmissiveTextureDescriptorSet)
+        {
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vkPipelineLayout, 2, 1, &emissiveTextureDescriptorSet, 0, nullptr);
+            boundEmissiveTextureDescriptorSet = emissiveTextureDescriptorSet;
+            ++statistics.descriptorSetBindCount;
+        }
+        if (diffuseTextureDescriptorSet != boundDiffuseTextureDescriptorSet)
+        {
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vkPipelineLayout, 3, 1, &diffuseTextureDescriptorSet, 0, nullptr);
+            boundDiffuseTextureDescriptorSet = diffuseTextureDescriptorSet;
+            ++statistics.descriptorSetBindCount;
+        }
+
+        // Draw the geometry using the index buffer
+        // indexCount -> instanceCount -> firstIndex -> vertexOffset -> firstInstance
+        vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(mesh->indices.size()), 1, 0, 0, static_cast<uint32_t>(i));
+
+        ++statistics.drawCount;
+        statistics.triangleCount += static_cast<uint32_t>(mesh->indices.size() / 3);
+        if (i >= m_numOpaqueBatchUnits)
+        {
+            ++statistics.maskedDrawCount;
+            statistics.maskedTriangleCount += static_cast<uint32_t>(mesh->indices.size() / 3);
+        }
+    }
+}
+
+/**
+ * @brief Create descriptor set layout.
+ * @return Returns true if the creation was successful. Returns false otherwise.
+ */
+bool Renderer::CreateDescriptorSetLayout()
 {
     // Descriptor set layout for the per-frame descriptor set
     VkDescriptorSetLayoutBinding perFrameBinding = {};
     perFrameBinding.binding = 0;
-    perFrameBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    perFrameBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC; // Offset into the uniform ring buffer, given at bind time
     perFrameBinding.descriptorCount = 1;
     perFrameBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT; // We'll use the UBO in the vertex shader
     perFrameBinding.pImmutableSamplers = nullptr;
@@ -461,7 +1293,7 @@ bool Renderer::CreateDescriptorSetLayout()
     // Descriptor set layout for the per-object descriptor set
     VkDescriptorSetLayoutBinding perObjectBinding = {};
     perObjectBinding.binding = 0;
-    perObjectBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    perObjectBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
     perObjectBinding.descriptorCount = 1;
     perObjectBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT; // We'll use the UBO in the vertex shader
     perObjectBinding.pImmutableSamplers = nullptr;
@@ -515,10 +1347,45 @@ bool Renderer::CreateDescriptorSetLayout()
 }
 
 /**
- * @brief Create Vulkan graphics pipeline
+ * @brief Creates the pipeline layout and loads the shader modules shared by all pipeline permutations.
+ * @return Returns true if the creation was successful. Returns false otherwise.
+ */
+bool Renderer::CreatePipelineLayout()
+{
+    // Create pipeline layout
+    std::array<VkDescriptorSetLayout, 4> descriptorSetLayouts = { m_vkPerFrameDescriptorSetLayout, m_vkPerObjectDescriptorSetLayout, m_vkSingleTextureDescriptorSetLayout, m_vkSingleTextureDescriptorSetLayout };
+    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {};
+    pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutCreateInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
+    pipelineLayoutCreateInfo.pSetLayouts = descriptorSetLayouts.data();
+    pipelineLayoutCreateInfo.pushConstantRangeCount = 0; // Optional
+    pipelineLayoutCreateInfo.pPushConstantRanges = nullptr; // Optional
+
+    if (vkCreatePipelineLayout(VulkanContext::GetLogicalDevice(), &pipelineLayoutCreateInfo, nullptr, &m_vkPipelineLayout) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    // Create shader modules for the vertex and fragment shaders
+    if (!CreateShaderModule("resources/shaders/basic_vert.spv", VulkanContext::GetLogicalDevice(), m_vkVertexShaderModule))
+    {
+        return false;
+    }
+    if (!CreateShaderModule("resources/shaders/basic_frag.spv", VulkanContext::GetLogicalDevice(), m_vkFragmentShaderModule))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Create Vulkan graphics pipeline for a combination of pipeline features
+ * @param[in] features Pipeline feature bits
+ * @param[out] outPipeline Created pipeline
  * @return Returns true if the creation was successful. Returns false otherwise.
  */
-bool Renderer::CreateGraphicsPipeline(VkRenderPass renderPass)
+bool Renderer::CreateGraphicsPipeline(const uint32_t& features, VkPipeline& outPipeline)
 {
     // Set up the fixed pipeline stages
 
@@ -618,47 +1485,40 @@ bool Renderer::CreateGraphicsPipeline(VkRenderPass renderPass)
     dynamicStateCreateInfo.dynamicStateCount = 2;
     dynamicStateCreateInfo.pDynamicStates = dynamicStates;
 
-    // Create pipeline layout
-    std::array<VkDescriptorSetLayout, 4> descriptorSetLayouts = { m_vkPerFrameDescriptorSetLayout, m_vkPerObjectDescriptorSetLayout, m_vkSingleTextureDescriptorSetLayout, m_vkSingleTextureDescriptorSetLayout };
-    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {};
-    pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutCreateInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
-    pipelineLayoutCreateInfo.pSetLayouts = descriptorSetLayouts.data();
-    pipelineLayoutCreateInfo.pushConstantRangeCount = 0; // Optional
-    pipelineLayoutCreateInfo.pPushConstantRanges = nullptr; // Optional
-
-    if (vkCreatePipelineLayout(VulkanContext::GetLogicalDevice(), &pipelineLayoutCreateInfo, nullptr, &m_vkPipelineLayout) != VK_SUCCESS)
-    {
-        return false;
-    }
-
-    // Create shader modules for the vertex and fragment shaders
-    VkShaderModule vertexShaderModule;
-    if (!CreateShaderModule("resources/shaders/basic_vert.spv", VulkanContext::GetLogicalDevice(), vertexShaderModule))
-    {
-        return false;
-    }
-
     // Create pipeline stage for the vertex shader using the vertex shader module
     VkPipelineShaderStageCreateInfo vertexShaderStageCreateInfo = {};
     vertexShaderStageCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     vertexShaderStageCreateInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    vertexShaderStageCreateInfo.module = vertexShaderModule;
+    vertexShaderStageCreateInfo.module = m_vkVertexShaderModule;
     vertexShaderStageCreateInfo.pName = "main";
 
-    VkShaderModule fragmentShaderModule;
-    if (!CreateShaderModule("resources/shaders/basic_frag.spv", VulkanContext::GetLogicalDevice(), fragmentShaderModule))
+    // The feature bits are passed to the fragment shader as specialization constants,
+    // so the driver compiles out the branches of the features that are disabled
+    std::array<VkBool32, 2> specializationData =
     {
-        vkDestroyShaderModule(VulkanContext::GetLogicalDevice(), vertexShaderModule, nullptr);
-        return false;
+        (features & PIPELINE_FEATURE_EMISSIVE_MAP) ? VK_TRUE : VK_FALSE,
+        (features & PIPELINE_FEATURE_ALPHA_TEST) ? VK_TRUE : VK_FALSE
+    };
+    std::array<VkSpecializationMapEntry, 2> specializationMapEntries = {};
+    for (uint32_t i = 0; i < specializationMapEntries.size(); ++i)
+    {
+        specializationMapEntries[i].constantID = i;
+        specializationMapEntries[i].offset = i * sizeof(VkBool32);
+        specializationMapEntries[i].size = sizeof(VkBool32);
     }
+    VkSpecializationInfo specializationInfo = {};
+    specializationInfo.mapEntryCount = static_cast<uint32_t>(specializationMapEntries.size());
+    specializationInfo.pMapEntries = specializationMapEntries.data();
+    specializationInfo.dataSize = sizeof(specializationData);
+    specializationInfo.pData = specializationData.data();
 
     // Create pipeline stage for the fragment shader using the fragment shader module
     VkPipelineShaderStageCreateInfo fragmentShaderStageCreateInfo = {};
     fragmentShaderStageCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     fragmentShaderStageCreateInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    fragmentShaderStageCreateInfo.module = fragmentShaderModule;
+    fragmentShaderStageCreateInfo.module = m_vkFragmentShaderModule;
     fragmentShaderStageCreateInfo.pName = "main";
+    fragmentShaderStageCreateInfo.pSpecializationInfo = &specializationInfo;
 
     VkPipelineShaderStageCreateInfo shaderStages[] = { vertexShaderStageCreateInfo, fragmentShaderStageCreateInfo };
 
@@ -676,71 +1536,565 @@ bool Renderer::CreateGraphicsPipeline(VkRenderPass renderPass)
     pipelineCreateInfo.pColorBlendState = &colorBlendCreateInfo;
     pipelineCreateInfo.pDynamicState = &dynamicStateCreateInfo;
     pipelineCreateInfo.layout = m_vkPipelineLayout;
-    pipelineCreateInfo.renderPass = renderPass;
+    pipelineCreateInfo.renderPass = m_vkRenderPass;
     pipelineCreateInfo.subpass = 0;
     pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE; // In case we inherit from an old pipeline
     pipelineCreateInfo.basePipelineIndex = -1; // Optional
 
-    if (vkCreateGraphicsPipelines(VulkanContext::GetLogicalDevice(), VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &m_vkPipeline) != VK_SUCCESS)
+    // With a warm pipeline cache, the driver can skip compiling the shaders
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    if (vkCreateGraphicsPipelines(VulkanContext::GetLogicalDevice(), VulkanContext::GetPipelineCache(), 1, &pipelineCreateInfo, nullptr, &outPipeline) != VK_SUCCESS)
     {
-        vkDestroyShaderModule(VulkanContext::GetLogicalDevice(), vertexShaderModule, nullptr);
-        vkDestroyShaderModule(VulkanContext::GetLogicalDevice(), fragmentShaderModule, nullptr);
+        std::cout << "Failed to create graphics pipeline with features " << features << "!" << std::endl;
         return false;
     }
+    // Reported through the statistics rather than logged, since permutations are created while recording a frame
+    m_pipelineCreationTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
 
-    // Make sure to destroy the shader modules after the pipeline has been created
-    vkDestroyShaderModule(VulkanContext::GetLogicalDevice(), vertexShaderModule, nullptr);
-    vertexShaderModule = VK_NULL_HANDLE;
-    vkDestroyShaderModule(VulkanContext::GetLogicalDevice(), fragmentShaderModule, nullptr);
-    fragmentShaderModule = VK_NULL_HANDLE;
+    return true;
+}
+
+/**
+ * @brief Gets the graphics pipeline for a combination of pipeline features, creating it on first use.
+ * @param[in] features Pipeline feature bits
+ * @return Graphics pipeline, or VK_NULL_HANDLE if the creation failed
+ */
+VkPipeline Renderer::GetPipeline(const uint32_t& features)
+{
+    auto it = m_vkPipelines.find(features);
+    if (it != m_vkPipelines.end())
+    {
+        return it->second;
+    }
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (!CreateGraphicsPipeline(features, pipeline))
+    {
+        return VK_NULL_HANDLE;
+    }
+    m_vkPipelines[features] = pipeline;
+    return pipeline;
+}
+
+/**
+ * @brief Selects the cheapest pipeline features that can render a mesh with its current textures.
+ * @param[in] mesh Mesh
+ * @return Pipeline feature bits
+ */
+uint32_t Renderer::GetPipelineFeatures(const Mesh* mesh)
+{
+    uint32_t features = 0;
+
+    // Materials classified as opaque when the model was loaded never need the alpha test.
+    // Otherwise, textures that are still streaming in are replaced by the opaque default textures,
+    // and the decoded textures tell whether any texel is actually transparent.
+    if (mesh->emissiveMapFilePaths.size() > 0)
+    {
+        features |= PIPELINE_FEATURE_EMISSIVE_MAP;
+
+        Texture* emissiveTexture = FindTexture(mesh->emissiveMapFilePaths[0]);
+        if (mesh->isAlphaMasked && (emissiveTexture != nullptr) && emissiveTexture->isLoaded && emissiveTexture->hasTransparency)
+        {
+            features |= PIPELINE_FEATURE_ALPHA_TEST;
+        }
+    }
+    if (mesh->isAlphaMasked && (mesh->diffuseMapFilePaths.size() > 0))
+    {
+        Texture* diffuseTexture = FindTexture(mesh->diffuseMapFilePaths[0]);
+        if ((diffuseTexture != nullptr) && diffuseTexture->isLoaded && diffuseTexture->hasTransparency)
+        {
+            features |= PIPELINE_FEATURE_ALPHA_TEST;
+        }
+    }
+
+    return features;
+}
+
+/**
+ * @brief Creates the GPU image of a decoded texture and uploads its smallest mip levels.
+ * @param[in] decodedTexture Decoded texture
+ * @param[in] initialMipSize Mip levels that fit within this size are uploaded right away
+ * @param[out] outTexture Texture where the created resources will be placed
+ * @return Returns true if the creation was successful. Returns false otherwise.
+ */
+bool Renderer::CreateTextureImage(TextureStreamer::DecodedTexture&& decodedTexture, const uint32_t& initialMipSize, Texture& outTexture)
+{
+    PROFILE_FUNCTION();
+
+    outTexture.hasTransparency = decodedTexture.hasTransparency;
+    outTexture.decodedTexture = std::move(decodedTexture);
+    outTexture.numMipLevels = static_cast<uint32_t>(outTexture.decodedTexture.mipLevels.size());
+    SelectTextureFormat(outTexture.decodedTexture, outTexture.format, outTexture.components);
+
+    // Create image for the texture, with room for the full mip chain
+    if (!outTexture.image.Create(
+            outTexture.decodedTexture.width,
+            outTexture.decodedTexture.height,
+            outTexture.format,
+            VK_IMAGE_TILING_OPTIMAL,
+            VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            outTexture.numMipLevels))
+    {
+        return false;
+    }
+
+    // Find the finest mip level that still fits within the initial size
+    uint32_t initialMipLevel = outTexture.numMipLevels - 1;
+    while (initialMipLevel > 0)
+    {
+        const TextureStreamer::MipLevel& mipLevel = outTexture.decodedTexture.mipLevels[initialMipLevel - 1];
+        if (std::max(mipLevel.width, mipLevel.height) > initialMipSize)
+        {
+            break;
+        }
+        --initialMipLevel;
+    }
+
+    if (!UploadTextureMipLevels(outTexture, initialMipLevel, outTexture.numMipLevels - 1))
+    {
+        outTexture.image.Cleanup();
+        return false;
+    }
+
+    outTexture.residentMipLevel = initialMipLevel;
+    outTexture.desiredMipLevel = initialMipLevel;
+    if (!RefreshTextureView(outTexture))
+    {
+        outTexture.image.Cleanup();
+        return false;
+    }
+    outTexture.isLoaded = true;
+
+    if (outTexture.residentMipLevel == 0)
+    {
+        outTexture.decodedTexture = {};
+    }
+
+    m_memoryStatistics.textureBytes += outTexture.image.GetMemorySize();
+    ++m_memoryStatistics.textureCount;
 
     return true;
 }
 
 /**
- * @brief Creates a texture image from the specified file path.
- * @param[out] outImage Variable where the loaded information will be placed.
+ * @brief Selects the smallest image format that can hold a decoded texture without loss, and the swizzle
+ * that makes it read as RGBA in the shaders. Converts the texture to RGBA8 if the device cannot sample that format.
+ * @param[in,out] decodedTexture Decoded texture
+ * @param[out] outFormat Image format
+ * @param[out] outComponents Image view component swizzle
+ */
+void Renderer::SelectTextureFormat(TextureStreamer::DecodedTexture& decodedTexture, VkFormat& outFormat, VkComponentMapping& outComponents)
+{
+    outComponents = { VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY };
+
+    // 8-bit grayscale+alpha is not given R8G8_SRGB, because sRGB formats would also decode the alpha stored in G
+    outFormat = VK_FORMAT_UNDEFINED;
+    if (decodedTexture.bytesPerChannel == 2)
+    {
+        outFormat = (decodedTexture.numChannels == 1) ? VK_FORMAT_R16_UNORM
+            : (decodedTexture.numChannels == 2) ? VK_FORMAT_R16G16_UNORM
+            : VK_FORMAT_R16G16B16A16_UNORM;
+    }
+    else if (decodedTexture.numChannels == 1)
+    {
+        outFormat = VK_FORMAT_R8_SRGB;
+    }
+
+    if ((outFormat == VK_FORMAT_UNDEFINED) || !IsSampledFormatSupported(outFormat))
+    {
+        TextureStreamer::ConvertToRGBA8(decodedTexture);
+        outFormat = decodedTexture.isBGRA ? VK_FORMAT_B8G8R8A8_SRGB : VK_FORMAT_R8G8B8A8_SRGB;
+        return;
+    }
+
+    // Expand grayscale to RGB, and move the alpha of grayscale+alpha images from G to A
+    if (decodedTexture.numChannels == 1)
+    {
+        outComponents = { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_ONE };
+    }
+    else if (decodedTexture.numChannels == 2)
+    {
+        outComponents = { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G };
+    }
+}
+
+/**
+ * @brief Checks whether the device can sample images of the specified format with linear filtering.
+ * @param[in] format Image format
+ * @return Returns true if the format is supported. Returns false otherwise.
  */
-bool Renderer::CreateTextureImage(const std::string& textureFilePath, VulkanImage& outImage)
+bool Renderer::IsSampledFormatSupported(const VkFormat& format)
 {
-    // Load texture file using STB image
-    int textureWidth, textureHeight, textureNumChannels;
-    stbi_uc* pixels = stbi_load(textureFilePath.c_str(), &textureWidth, &textureHeight, &textureNumChannels, STBI_rgb_alpha); // Force images to be loaded with an alpha channel (hence the STBI_rgb_alpha)
-    if (pixels == nullptr)
+    VkFormatProperties formatProperties;
+    vkGetPhysicalDeviceFormatProperties(VulkanContext::GetPhysicalDevice(), format, &formatProperties);
+
+    VkFormatFeatureFlags requiredFeatures = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    return (formatProperties.optimalTilingFeatures & requiredFeatures) == requiredFeatures;
+}
+
+/**
+ * @brief Loads a texture file synchronously at full resolution.
+ * @param[in] textureFilePath Texture file path
+ * @return Returns true if the texture was loaded successfully. Returns false otherwise.
+ */
+bool Renderer::LoadTextureImmediate(const std::string& textureFilePath)
+{
+    PROFILE_FUNCTION();
+
+    TextureStreamer::DecodedTexture decodedTexture;
+    if (!TextureStreamer::DecodeFile(textureFilePath, textureFilePath, decodedTexture))
+    {
+        return false;
+    }
+
+    m_textureContentHashes[textureFilePath] = decodedTexture.contentHash;
+    if (m_textures.find(decodedTexture.contentHash) != m_textures.end())
     {
-        std::cout << "Failed to load image " << textureFilePath << std::endl;
+        ++m_numDeduplicatedTextures;
+        return true;
+    }
+
+    uint64_t contentHash = decodedTexture.contentHash;
+    Texture& texture = m_textures[contentHash];
+    texture = {};
+    if (!CreateTextureImage(std::move(decodedTexture), UINT32_MAX, texture))
+    {
+        m_textures.erase(contentHash);
         return false;
     }
+    return true;
+}
+
+/**
+ * @brief Registers a texture and queues it for decoding if it has not been seen before.
+ * @param[in] model Model that uses the texture
+ * @param[in] textureFilePath Texture file path, or the key of a texture embedded in the model
+ */
+void Renderer::RequestTexture(const Model* model, const std::string& textureFilePath)
+{
+    if ((m_textureContentHashes.find(textureFilePath) != m_textureContentHashes.end())
+        || (m_requestedTextures.find(textureFilePath) != m_requestedTextures.end()))
+    {
+        return;
+    }
 
-    VkDeviceSize textureSize = textureWidth * textureHeight * 4;
+    m_requestedTextures[textureFilePath] = 0.0f;
 
-    // Copy image data to a staging buffer
+    // Embedded textures were already decoded during the model import
+    const ImageData* embeddedTexture = model->GetEmbeddedTexture(textureFilePath);
+    if (embeddedTexture != nullptr)
+    {
+        m_textureStreamer.Request(textureFilePath, *embeddedTexture, 0.0f, m_textureLoadGeneration);
+    }
+    else
+    {
+        m_textureStreamer.Request(textureFilePath, textureFilePath, 0.0f, m_textureLoadGeneration);
+    }
+}
+
+/**
+ * @brief Gets the descriptor set to use for a texture.
+ * @param[in] textureFilePath Texture file path
+ * @param[in] fallbackTextureFilePath Texture to use while the texture is not loaded yet
+ * @return Descriptor set of the texture, or of the fallback texture
+ */
+VkDescriptorSet Renderer::GetTextureDescriptorSet(const std::string& textureFilePath, const std::string& fallbackTextureFilePath)
+{
+    Texture* texture = FindTexture(textureFilePath);
+    if ((texture != nullptr) && texture->isLoaded)
+    {
+        return texture->descriptorSet;
+    }
+    return FindTexture(fallbackTextureFilePath)->descriptorSet;
+}
+
+/**
+ * @brief Finds the texture with the specified file path.
+ * @param[in] textureFilePath Texture file path
+ * @return Pointer to the texture. Returns nullptr if the texture has not finished decoding yet.
+ */
+Renderer::Texture* Renderer::FindTexture(const std::string& textureFilePath)
+{
+    auto hashIt = m_textureContentHashes.find(textureFilePath);
+    if (hashIt == m_textureContentHashes.end())
+    {
+        return nullptr;
+    }
+
+    auto it = m_textures.find(hashIt->second);
+    return (it != m_textures.end()) ? &it->second : nullptr;
+}
+
+/**
+ * @brief Records the on-screen footprint of a mesh that uses the specified texture.
+ * @param[in] textureFilePath Texture file path
+ * @param[in] footprint On-screen footprint of the mesh (in pixels)
+ */
+void Renderer::AddTextureFootprint(const std::string& textureFilePath, const float& footprint)
+{
+    Texture* texture = FindTexture(textureFilePath);
+    if (texture != nullptr)
+    {
+        texture->footprint = std::max(texture->footprint, footprint);
+        return;
+    }
+
+    auto it = m_requestedTextures.find(textureFilePath);
+    if (it != m_requestedTextures.end())
+    {
+        it->second = std::max(it->second, footprint);
+    }
+}
+
+/**
+ * @brief Uploads a range of mip levels of a texture.
+ * @param[in] texture Texture, which must still have its decoded mip chain
+ * @param[in] firstMipLevel Finest mip level to upload
+ * @param[in] lastMipLevel Coarsest mip level to upload
+ * @return Returns true if the upload was successful. Returns false otherwise.
+ */
+bool Renderer::UploadTextureMipLevels(Texture& texture, const uint32_t& firstMipLevel, const uint32_t& lastMipLevel)
+{
+    PROFILE_FUNCTION();
+
+    const TextureStreamer::DecodedTexture& decodedTexture = texture.decodedTexture;
+
+    VkDeviceSize stagingSize = 0;
+    for (uint32_t i = firstMipLevel; i <= lastMipLevel; ++i)
+    {
+        stagingSize += decodedTexture.mipLevels[i].size;
+    }
+    m_frameStatistics.uploadedBytes += stagingSize;
+
+    // Copy the pixel data of all the mip levels to a staging buffer
     VulkanBuffer stagingBuffer;
-    stagingBuffer.Create(textureSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    if (!stagingBuffer.Create(stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+    {
+        return false;
+    }
 
-    void* data = stagingBuffer.MapMemory(0, textureSize);
-    memcpy(data, pixels, static_cast<size_t>(textureSize));
+    std::vector<VkBufferImageCopy> regions;
+    uint8_t* data = reinterpret_cast<uint8_t*>(stagingBuffer.MapMemory(0, stagingSize));
+    VkDeviceSize bufferOffset = 0;
+    for (uint32_t i = firstMipLevel; i <= lastMipLevel; ++i)
+    {
+        const TextureStreamer::MipLevel& mipLevel = decodedTexture.mipLevels[i];
+        memcpy(data + bufferOffset, decodedTexture.GetMipLevelPixels(i), mipLevel.size);
+
+        VkBufferImageCopy region = {};
+        region.bufferOffset = bufferOffset;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = i;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = { 0, 0, 0 };
+        region.imageExtent = { mipLevel.width, mipLevel.height, 1 };
+        regions.push_back(region);
+
+        bufferOffset += mipLevel.size;
+    }
     stagingBuffer.UnmapMemory();
 
-    // Free image data, since we have already uploaded the pixel data to the GPU
-    stbi_image_free(pixels);
-    pixels = nullptr;
+    VkCommandBuffer commandBuffer = BeginSingleUseCommandBuffer();
+
+    // The mip levels being uploaded have never been used, so their previous contents can be discarded
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = texture.image.GetHandle();
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = firstMipLevel;
+    barrier.subresourceRange.levelCount = lastMipLevel - firstMipLevel + 1;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
 
-    // Create image for the texture
-    if (!outImage.Create(textureWidth, textureHeight, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT))
+    vkCmdCopyBufferToImage(commandBuffer, stagingBuffer.GetHandle(), texture.image.GetHandle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
+
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    // Streamed mip levels are not waited on. The staging buffer is released once the upload has completed.
+    if (!SubmitUpload(commandBuffer, stagingBuffer))
     {
+        stagingBuffer.Cleanup();
         return false;
     }
 
-    TransitionImageLayout(outImage.GetHandle(), VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-    CopyBufferToImage(stagingBuffer.GetHandle(), outImage.GetHandle(), textureWidth, textureHeight);
-    TransitionImageLayout(outImage.GetHandle(), VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    return true;
+}
 
-    stagingBuffer.Cleanup();
+/**
+ * @brief Recreates the image view and descriptor set of a texture after its resident mip levels changed.
+ * The current view and descriptor set are kept if the new ones cannot be created.
+ * @param[in] texture Texture
+ * @return Returns true if the operation was successful. Returns false otherwise.
+ */
+bool Renderer::RefreshTextureView(Texture& texture)
+{
+    VulkanImageView imageView;
+    if (!imageView.Create(
+            texture.image.GetHandle(),
+            texture.format,
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            texture.residentMipLevel,
+            texture.numMipLevels - texture.residentMipLevel,
+            texture.components))
+    {
+        return false;
+    }
 
+    VkDescriptorSet descriptorSet = CreateTextureDescriptorSet(imageView.GetHandle());
+    if (descriptorSet == VK_NULL_HANDLE)
+    {
+        imageView.Cleanup();
+        return false;
+    }
+
+    // Frames that are still in flight may be using the current view, so it is only destroyed later
+    if (texture.imageView.GetHandle() != VK_NULL_HANDLE)
+    {
+        m_retiredTextureViews.push_back({ texture.imageView, texture.descriptorSet, VulkanContext::GetLastSubmission() });
+    }
+    texture.imageView = imageView;
+    texture.descriptorSet = descriptorSet;
     return true;
 }
 
+/**
+ * @brief Allocates and writes a descriptor set for a single texture.
+ * @param[in] imageView Image view of the texture
+ * @return Descriptor set, or VK_NULL_HANDLE if the allocation failed
+ */
+VkDescriptorSet Renderer::CreateTextureDescriptorSet(VkImageView imageView)
+{
+    VkDescriptorSet imageDescriptorSet = VK_NULL_HANDLE;
+
+    VkDescriptorSetAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_vkDescriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &m_vkSingleTextureDescriptorSetLayout;
+    if (vkAllocateDescriptorSets(VulkanContext::GetLogicalDevice(), &allocInfo, &imageDescriptorSet) != VK_SUCCESS)
+    {
+        std::cout << "Failed to allocate texture descriptor set!" << std::endl;
+        return VK_NULL_HANDLE;
+    }
+
+    VkDescriptorImageInfo imageInfo = {};
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfo.imageView = imageView;
+    imageInfo.sampler = m_vkTextureSampler;
+
+    VkWriteDescriptorSet descriptorWrite = {};
+    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrite.dstSet = imageDescriptorSet;
+    descriptorWrite.dstBinding = 0;
+    descriptorWrite.dstArrayElement = 0;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pBufferInfo = nullptr;
+    descriptorWrite.pImageInfo = &imageInfo;
+    descriptorWrite.pTexelBufferView = nullptr;
+
+    vkUpdateDescriptorSets(VulkanContext::GetLogicalDevice(), 1, &descriptorWrite, 0, nullptr);
+
+    return imageDescriptorSet;
+}
+
+/**
+ * @brief Destroys retired texture views that are no longer used by any frame in flight.
+ * @param[in] destroyAll Destroy all retired views regardless of the frames in flight
+ */
+void Renderer::DestroyRetiredTextureViews(const bool& destroyAll)
+{
+    uint64_t completedSubmission = VulkanContext::GetCompletedSubmission();
+
+    size_t numRemaining = 0;
+    for (size_t i = 0; i < m_retiredTextureViews.size(); ++i)
+    {
+        RetiredTextureView& retiredView = m_retiredTextureViews[i];
+        if (destroyAll || (retiredView.retiredSubmission <= completedSubmission))
+        {
+            if (retiredView.descriptorSet != VK_NULL_HANDLE)
+            {
+                vkFreeDescriptorSets(VulkanContext::GetLogicalDevice(), m_vkDescriptorPool, 1, &retiredView.descriptorSet);
+            }
+            retiredView.imageView.Cleanup();
+        }
+        else
+        {
+            m_retiredTextureViews[numRemaining++] = retiredView;
+        }
+    }
+    m_retiredTextureViews.resize(numRemaining);
+}
+
+/**
+ * @brief Ends a single use command buffer and submits it without waiting for it to complete.
+ * The command buffer and the staging buffer are released once the submission has completed.
+ * @param[in] commandBuffer Command buffer to end
+ * @param[in] stagingBuffer Staging buffer used by the command buffer
+ * @return Returns true if the submission was successful. Returns false otherwise.
+ */
+bool Renderer::SubmitUpload(VkCommandBuffer commandBuffer, const VulkanBuffer& stagingBuffer)
+{
+    vkEndCommandBuffer(commandBuffer);
+
+    VkSubmitInfo submitInfo = {};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+
+    // Frames submitted later to the same queue are ordered after the upload by its final barrier
+    uint64_t submission = 0;
+    if (!VulkanContext::SubmitToGraphicsQueue(submitInfo, submission))
+    {
+        std::cout << "Failed to submit upload command buffer!" << std::endl;
+        vkFreeCommandBuffers(VulkanContext::GetLogicalDevice(), VulkanContext::GetDefaultCommandPool(), 1, &commandBuffer);
+        return false;
+    }
+
+    m_pendingUploads.push_back({ commandBuffer, stagingBuffer, submission });
+    return true;
+}
+
+/**
+ * @brief Releases the command buffers and staging buffers of the uploads that the GPU has finished.
+ * @param[in] releaseAll Release all uploads regardless of their completion. The device must be idle.
+ */
+void Renderer::ReleaseCompletedUploads(const bool& releaseAll)
+{
+    uint64_t completedSubmission = VulkanContext::GetCompletedSubmission();
+
+    size_t numRemaining = 0;
+    for (size_t i = 0; i < m_pendingUploads.size(); ++i)
+    {
+        PendingUpload& pendingUpload = m_pendingUploads[i];
+        if (releaseAll || (pendingUpload.submission <= completedSubmission))
+        {
+            vkFreeCommandBuffers(VulkanContext::GetLogicalDevice(), VulkanContext::GetDefaultCommandPool(), 1, &pendingUpload.commandBuffer);
+            pendingUpload.stagingBuffer.Cleanup();
+        }
+        else
+        {
+            m_pendingUploads[numRemaining++] = pendingUpload;
+        }
+    }
+    m_pendingUploads.resize(numRemaining);
+}
+
 /**
  * @brief Creates the texture sampler.
  * @return Returns true if the creation was successful. Returns false otherwise.
@@ -773,7 +2127,7 @@ bool Renderer::CreateTextureSampler()
     samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
     samplerInfo.mipLodBias = 0.0f;
     samplerInfo.minLod = 0.0f;
-    samplerInfo.maxLod = 0.0f;
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE; // Each texture view limits the sampled mip levels to the resident ones
 
     if (vkCreateSampler(VulkanContext::GetLogicalDevice(), &samplerInfo, nullptr, &m_vkTextureSampler) != VK_SUCCESS)
     {
@@ -790,19 +2144,22 @@ bool Renderer::CreateTextureSampler()
  */
 bool Renderer::CreateDescriptorPool()
 {
+    // The texture descriptor set layout has two combined image sampler bindings.
+    // The per-frame and per-object sets are shared by all frames in flight through dynamic offsets.
     std::array<VkDescriptorPoolSize, 3> poolSizes = {};
-    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSizes[0].descriptorCount = 30;
-    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-    poolSizes[1].descriptorCount = 30;
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    poolSizes[0].descriptorCount = 1;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    poolSizes[1].descriptorCount = 1;
     poolSizes[2].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[2].descriptorCount = 30;
+    poolSizes[2].descriptorCount = MAX_TEXTURE_DESCRIPTOR_SETS * 2;
 
     VkDescriptorPoolCreateInfo poolInfo = {};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT; // Texture descriptor sets are replaced as textures are streamed in
     poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
     poolInfo.pPoolSizes = poolSizes.data();
-    poolInfo.maxSets = 30;
+    poolInfo.maxSets = 2 + MAX_TEXTURE_DESCRIPTOR_SETS;
 
     if (vkCreateDescriptorPool(VulkanContext::GetLogicalDevice(), &poolInfo, nullptr, &m_vkDescriptorPool) != VK_SUCCESS)
     {
@@ -930,8 +2287,10 @@ void Renderer::EndSingleUseCommandBuffer(VkCommandBuffer commandBuffer)
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &commandBuffer;
 
-    vkQueueSubmit(VulkanContext::GetGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(VulkanContext::GetGraphicsQueue());
+    // Only this submission is waited on, not the frames still in flight
+    uint64_t submission = 0;
+    VulkanContext::SubmitToGraphicsQueue(submitInfo, submission);
+    VulkanContext::WaitForSubmission(submission);
 
     vkFreeCommandBuffers(VulkanContext::GetLogicalDevice(), VulkanContext::GetDefaultCommandPool(), 1, &commandBuffer);
 }
@@ -0,0 +1,202 @@
+#include "Graphics/SyntheticSceneGenerator.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <sstream>
+
+/**
+ * @brief Generates the meshes and textures of a scene into a model. The meshes are laid out in a grid and
+ * the instances in a larger grid, so that the whole scene fits within [-1, 1] on each axis.
+ * @param[in] settings Scene size
+ * @param[out] outModel Model where the meshes and textures are added. Should be empty.
+ * @param[out] outInstanceTransforms Transformation matrix of each instance
+ */
+void SyntheticSceneGenerator::Generate(const Settings& settings, Model& outModel, std::vector<glm::mat4>& outInstanceTransforms)
+{
+    std::mt19937 random(settings.seed);
+
+    std::vector<std::string> textureKeys(settings.numUniqueTextures);
+    for (uint32_t i = 0; i < settings.numUniqueTextures; ++i)
+    {
+        textureKeys[i] = GetDescription(settings) + "*texture" + std::to_string(i);
+        outModel.AddEmbeddedTexture(textureKeys[i], GenerateTexture(settings.textureSize, random));
+    }
+
+    // Meshes fill a cube grid spanning [-1, 1]
+    uint32_t meshGridSize = static_cast<uint32_t>(std::ceil(std::cbrt(static_cast<double>(std::max(settings.numMeshes, 1u)))));
+    float meshCellSize = 2.0f / meshGridSize;
+    for (uint32_t i = 0; i < settings.numMeshes; ++i)
+    {
+        glm::vec3 cell(i % meshGridSize, (i / meshGridSize) % meshGridSize, i / (meshGridSize * meshGridSize));
+        glm::vec3 center = glm::vec3(-1.0f) + (cell + 0.5f) * meshCellSize;
+
+        Mesh* mesh = new Mesh();
+        GenerateMesh(center, meshCellSize * 0.8f, settings.trianglesPerMesh, random, mesh);
+        if (!textureKeys.empty())
+        {
+            mesh->diffuseMapFilePaths.push_back(textureKeys[i % textureKeys.size()]);
+        }
+        outModel.AddMesh(mesh);
+    }
+
+    // Instances fill a cube grid of their own, scaled down so that the whole scene still spans [-1, 1]
+    uint32_t instanceGridSize = static_cast<uint32_t>(std::ceil(std::cbrt(static_cast<double>(std::max(settings.numInstances, 1u)))));
+    float instanceScale = 1.0f / instanceGridSize;
+    outInstanceTransforms.clear();
+    for (uint32_t i = 0; i < settings.numInstances; ++i)
+    {
+        glm::vec3 cell(i % instanceGridSize, (i / instanceGridSize) % instanceGridSize, i / (instanceGridSize * instanceGridSize));
+        glm::vec3 center = glm::vec3(-1.0f) + (cell + 0.5f) * (2.0f * instanceScale);
+
+        glm::mat4 transform = glm::translate(glm::mat4(1.0f), center);
+        transform = glm::scale(transform, glm::vec3(instanceScale));
+        outInstanceTransforms.push_back(transform);
+    }
+}
+
+/**
+ * @brief Parses settings in the "meshes,trianglesPerMesh,instances,textures" format. Missing trailing values keep their default.
+ * @param[in] text Text to parse
+ * @param[out] outSettings Settings
+ * @return Returns true if the text was valid. Returns false otherwise.
+ */
+bool SyntheticSceneGenerator::ParseSettings(const std::string& text, Settings& outSettings)
+{
+    uint32_t* values[] =
+    {
+        &outSettings.numMeshes,
+        &outSettings.trianglesPerMesh,
+        &outSettings.numInstances,
+        &outSettings.numUniqueTextures
+    };
+
+    std::istringstream stream(text);
+    std::string value;
+    size_t numValues = 0;
+    while (std::getline(stream, value, ','))
+    {
+        // from_chars rejects signs, and values that do not fit in 32 bits instead of throwing
+        if (numValues >= std::size(values))
+        {
+            return false;
+        }
+        std::from_chars_result result = std::from_chars(value.data(), value.data() + value.size(), *values[numValues]);
+        if (value.empty() || (result.ec != std::errc()) || (result.ptr != value.data() + value.size()))
+        {
+            return false;
+        }
+        ++numValues;
+    }
+
+    return (numValues > 0);
+}
+
+/**
+ * @brief Gets a short description of the settings, usable as a benchmark name.
+ * @param[in] settings Scene size
+ * @return Description of the settings
+ */
+std::string SyntheticSceneGenerator::GetDescription(const Settings& settings)
+{
+    return "synthetic_" + std::to_string(settings.numMeshes) + "meshes_" + std::to_string(settings.trianglesPerMesh) + "tris_"
+        + std::to_string(settings.numInstances) + "instances_" + std::to_string(settings.numUniqueTextures) + "textures";
+}
+
+/**
+ * @brief Generates a wavy rectangular patch with exactly the requested number of triangles.
+ * @param[in] center Center of the patch
+ * @param[in] size Width and height of the patch
+ * @param[in] numTriangles Number of triangles
+ * @param[in] random Random number generator, used for the color and the waves
+ * @param[out] outMesh Mesh where the geometry is placed
+ */
+void SyntheticSceneGenerator::GenerateMesh(const glm::vec3& center, const float& size, const uint32_t& numTriangles, std::mt19937& random, Mesh* outMesh)
+{
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+    glm::vec3 color(distribution(random), distribution(random), distribution(random));
+    float wavePhase = distribution(random) * glm::two_pi<float>();
+    float waveHeight = size * 0.1f;
+
+    // A grid of n x n quads has 2n^2 triangles. The grid is made just large enough, and the extra triangles are dropped.
+    uint32_t numQuadsPerSide = std::max(static_cast<uint32_t>(std::ceil(std::sqrt(numTriangles / 2.0))), 1u);
+    uint32_t numVerticesPerSide = numQuadsPerSide + 1;
+
+    outMesh->vertices.resize(static_cast<size_t>(numVerticesPerSide) * numVerticesPerSide);
+    for (uint32_t y = 0; y < numVerticesPerSide; ++y)
+    {
+        for (uint32_t x = 0; x < numVerticesPerSide; ++x)
+        {
+            glm::vec2 uv(static_cast<float>(x) / numQuadsPerSide, static_cast<float>(y) / numQuadsPerSide);
+            float height = waveHeight * glm::sin(uv.x * glm::two_pi<float>() * 2.0f + wavePhase) * glm::cos(uv.y * glm::two_pi<float>() * 2.0f);
+
+            Vertex& vertex = outMesh->vertices[static_cast<size_t>(y) * numVerticesPerSide + x];
+            vertex.position = center + glm::vec3((uv.x - 0.5f) * size, (uv.y - 0.5f) * size, height);
+            vertex.color = color;
+            vertex.uv = uv;
+        }
+    }
+
+    outMesh->indices.reserve(static_cast<size_t>(numTriangles) * 3);
+    for (uint32_t y = 0; y < numQuadsPerSide; ++y)
+    {
+        for (uint32_t x = 0; x < numQuadsPerSide; ++x)
+        {
+            uint32_t topLeft = y * numVerticesPerSide + x;
+            uint32_t topRight = topLeft + 1;
+            uint32_t bottomLeft = topLeft + numVerticesPerSide;
+            uint32_t bottomRight = bottomLeft + 1;
+
+            outMesh->indices.insert(outMesh->indices.end(), { topLeft, bottomLeft, topRight });
+            outMesh->indices.insert(outMesh->indices.end(), { topRight, bottomLeft, bottomRight });
+        }
+    }
+    outMesh->indices.resize(static_cast<size_t>(numTriangles) * 3);
+
+    outMesh->boundsCenter = center;
+    outMesh->boundsRadius = glm::length(glm::vec3(size * 0.5f, size * 0.5f, waveHeight));
+}
+
+/**
+ * @brief Generates a checkerboard texture in two random colors.
+ * @param[in] size Width and height of the texture
+ * @param[in] random Random number generator, used for the colors
+ * @return Generated image
+ */
+ImageData SyntheticSceneGenerator::GenerateTexture(const uint32_t& size, std::mt19937& random)
+{
+    std::uniform_int_distribution<uint32_t> distribution(0, 255);
+    uint8_t colors[2][4] = {};
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        for (uint32_t j = 0; j < 3; ++j)
+        {
+            colors[i][j] = static_cast<uint8_t>(distribution(random));
+        }
+        colors[i][3] = 255;
+    }
+
+    uint32_t textureSize = std::max(size, 1u);
+    uint32_t checkerSize = std::max(textureSize / TEXTURE_CHECKER_COUNT, 1u);
+    std::shared_ptr<uint8_t> pixels(new uint8_t[static_cast<size_t>(textureSize) * textureSize * 4], std::default_delete<uint8_t[]>());
+    for (uint32_t y = 0; y < textureSize; ++y)
+    {
+        for (uint32_t x = 0; x < textureSize; ++x)
+        {
+            const uint8_t* color = colors[((x / checkerSize) + (y / checkerSize)) % 2];
+            std::copy(color, color + 4, pixels.get() + (static_cast<size_t>(y) * textureSize + x) * 4);
+        }
+    }
+
+    ImageData image = {};
+    image.width = textureSize;
+    image.height = textureSize;
+    image.numChannels = 4;
+    image.bytesPerChannel = 1;
+    image.isBGRA = false;
+    image.maxMipLevels = 0;
+    image.pixels = pixels;
+    return image;
+}
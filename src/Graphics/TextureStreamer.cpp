@@ -0,0 +1,730 @@
+#include "Graphics/TextureStreamer.hpp"
+
+#include "Profiling/CpuProfiler.hpp"
+
+#include <stbi/stb_image.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+#define CONTENT_HASH_OFFSET_BASIS 14695981039346656037ull
+#define CONTENT_HASH_PRIME 1099511628211ull
+#define FILE_READ_CHUNK_SIZE (1024 * 1024)
+
+/**
+ * @brief Constructor
+ */
+TextureStreamer::TextureStreamer()
+    : m_pendingRequests()
+    , m_decodedTextures()
+    , m_mutex()
+    , m_condition()
+    , m_workerThread()
+    , m_decodedContentHashes()
+    , m_forgottenContentHashes()
+    , m_isRunning(false)
+    , m_isDecoding(false)
+    , m_decodedCallback(nullptr)
+{
+}
+
+/**
+ * @brief Destructor
+ */
+TextureStreamer::~TextureStreamer()
+{
+    Stop();
+}
+
+/**
+ * @brief Starts the background decoding thread.
+ */
+void TextureStreamer::Start()
+{
+    if (m_isRunning)
+    {
+        return;
+    }
+
+    m_isRunning = true;
+    m_workerThread = std::thread(&TextureStreamer::WorkerLoop, this);
+}
+
+/**
+ * @brief Stops the background decoding thread. Pending requests are discarded.
+ */
+void TextureStreamer::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isRunning = false;
+        m_pendingRequests.clear();
+        m_isDecoding = false;
+    }
+    m_condition.notify_all();
+
+    if (m_workerThread.joinable())
+    {
+        m_workerThread.join();
+    }
+
+    m_decodedTextures.clear();
+    m_decodedContentHashes.clear();
+    m_forgottenContentHashes.clear();
+}
+
+/**
+ * @brief Sets a function that the decoding thread calls whenever a texture finishes decoding,
+ * e.g., to wake up an event loop that is waiting for events.
+ * @param[in] callback Function to call, or nullptr to call nothing
+ */
+void TextureStreamer::SetDecodedCallback(void (*callback)())
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_decodedCallback = callback;
+}
+
+/**
+ * @brief Checks whether any decoded texture is waiting to be taken.
+ * @return Returns true if PopDecodedTexture would return a texture. Returns false otherwise.
+ */
+bool TextureStreamer::HasDecodedTextures()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_decodedTextures.empty();
+}
+
+/**
+ * @brief Checks whether the decoding thread has finished all its work: no request is pending or being decoded,
+ * and every decoded texture has been taken.
+ * @return Returns true if the streamer is idle. Returns false otherwise.
+ */
+bool TextureStreamer::IsIdle()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pendingRequests.empty() && !m_isDecoding && m_decodedTextures.empty();
+}
+
+/**
+ * @brief Queues a texture file for decoding.
+ * @param[in] key Key that identifies the texture
+ * @param[in] filePath Texture file path
+ * @param[in] priority Decoding priority. Requests with higher priority are decoded first.
+ * @param[in] generation Load generation, returned with the decoded texture to recognize stale results
+ */
+void TextureStreamer::Request(const std::string& key, const std::string& filePath, const float& priority, const uint32_t& generation)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingRequests.push_back({ key, filePath, {}, priority, generation });
+    }
+    m_condition.notify_one();
+}
+
+/**
+ * @brief Queues an image that is already decoded in memory. Only its mip chain needs to be generated.
+ * @param[in] key Key that identifies the texture
+ * @param[in] image Decoded image
+ * @param[in] priority Decoding priority. Requests with higher priority are decoded first.
+ * @param[in] generation Load generation, returned with the decoded texture to recognize stale results
+ */
+void TextureStreamer::Request(const std::string& key, const ImageData& image, const float& priority, const uint32_t& generation)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingRequests.push_back({ key, "", image, priority, generation });
+    }
+    m_condition.notify_one();
+}
+
+/**
+ * @brief Updates the priority of a pending request.
+ * @param[in] key Key that identifies the texture
+ * @param[in] priority New decoding priority
+ */
+void TextureStreamer::SetPriority(const std::string& key, const float& priority)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t i = 0; i < m_pendingRequests.size(); ++i)
+    {
+        if (m_pendingRequests[i].key == key)
+        {
+            m_pendingRequests[i].priority = priority;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Makes the decoding thread forget that it decoded a texture with the specified content hash,
+ * so that the next texture with the same contents is decoded in full instead of being reported as a duplicate.
+ * @param[in] contentHash Content hash
+ */
+void TextureStreamer::ForgetContentHash(const uint64_t& contentHash)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_forgottenContentHashes.push_back(contentHash);
+}
+
+/**
+ * @brief Takes one texture that has finished decoding, if there is any.
+ * @param[out] outTexture Decoded texture
+ * @return Returns true if a decoded texture was returned. Returns false otherwise.
+ */
+bool TextureStreamer::PopDecodedTexture(DecodedTexture& outTexture)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_decodedTextures.empty())
+    {
+        return false;
+    }
+
+    // Hand out textures in the order they were decoded, so that the first texture with a given content hash
+    // always arrives before its duplicates
+    outTexture = std::move(m_decodedTextures.front());
+    m_decodedTextures.erase(m_decodedTextures.begin());
+    return true;
+}
+
+/**
+ * @brief Decodes a texture file and generates its mip chain on the calling thread.
+ * @param[in] key Key that identifies the texture
+ * @param[in] filePath Texture file path
+ * @param[out] outTexture Decoded texture
+ * @return Returns true if the texture was decoded successfully. Returns false otherwise.
+ */
+bool TextureStreamer::DecodeFile(const std::string& key, const std::string& filePath, DecodedTexture& outTexture)
+{
+    PROFILE_FUNCTION();
+
+    outTexture = {};
+    outTexture.key = key;
+    outTexture.isValid = false;
+
+    std::vector<uint8_t> contents;
+    if (!ReadFileContents(filePath, contents, outTexture.contentHash))
+    {
+        std::cout << "Failed to load image " << filePath << std::endl;
+        return false;
+    }
+
+    return DecodeFileContents(filePath, contents, outTexture);
+}
+
+/**
+ * @brief Generates the mip chain of an image that is already decoded in memory. The pixels are not copied.
+ * @param[in] key Key that identifies the texture
+ * @param[in] image Decoded image
+ * @param[out] outTexture Decoded texture
+ * @return Returns true if the texture was prepared successfully. Returns false otherwise.
+ */
+bool TextureStreamer::DecodeImage(const std::string& key, const ImageData& image, DecodedTexture& outTexture)
+{
+    PROFILE_FUNCTION();
+
+    outTexture = {};
+    outTexture.key = key;
+    outTexture.isValid = false;
+
+    if ((image.pixels == nullptr) || (image.width == 0) || (image.height == 0))
+    {
+        return false;
+    }
+
+    outTexture.width = image.width;
+    outTexture.height = image.height;
+    outTexture.numChannels = image.numChannels;
+    outTexture.bytesPerChannel = image.bytesPerChannel;
+    outTexture.isBGRA = image.isBGRA;
+    outTexture.maxMipLevels = image.maxMipLevels;
+    outTexture.basePixels = image.pixels;
+    outTexture.hasTransparency = HasTransparentPixels(image);
+
+    GenerateMipChain(outTexture);
+
+    outTexture.isValid = true;
+    return true;
+}
+
+/**
+ * @brief Main loop of the background decoding thread.
+ */
+void TextureStreamer::WorkerLoop()
+{
+    CpuProfiler::SetThreadName("Texture decoder");
+
+    while (true)
+    {
+        DecodeRequest request;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return !m_isRunning || !m_pendingRequests.empty(); });
+            if (!m_isRunning)
+            {
+                return;
+            }
+
+            // Take the request with the highest priority
+            std::vector<DecodeRequest>::iterator it = std::max_element(m_pendingRequests.begin(), m_pendingRequests.end(),
+                [](const DecodeRequest& a, const DecodeRequest& b) { return a.priority < b.priority; });
+            request = std::move(*it);
+            m_pendingRequests.erase(it);
+            m_isDecoding = true;
+
+            for (uint64_t contentHash : m_forgottenContentHashes)
+            {
+                m_decodedContentHashes.erase(contentHash);
+            }
+            m_forgottenContentHashes.clear();
+        }
+
+        DecodedTexture decodedTexture = {};
+        decodedTexture.key = request.key;
+        decodedTexture.isValid = false;
+        if (request.image.pixels != nullptr)
+        {
+            // Hash the layout before the pixels, so images with the same bytes but a different layout stay distinct
+            const ImageData& image = request.image;
+            const uint32_t layout[5] = { image.width, image.height, image.numChannels, image.bytesPerChannel, image.isBGRA ? 1u : 0u };
+            uint64_t contentHash = ComputeContentHash(reinterpret_cast<const uint8_t*>(layout), sizeof(layout), CONTENT_HASH_OFFSET_BASIS);
+            contentHash = ComputeContentHash(image.pixels.get(), static_cast<size_t>(image.width) * image.height * image.numChannels * image.bytesPerChannel, contentHash);
+            if (m_decodedContentHashes.find(contentHash) != m_decodedContentHashes.end())
+            {
+                decodedTexture.contentHash = contentHash;
+                decodedTexture.isDuplicate = true;
+                decodedTexture.isValid = true;
+            }
+            else
+            {
+                DecodeImage(request.key, request.image, decodedTexture);
+                decodedTexture.contentHash = contentHash;
+            }
+        }
+        else
+        {
+            // Hash the file while reading it, and only decode it if no identical file was decoded before
+            std::vector<uint8_t> contents;
+            if (!ReadFileContents(request.filePath, contents, decodedTexture.contentHash))
+            {
+                std::cout << "Failed to load image " << request.filePath << std::endl;
+            }
+            else if (m_decodedContentHashes.find(decodedTexture.contentHash) != m_decodedContentHashes.end())
+            {
+                decodedTexture.isDuplicate = true;
+                decodedTexture.isValid = true;
+            }
+            else
+            {
+                DecodeFileContents(request.filePath, contents, decodedTexture);
+            }
+        }
+
+        if (decodedTexture.isValid)
+        {
+            m_decodedContentHashes.insert(decodedTexture.contentHash);
+        }
+        decodedTexture.generation = request.generation;
+
+        void (*decodedCallback)() = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_decodedTextures.push_back(std::move(decodedTexture));
+            m_isDecoding = false;
+            decodedCallback = m_decodedCallback;
+        }
+        if (decodedCallback != nullptr)
+        {
+            decodedCallback();
+        }
+    }
+}
+
+/**
+ * @brief Reads a file in chunks, hashing each chunk as it arrives.
+ * @param[in] filePath File path
+ * @param[out] outContents File contents
+ * @param[out] outContentHash Hash of the file contents
+ * @return Returns true if the file was read successfully. Returns false otherwise.
+ */
+bool TextureStreamer::ReadFileContents(const std::string& filePath, std::vector<uint8_t>& outContents, uint64_t& outContentHash)
+{
+    PROFILE_FUNCTION();
+
+    std::ifstream file(filePath, std::ios::ate | std::ios::binary);
+    if (file.fail())
+    {
+        return false;
+    }
+
+    size_t fileSize = static_cast<size_t>(file.tellg());
+    outContents.resize(fileSize);
+    file.seekg(0);
+
+    outContentHash = CONTENT_HASH_OFFSET_BASIS;
+    for (size_t offset = 0; offset < fileSize; offset += FILE_READ_CHUNK_SIZE)
+    {
+        size_t chunkSize = std::min(static_cast<size_t>(FILE_READ_CHUNK_SIZE), fileSize - offset);
+        if (!file.read(reinterpret_cast<char*>(outContents.data() + offset), chunkSize))
+        {
+            return false;
+        }
+        outContentHash = ComputeContentHash(outContents.data() + offset, chunkSize, outContentHash);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Decodes the contents of an image file and generates its mip chain.
+ * @param[in] filePath File path, used for error messages
+ * @param[in] contents File contents
+ * @param[out] outTexture Decoded texture. The key and content hash must already be set.
+ * @return Returns true if the texture was decoded successfully. Returns false otherwise.
+ */
+bool TextureStreamer::DecodeFileContents(const std::string& filePath, const std::vector<uint8_t>& contents, DecodedTexture& outTexture)
+{
+    PROFILE_FUNCTION();
+
+    ImageData image;
+    if (!DecodeImageFile(contents.data(), contents.size(), image))
+    {
+        std::cout << "Failed to load image " << filePath << std::endl;
+        return false;
+    }
+
+    uint64_t contentHash = outTexture.contentHash;
+    bool ret = DecodeImage(outTexture.key, image, outTexture);
+    outTexture.contentHash = contentHash;
+    return ret;
+}
+
+/**
+ * @brief Decodes an image file that is already in memory, keeping its channel count and bit depth.
+ * Grayscale and grayscale+alpha images keep 1 and 2 channels, RGB images get an opaque alpha channel,
+ * and 16-bit images keep 16 bits per channel. The color channels of 16-bit images are converted from sRGB
+ * to linear, because they are uploaded to UNORM formats that the sampler does not decode.
+ * @param[in] data File contents
+ * @param[in] size Size of the file contents in bytes
+ * @param[out] outImage Decoded image
+ * @return Returns true if the image was decoded successfully. Returns false otherwise.
+ */
+bool TextureStreamer::DecodeImageFile(const uint8_t* data, const size_t& size, ImageData& outImage)
+{
+    outImage = {};
+
+    int textureWidth, textureHeight, textureNumChannels;
+    if (!stbi_info_from_memory(data, static_cast<int>(size), &textureWidth, &textureHeight, &textureNumChannels))
+    {
+        return false;
+    }
+
+    // Three-channel formats are poorly supported for sampling, so RGB images get an alpha channel
+    int numChannels = (textureNumChannels == STBI_rgb) ? STBI_rgb_alpha : textureNumChannels;
+
+    void* pixels = nullptr;
+    if (stbi_is_16_bit_from_memory(data, static_cast<int>(size)))
+    {
+        pixels = stbi_load_16_from_memory(data, static_cast<int>(size), &textureWidth, &textureHeight, &textureNumChannels, numChannels);
+        outImage.bytesPerChannel = 2;
+    }
+    else
+    {
+        pixels = stbi_load_from_memory(data, static_cast<int>(size), &textureWidth, &textureHeight, &textureNumChannels, numChannels);
+        outImage.bytesPerChannel = 1;
+    }
+
+    if (pixels == nullptr)
+    {
+        return false;
+    }
+
+    if (outImage.bytesPerChannel == 2)
+    {
+        // The alpha channel is always the last one of grayscale+alpha and RGBA images, and is already linear
+        uint16_t* channels = reinterpret_cast<uint16_t*>(pixels);
+        const size_t numPixels = static_cast<size_t>(textureWidth) * textureHeight;
+        const int numColorChannels = (numChannels <= STBI_grey_alpha) ? 1 : 3;
+        for (size_t p = 0; p < numPixels; ++p)
+        {
+            for (int c = 0; c < numColorChannels; ++c)
+            {
+                channels[p * numChannels + c] = DecodeSRGB16(channels[p * numChannels + c]);
+            }
+        }
+    }
+
+    outImage.width = static_cast<uint32_t>(textureWidth);
+    outImage.height = static_cast<uint32_t>(textureHeight);
+    outImage.numChannels = static_cast<uint32_t>(numChannels);
+    outImage.isBGRA = false;
+    outImage.pixels = std::shared_ptr<const uint8_t>(reinterpret_cast<const uint8_t*>(pixels), [](const uint8_t* data) { stbi_image_free(const_cast<uint8_t*>(data)); });
+    return true;
+}
+
+/**
+ * @brief Converts a decoded texture and its mip chain to 8-bit RGBA, for devices that cannot sample its original format.
+ * @param[in,out] texture Decoded texture
+ */
+void TextureStreamer::ConvertToRGBA8(DecodedTexture& texture)
+{
+    if ((texture.numChannels == 4) && (texture.bytesPerChannel == 1))
+    {
+        return;
+    }
+
+    const uint32_t numChannels = texture.numChannels;
+    const uint32_t bytesPerChannel = texture.bytesPerChannel;
+    const uint32_t numColorChannels = (numChannels <= 2) ? 1 : 3;
+
+    std::vector<MipLevel> mipLevels = texture.mipLevels;
+    size_t mipStorageSize = 0;
+    for (size_t i = 0; i < mipLevels.size(); ++i)
+    {
+        mipLevels[i].offset = (i == 0) ? 0 : mipStorageSize;
+        mipLevels[i].size = static_cast<size_t>(mipLevels[i].width) * mipLevels[i].height * 4;
+        if (i > 0)
+        {
+            mipStorageSize += mipLevels[i].size;
+        }
+    }
+
+    uint8_t* basePixels = new uint8_t[mipLevels[0].size];
+    std::vector<uint8_t> mipStorage(mipStorageSize);
+    for (uint32_t i = 0; i < static_cast<uint32_t>(mipLevels.size()); ++i)
+    {
+        const uint8_t* srcPixels = texture.GetMipLevelPixels(i);
+        uint8_t* dstPixels = (i == 0) ? basePixels : mipStorage.data() + mipLevels[i].offset;
+        size_t numPixels = static_cast<size_t>(mipLevels[i].width) * mipLevels[i].height;
+        for (size_t p = 0; p < numPixels; ++p)
+        {
+            // 16-bit color channels are linear and are encoded back to sRGB, 16-bit alpha keeps its most significant byte
+            uint8_t channels[4] = { 0, 0, 0, 255 };
+            for (uint32_t c = 0; c < numChannels; ++c)
+            {
+                if (bytesPerChannel == 2)
+                {
+                    const uint16_t value = reinterpret_cast<const uint16_t*>(srcPixels)[p * numChannels + c];
+                    channels[c] = (c < numColorChannels) ? EncodeSRGB8(value) : static_cast<uint8_t>(value >> 8);
+                }
+                else
+                {
+                    channels[c] = srcPixels[p * numChannels + c];
+                }
+            }
+
+            if (numChannels <= 2)
+            {
+                // Grayscale (+ alpha)
+                dstPixels[p * 4 + 0] = channels[0];
+                dstPixels[p * 4 + 1] = channels[0];
+                dstPixels[p * 4 + 2] = channels[0];
+                dstPixels[p * 4 + 3] = (numChannels == 2) ? channels[1] : 255;
+            }
+            else
+            {
+                dstPixels[p * 4 + 0] = channels[0];
+                dstPixels[p * 4 + 1] = channels[1];
+                dstPixels[p * 4 + 2] = channels[2];
+                dstPixels[p * 4 + 3] = channels[3];
+            }
+        }
+    }
+
+    texture.numChannels = 4;
+    texture.bytesPerChannel = 1;
+    texture.basePixels = std::shared_ptr<const uint8_t>(basePixels, std::default_delete<const uint8_t[]>());
+    texture.mipStorage = std::move(mipStorage);
+    texture.mipLevels = std::move(mipLevels);
+}
+
+/**
+ * @brief Converts a linear 16-bit channel value to 8-bit sRGB.
+ * @param[in] value Linear channel value
+ * @return sRGB channel value
+ */
+uint8_t TextureStreamer::EncodeSRGB8(const uint16_t& value)
+{
+    static const std::vector<uint8_t> table = []()
+    {
+        std::vector<uint8_t> ret(UINT16_MAX + 1);
+        for (uint32_t i = 0; i <= UINT16_MAX; ++i)
+        {
+            float linear = static_cast<float>(i) / UINT16_MAX;
+            float srgb = (linear <= 0.0031308f) ? (linear * 12.92f) : (1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f);
+            ret[i] = static_cast<uint8_t>(std::lround(std::min(std::max(srgb, 0.0f), 1.0f) * UINT8_MAX));
+        }
+        return ret;
+    }();
+
+    return table[value];
+}
+
+/**
+ * @brief Converts a 16-bit sRGB channel value to linear.
+ * @param[in] value sRGB channel value
+ * @return Linear channel value
+ */
+uint16_t TextureStreamer::DecodeSRGB16(const uint16_t& value)
+{
+    static const std::vector<uint16_t> table = []()
+    {
+        std::vector<uint16_t> ret(UINT16_MAX + 1);
+        for (uint32_t i = 0; i <= UINT16_MAX; ++i)
+        {
+            float srgb = static_cast<float>(i) / UINT16_MAX;
+            float linear = (srgb <= 0.04045f) ? (srgb / 12.92f) : std::pow((srgb + 0.055f) / 1.055f, 2.4f);
+            ret[i] = static_cast<uint16_t>(std::lround(std::min(std::max(linear, 0.0f), 1.0f) * UINT16_MAX));
+        }
+        return ret;
+    }();
+
+    return table[value];
+}
+
+/**
+ * @brief Computes the hash of a block of data using 64-bit FNV-1a.
+ * @param[in] data Data
+ * @param[in] size Size of the data in bytes
+ * @param[in] hash Hash of the preceding data, used to hash data in chunks
+ * @return Hash of the data
+ */
+uint64_t TextureStreamer::ComputeContentHash(const uint8_t* data, const size_t& size, uint64_t hash)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= data[i];
+        hash *= CONTENT_HASH_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * @brief Generates the mip chain of a decoded texture using a box filter.
+ * @param[in,out] texture Decoded texture
+ */
+void TextureStreamer::GenerateMipChain(DecodedTexture& texture)
+{
+    PROFILE_FUNCTION();
+
+    const uint32_t numChannels = texture.numChannels;
+    const size_t bytesPerPixel = static_cast<size_t>(numChannels) * texture.bytesPerChannel;
+
+    texture.mipLevels.clear();
+    texture.mipLevels.push_back({ texture.width, texture.height, 0, static_cast<size_t>(texture.width) * texture.height * bytesPerPixel });
+
+    const uint32_t maxMipLevels = (texture.maxMipLevels > 0) ? texture.maxMipLevels : UINT32_MAX;
+
+    // Allocate the storage for the whole chain up front
+    size_t mipStorageSize = 0;
+    uint32_t width = texture.width;
+    uint32_t height = texture.height;
+    uint32_t numMipLevels = 1;
+    while (((width > 1) || (height > 1)) && (numMipLevels < maxMipLevels))
+    {
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+        mipStorageSize += static_cast<size_t>(width) * height * bytesPerPixel;
+        ++numMipLevels;
+    }
+    texture.mipStorage.resize(mipStorageSize);
+
+    size_t offset = 0;
+    while (((texture.mipLevels.back().width > 1) || (texture.mipLevels.back().height > 1)) && (texture.mipLevels.size() < maxMipLevels))
+    {
+        const uint32_t srcMipLevel = static_cast<uint32_t>(texture.mipLevels.size()) - 1;
+        const MipLevel src = texture.mipLevels[srcMipLevel];
+
+        MipLevel dst = {};
+        dst.width = std::max(src.width / 2, 1u);
+        dst.height = std::max(src.height / 2, 1u);
+        dst.offset = offset;
+        dst.size = static_cast<size_t>(dst.width) * dst.height * bytesPerPixel;
+
+        const uint8_t* srcPixels = texture.GetMipLevelPixels(srcMipLevel);
+        uint8_t* dstPixels = texture.mipStorage.data() + offset;
+        if (texture.bytesPerChannel == 2)
+        {
+            DownsampleMipLevel(reinterpret_cast<const uint16_t*>(srcPixels), src, reinterpret_cast<uint16_t*>(dstPixels), dst, numChannels);
+        }
+        else
+        {
+            DownsampleMipLevel(srcPixels, src, dstPixels, dst, numChannels);
+        }
+
+        texture.mipLevels.push_back(dst);
+        offset += dst.size;
+    }
+}
+
+/**
+ * @brief Checks whether any pixel of an image is not fully opaque.
+ * @param[in] image Decoded image
+ * @return Returns true if the image has an alpha channel with a value below the maximum. Returns false otherwise.
+ */
+bool TextureStreamer::HasTransparentPixels(const ImageData& image)
+{
+    // Only grayscale+alpha and RGBA images have an alpha channel, which is always the last one
+    if ((image.pixels == nullptr) || ((image.numChannels != 2) && (image.numChannels != 4)))
+    {
+        return false;
+    }
+
+    const size_t numPixels = static_cast<size_t>(image.width) * image.height;
+    const uint32_t alphaChannel = image.numChannels - 1;
+    if (image.bytesPerChannel == 2)
+    {
+        const uint16_t* pixels = reinterpret_cast<const uint16_t*>(image.pixels.get());
+        for (size_t p = 0; p < numPixels; ++p)
+        {
+            if (pixels[p * image.numChannels + alphaChannel] != UINT16_MAX)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const uint8_t* pixels = image.pixels.get();
+    for (size_t p = 0; p < numPixels; ++p)
+    {
+        if (pixels[p * image.numChannels + alphaChannel] != UINT8_MAX)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Downsamples a mip level to half its size using a box filter.
+ * @param[in] srcPixels Pixel data of the source mip level
+ * @param[in] src Source mip level
+ * @param[out] dstPixels Pixel data of the destination mip level
+ * @param[in] dst Destination mip level
+ * @param[in] numChannels Number of channels per pixel
+ */
+template <typename T>
+void TextureStreamer::DownsampleMipLevel(const T* srcPixels, const MipLevel& src, T* dstPixels, const MipLevel& dst, const uint32_t& numChannels)
+{
+    for (uint32_t y = 0; y < dst.height; ++y)
+    {
+        // Clamp the second row/column for odd-sized levels
+        const uint32_t y0 = std::min(y * 2, src.height - 1);
+        const uint32_t y1 = std::min(y * 2 + 1, src.height - 1);
+        for (uint32_t x = 0; x < dst.width; ++x)
+        {
+            const uint32_t x0 = std::min(x * 2, src.width - 1);
+            const uint32_t x1 = std::min(x * 2 + 1, src.width - 1);
+            for (uint32_t c = 0; c < numChannels; ++c)
+            {
+                uint32_t sum = srcPixels[(static_cast<size_t>(y0) * src.width + x0) * numChannels + c]
+                    + srcPixels[(static_cast<size_t>(y0) * src.width + x1) * numChannels + c]
+                    + srcPixels[(static_cast<size_t>(y1) * src.width + x0) * numChannels + c]
+                    + srcPixels[(static_cast<size_t>(y1) * src.width + x1) * numChannels + c];
+                dstPixels[(static_cast<size_t>(y) * dst.width + x) * numChannels + c] = static_cast<T>((sum + 2) / 4);
+            }
+        }
+    }
+}
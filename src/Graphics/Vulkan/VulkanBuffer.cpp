@@ -10,6 +10,9 @@
  * @brief Constructor
  */
 VulkanBuffer::VulkanBuffer()
+    : m_vkBuffer(VK_NULL_HANDLE)
+    , m_vkMemory(VK_NULL_HANDLE)
+    , m_memorySize(0)
 {
 }
 
@@ -61,6 +64,7 @@ bool VulkanBuffer::Create(VkDeviceSize bufferSize, VkBufferUsageFlags usageFlags
         std::cout << "Failed to allocate memory for the buffer!" << std::endl;
         return false;
     }
+    m_memorySize = memoryRequirements.size;
 
     // --- Bind the buffer to the memory ---
     vkBindBufferMemory(VulkanContext::GetLogicalDevice(), m_vkBuffer, m_vkMemory, 0);
@@ -104,6 +108,8 @@ void VulkanBuffer::Cleanup()
         vkFreeMemory(VulkanContext::GetLogicalDevice(), m_vkMemory, nullptr);
         m_vkMemory = VK_NULL_HANDLE;
     }
+
+    m_memorySize = 0;
 }
 
 /**
@@ -114,6 +120,15 @@ VkBuffer VulkanBuffer::GetHandle()
     return m_vkBuffer;
 }
 
+/**
+ * @brief Gets the size of the GPU memory allocated for this buffer
+ * @return Size of the allocated memory in bytes. Returns 0 if the buffer has not been created.
+ */
+VkDeviceSize VulkanBuffer::GetMemorySize() const
+{
+    return m_memorySize;
+}
+
 /**
  * @brief Find the index of a suitable memory type given the requirements
  * @param[in] memoryTypeBits Flag containing the supported memory types
@@ -1,5 +1,9 @@
 #include "Graphics/Vulkan/VulkanContext.hpp"
 
+#include "IO/FileIO.hpp"
+
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <set>
 
@@ -12,7 +16,7 @@ VulkanContext::~VulkanContext()
 
 /**
  * @brief Initializes the Vulkan manager.
- * @param[in] window GLFW window
+ * @param[in] window GLFW window. If null, the context is initialized without a surface for headless rendering.
  * @return Returns true if the initialization was successful. Returns false otherwise.
  */
 bool VulkanContext::Initialize(GLFWwindow* window)
@@ -109,6 +113,64 @@ VkCommandPool VulkanContext::GetDefaultCommandPool()
     return GetSingletonInstance().m_vkDefaultCommandPool;
 }
 
+/**
+ * @brief Gets the pipeline cache shared by all pipeline creation. It is loaded from disk on initialization
+ * and saved back on cleanup.
+ * @return Returns the pipeline cache, or VK_NULL_HANDLE if it could not be created.
+ */
+VkPipelineCache VulkanContext::GetPipelineCache()
+{
+    return GetSingletonInstance().m_vkPipelineCache;
+}
+
+/**
+ * @brief Submits a batch to the graphics queue. Each submission gets a monotonically increasing
+ * timeline value that can be waited on or polled.
+ * @param[in] submitInfo Batch to submit. Its wait and signal semaphores must be binary semaphores.
+ * @param[out] outSubmission Timeline value signaled when the batch completes
+ * @return Returns true if the submission was successful. Returns false otherwise.
+ */
+bool VulkanContext::SubmitToGraphicsQueue(const VkSubmitInfo& submitInfo, uint64_t& outSubmission)
+{
+    return GetSingletonInstance().m_graphicsTimeline.Submit(GetGraphicsQueue(), submitInfo, outSubmission);
+}
+
+/**
+ * @brief Gets the timeline value of the most recent submission that has completed, without blocking.
+ * @return Completed timeline value
+ */
+uint64_t VulkanContext::GetCompletedSubmission()
+{
+    return GetSingletonInstance().m_graphicsTimeline.GetCompletedValue();
+}
+
+/**
+ * @brief Gets the timeline value of the last submission to the graphics queue.
+ * @return Last submitted timeline value
+ */
+uint64_t VulkanContext::GetLastSubmission()
+{
+    return GetSingletonInstance().m_graphicsTimeline.GetLastSubmittedValue();
+}
+
+/**
+ * @brief Blocks until a submission has completed.
+ * @param[in] submission Timeline value of the submission. 0 returns immediately.
+ */
+void VulkanContext::WaitForSubmission(const uint64_t& submission)
+{
+    GetSingletonInstance().m_graphicsTimeline.Wait(submission);
+}
+
+/**
+ * @brief Checks whether submissions are tracked with a timeline semaphore instead of fences.
+ * @return Returns true if timeline semaphores are supported. Returns false otherwise.
+ */
+bool VulkanContext::IsTimelineSemaphoreSupported()
+{
+    return GetSingletonInstance().m_graphicsTimeline.IsUsingTimelineSemaphore();
+}
+
 /**
  * @brief Begins a single use command buffer.
  * @return Returns the command buffer that was created.
@@ -146,8 +208,10 @@ void VulkanContext::EndSingleUseCommandBuffer(VkCommandBuffer commandBuffer)
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &commandBuffer;
 
-    vkQueueSubmit(GetGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(GetGraphicsQueue());
+    // Only this submission is waited on, not everything else in the queue
+    uint64_t submission = 0;
+    SubmitToGraphicsQueue(submitInfo, submission);
+    WaitForSubmission(submission);
 
     vkFreeCommandBuffers(GetLogicalDevice(), GetDefaultCommandPool(), 1, &commandBuffer);
 }
@@ -164,6 +228,8 @@ VulkanContext::VulkanContext()
     , m_vkGraphicsQueue(VK_NULL_HANDLE)
     , m_vkPresentQueue(VK_NULL_HANDLE)
     , m_vkDefaultCommandPool(VK_NULL_HANDLE)
+    , m_vkPipelineCache(VK_NULL_HANDLE)
+    , m_graphicsTimeline()
 {
 }
 
@@ -179,7 +245,7 @@ VulkanContext& VulkanContext::GetSingletonInstance()
 
 /**
  * @brief Initialization code implemented as a member function.
- * @param[in] window GLFW window
+ * @param[in] window GLFW window. If null, the context is initialized without a surface for headless rendering.
  * @return Returns true if the initialization was successful. Returns false otherwise.
  */
 bool VulkanContext::InitInternal(GLFWwindow* window)
@@ -197,22 +263,39 @@ bool VulkanContext::InitInternal(GLFWwindow* window)
     applicationInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
     applicationInfo.pEngineName = "No Engine";
     applicationInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-    applicationInfo.apiVersion = VK_API_VERSION_1_0;
+
+    // Request Vulkan 1.2 if the loader supports it, for timeline semaphores.
+    // Vulkan 1.0 loaders do not have vkEnumerateInstanceVersion.
+    uint32_t instanceApiVersion = VK_API_VERSION_1_0;
+    PFN_vkEnumerateInstanceVersion pfnEnumerateInstanceVersion =
+        reinterpret_cast<PFN_vkEnumerateInstanceVersion>(vkGetInstanceProcAddr(VK_NULL_HANDLE, "vkEnumerateInstanceVersion"));
+    if ((pfnEnumerateInstanceVersion == nullptr) || (pfnEnumerateInstanceVersion(&instanceApiVersion) != VK_SUCCESS))
+    {
+        instanceApiVersion = VK_API_VERSION_1_0;
+    }
+    instanceApiVersion = std::min(instanceApiVersion, static_cast<uint32_t>(VK_API_VERSION_1_2));
+    applicationInfo.apiVersion = instanceApiVersion;
 
     VkInstanceCreateInfo instanceCreateInfo = {};
     instanceCreateInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
     instanceCreateInfo.pApplicationInfo = &applicationInfo;
 
-    // Get GLFW required extensions for vulkan and include them in the instance creation
-    uint32_t glfwExtensionCount = 0;
-    const char** glfwExtensionNames = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-    instanceCreateInfo.enabledExtensionCount = glfwExtensionCount;
-    instanceCreateInfo.ppEnabledExtensionNames = glfwExtensionNames;
+    // Get GLFW required extensions for vulkan and include them in the instance creation.
+    // Headless rendering has no surface, so it does not need any instance extensions.
+    if (window != nullptr)
+    {
+        uint32_t glfwExtensionCount = 0;
+        const char** glfwExtensionNames = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+        instanceCreateInfo.enabledExtensionCount = glfwExtensionCount;
+        instanceCreateInfo.ppEnabledExtensionNames = glfwExtensionNames;
+    }
 
-    // Include validation layers
-    // TODO: Have a check whether the validation layer is supported or not
-    instanceCreateInfo.enabledLayerCount = static_cast<uint32_t>(validationLayers.size());
-    instanceCreateInfo.ppEnabledLayerNames = validationLayers.data();
+    // Include validation layers, but only if they are installed (e.g., CI machines usually only have the driver)
+    if (CheckValidationLayerSupport(validationLayers))
+    {
+        instanceCreateInfo.enabledLayerCount = static_cast<uint32_t>(validationLayers.size());
+        instanceCreateInfo.ppEnabledLayerNames = validationLayers.data();
+    }
 
     VkResult instanceCreateResult = vkCreateInstance(&instanceCreateInfo, nullptr, &m_vkInstance);
     if (instanceCreateResult != VK_SUCCESS)
@@ -223,7 +306,7 @@ bool VulkanContext::InitInternal(GLFWwindow* window)
     }
 
     // --- Create surface ---
-    if (glfwCreateWindowSurface(m_vkInstance, window, nullptr, &m_vkSurface) != VK_SUCCESS)
+    if ((window != nullptr) && (glfwCreateWindowSurface(m_vkInstance, window, nullptr, &m_vkSurface) != VK_SUCCESS))
     {
         std::cout << "Failed to create GLFW window surface!" << std::endl;
         Cleanup();
@@ -235,9 +318,12 @@ bool VulkanContext::InitInternal(GLFWwindow* window)
     // (To be used when creating the logical device)
     std::vector<const char*> requiredExtensionNames =
     {
-        VK_KHR_SWAPCHAIN_EXTENSION_NAME,
         VK_KHR_SHADER_DRAW_PARAMETERS_EXTENSION_NAME // To allow the use of gl_BaseInstance in the shader
     };
+    if (window != nullptr)
+    {
+        requiredExtensionNames.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    }
 
     m_vkPhysicalDevice = GetFirstSuitablePhysicalDevice(m_vkInstance, requiredExtensionNames);
     if (m_vkPhysicalDevice == VK_NULL_HANDLE)
@@ -270,9 +356,22 @@ bool VulkanContext::InitInternal(GLFWwindow* window)
     VkPhysicalDeviceFeatures physicalDeviceFeatures = {};
     physicalDeviceFeatures.samplerAnisotropy = VK_TRUE; // Enable anisotropic filtering
 
+    // Timeline semaphores are optional. Without them, submissions are tracked with fences.
+    bool usesTimelineSemaphoreExtension = false;
+    bool isTimelineSemaphoreSupported = CheckTimelineSemaphoreSupport(m_vkPhysicalDevice, instanceApiVersion, usesTimelineSemaphoreExtension);
+    if (isTimelineSemaphoreSupported && usesTimelineSemaphoreExtension)
+    {
+        requiredExtensionNames.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+    }
+
+    VkPhysicalDeviceTimelineSemaphoreFeatures timelineSemaphoreFeatures = {};
+    timelineSemaphoreFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+    timelineSemaphoreFeatures.timelineSemaphore = VK_TRUE;
+
     // --- Create a logical device associated with the physical device ---
     VkDeviceCreateInfo logicalDeviceCreateInfo = {};
     logicalDeviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    logicalDeviceCreateInfo.pNext = isTimelineSemaphoreSupported ? &timelineSemaphoreFeatures : nullptr;
     logicalDeviceCreateInfo.pEnabledFeatures = &physicalDeviceFeatures;
     logicalDeviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfoStructs.size());
     logicalDeviceCreateInfo.pQueueCreateInfos = queueCreateInfoStructs.data();
@@ -290,6 +389,14 @@ bool VulkanContext::InitInternal(GLFWwindow* window)
     vkGetDeviceQueue(m_vkLogicalDevice, m_queueFamilyIndices.graphicsQueueFamilyIndex.value(), 0, &m_vkGraphicsQueue);
     vkGetDeviceQueue(m_vkLogicalDevice, m_queueFamilyIndices.presentQueueFamilyIndex.value(), 0, &m_vkPresentQueue);
 
+    if (!m_graphicsTimeline.Create(m_vkLogicalDevice, isTimelineSemaphoreSupported, usesTimelineSemaphoreExtension))
+    {
+        CleanupInternal();
+        return false;
+    }
+    std::cout << (m_graphicsTimeline.IsUsingTimelineSemaphore()
+        ? "Tracking submissions with a timeline semaphore" : "Timeline semaphores are unavailable, tracking submissions with fences") << std::endl;
+
     VkCommandPoolCreateInfo commandPoolInfo = {};
     commandPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
     commandPoolInfo.queueFamilyIndex = GetGraphicsQueueIndex();
@@ -302,6 +409,12 @@ bool VulkanContext::InitInternal(GLFWwindow* window)
         return false;
     }
 
+    if (!CreatePipelineCache())
+    {
+        CleanupInternal();
+        return false;
+    }
+
     return true;
 }
 
@@ -310,6 +423,21 @@ bool VulkanContext::InitInternal(GLFWwindow* window)
  */
 void VulkanContext::CleanupInternal()
 {
+    // Destroy the submission timeline once nothing is pending anymore
+    if (m_vkLogicalDevice != VK_NULL_HANDLE)
+    {
+        vkDeviceWaitIdle(m_vkLogicalDevice);
+        m_graphicsTimeline.Cleanup();
+    }
+
+    // Save and destroy the pipeline cache
+    if (m_vkPipelineCache != VK_NULL_HANDLE)
+    {
+        SavePipelineCache();
+        vkDestroyPipelineCache(m_vkLogicalDevice, m_vkPipelineCache, nullptr);
+        m_vkPipelineCache = VK_NULL_HANDLE;
+    }
+
     // Destroy default command pool
     if (m_vkDefaultCommandPool != VK_NULL_HANDLE)
     {
@@ -352,13 +480,17 @@ VkPhysicalDevice VulkanContext::GetFirstSuitablePhysicalDevice(const VkInstance&
     uint32_t physicalDeviceCount = 0;
     vkEnumeratePhysicalDevices(instance, &physicalDeviceCount, nullptr);
 
+    // Fallback in case there is no discrete GPU (e.g., integrated GPUs, or software
+    // implementations like lavapipe on machines without a GPU)
+    VkPhysicalDevice fallbackPhysicalDevice = VK_NULL_HANDLE;
+
     if (physicalDeviceCount > 0)
     {
         std::vector<VkPhysicalDevice> physicalDevices(physicalDeviceCount);
         vkEnumeratePhysicalDevices(instance, &physicalDeviceCount, physicalDevices.data());
 
         // Go through each physical device, and check whether it is suitable or not.
-        // Once we find one, we return the device immediately.
+        // Once we find a discrete GPU, we return the device immediately.
         for (const VkPhysicalDevice& physicalDevice : physicalDevices)
         {
             // Check if the graphics card supported the provided extensions.
@@ -382,21 +514,28 @@ VkPhysicalDevice VulkanContext::GetFirstSuitablePhysicalDevice(const VkInstance&
                 continue;
             }
 
+            QueueFamilyIndices indices = GetQueueFamilyIndices(physicalDevice, m_vkSurface);
+            if (!indices.graphicsQueueFamilyIndex.has_value() || !indices.presentQueueFamilyIndex.has_value())
+            {
+                continue;
+            }
+
             // We can have a scoring system for each physical device and get the highest scoring
             // one (criteria depends on our requirements). But for now, we'll just settle with the
             // first discrete GPU that we find.
             if (physicalDeviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
             {
-                QueueFamilyIndices indices = GetQueueFamilyIndices(physicalDevice, m_vkSurface);
-                if (indices.graphicsQueueFamilyIndex.has_value() && indices.presentQueueFamilyIndex.has_value())
-                {
-                    return physicalDevice;
-                }
+                return physicalDevice;
+            }
+
+            if (fallbackPhysicalDevice == VK_NULL_HANDLE)
+            {
+                fallbackPhysicalDevice = physicalDevice;
             }
         }
     }
 
-    return VK_NULL_HANDLE;
+    return fallbackPhysicalDevice;
 }
 
 /**
@@ -423,9 +562,80 @@ bool VulkanContext::CheckDeviceExtensionSupport(VkPhysicalDevice physicalDevice,
     return extensionNamesSet.empty();
 }
 
+/**
+ * @brief Checks whether the physical device supports timeline semaphores, either through Vulkan 1.2 or
+ * through the VK_KHR_timeline_semaphore extension.
+ * @param[in] physicalDevice Physical device
+ * @param[in] instanceApiVersion API version the instance was created with
+ * @param[out] outUsesExtension Flag indicating whether the extension needs to be enabled
+ * @return Returns true if timeline semaphores are supported. Returns false otherwise.
+ */
+bool VulkanContext::CheckTimelineSemaphoreSupport(VkPhysicalDevice physicalDevice, const uint32_t& instanceApiVersion, bool& outUsesExtension)
+{
+    outUsesExtension = false;
+
+    // The feature can only be queried with vkGetPhysicalDeviceFeatures2, which is core in Vulkan 1.1
+    if (instanceApiVersion < VK_API_VERSION_1_1)
+    {
+        return false;
+    }
+
+    VkPhysicalDeviceProperties physicalDeviceProperties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
+    if ((instanceApiVersion < VK_API_VERSION_1_2) || (physicalDeviceProperties.apiVersion < VK_API_VERSION_1_2))
+    {
+        if (!CheckDeviceExtensionSupport(physicalDevice, { VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME }))
+        {
+            return false;
+        }
+        outUsesExtension = true;
+    }
+
+    VkPhysicalDeviceTimelineSemaphoreFeatures timelineSemaphoreFeatures = {};
+    timelineSemaphoreFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+
+    // Loaded at runtime, so that the application still starts with Vulkan 1.0 loaders
+    PFN_vkGetPhysicalDeviceFeatures2 pfnGetPhysicalDeviceFeatures2 =
+        reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2>(vkGetInstanceProcAddr(m_vkInstance, "vkGetPhysicalDeviceFeatures2"));
+    if (pfnGetPhysicalDeviceFeatures2 == nullptr)
+    {
+        return false;
+    }
+
+    VkPhysicalDeviceFeatures2 physicalDeviceFeatures = {};
+    physicalDeviceFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    physicalDeviceFeatures.pNext = &timelineSemaphoreFeatures;
+    pfnGetPhysicalDeviceFeatures2(physicalDevice, &physicalDeviceFeatures);
+
+    return (timelineSemaphoreFeatures.timelineSemaphore == VK_TRUE);
+}
+
+/**
+ * @brief Checks whether all the provided validation layers are installed.
+ * @param[in] layerNames List of layer names to check support
+ * @return Returns true if all the provided layers are supported. Returns false otherwise.
+ */
+bool VulkanContext::CheckValidationLayerSupport(const std::vector<const char*>& layerNames)
+{
+    uint32_t numSupportedLayers = 0;
+    vkEnumerateInstanceLayerProperties(&numSupportedLayers, nullptr);
+
+    std::vector<VkLayerProperties> supportedLayers(numSupportedLayers);
+    vkEnumerateInstanceLayerProperties(&numSupportedLayers, supportedLayers.data());
+
+    std::set<std::string> layerNamesSet(layerNames.begin(), layerNames.end());
+    for (const VkLayerProperties& layer : supportedLayers)
+    {
+        layerNamesSet.erase(layer.layerName);
+    }
+
+    return layerNamesSet.empty();
+}
+
 /**
  * @brief Get the indices of each queue type in the physical device's queue family.
  * @param[in] physicalDevice Physical device
+ * @param[in] surface Surface. If null, the graphics queue is also used as the present queue.
  * @return Returns a QueueFamilyIndices struct which contains the indices for each queue type.
  */
 VulkanContext::QueueFamilyIndices VulkanContext::GetQueueFamilyIndices(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface)
@@ -446,12 +656,20 @@ VulkanContext::QueueFamilyIndices VulkanContext::GetQueueFamilyIndices(VkPhysica
             ret.graphicsQueueFamilyIndex = i;
         }
 
-        // Check if the queue family supports presentation capabilities
-        VkBool32 presentationSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &presentationSupport);
-        if (presentationSupport)
+        // Check if the queue family supports presentation capabilities.
+        // Without a surface there is nothing to present to, so the graphics queue is used for both.
+        if (surface == VK_NULL_HANDLE)
         {
-            ret.presentQueueFamilyIndex = i;
+            ret.presentQueueFamilyIndex = ret.graphicsQueueFamilyIndex;
+        }
+        else
+        {
+            VkBool32 presentationSupport = false;
+            vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &presentationSupport);
+            if (presentationSupport)
+            {
+                ret.presentQueueFamilyIndex = i;
+            }
         }
 
         if (ret.graphicsQueueFamilyIndex.has_value() && ret.presentQueueFamilyIndex.has_value())
@@ -461,4 +679,96 @@ VulkanContext::QueueFamilyIndices VulkanContext::GetQueueFamilyIndices(VkPhysica
     }
 
     return ret;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Creates the pipeline cache, seeded with the data saved by a previous run if it was created
+ * by the same device and driver.
+ * @return Returns true if the creation was successful. Returns false otherwise.
+ */
+bool VulkanContext::CreatePipelineCache()
+{
+    // A missing or stale cache file is not an error; the cache just starts empty
+    std::vector<char> cacheData;
+    if (FileIO::ReadFileAsBinary(PIPELINE_CACHE_FILE_PATH, cacheData) && !IsPipelineCacheDataCompatible(cacheData))
+    {
+        std::cout << "Discarding pipeline cache created by a different device or driver" << std::endl;
+        cacheData.clear();
+    }
+
+    VkPipelineCacheCreateInfo pipelineCacheInfo = {};
+    pipelineCacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    pipelineCacheInfo.initialDataSize = cacheData.size();
+    pipelineCacheInfo.pInitialData = cacheData.empty() ? nullptr : cacheData.data();
+
+    if (vkCreatePipelineCache(m_vkLogicalDevice, &pipelineCacheInfo, nullptr, &m_vkPipelineCache) != VK_SUCCESS)
+    {
+        std::cout << "Failed to create pipeline cache!" << std::endl;
+        return false;
+    }
+
+    std::cout << "Loaded " << cacheData.size() << " bytes of pipeline cache data" << std::endl;
+
+    return true;
+}
+
+/**
+ * @brief Saves the contents of the pipeline cache to disk.
+ */
+void VulkanContext::SavePipelineCache()
+{
+    size_t dataSize = 0;
+    if (vkGetPipelineCacheData(m_vkLogicalDevice, m_vkPipelineCache, &dataSize, nullptr) != VK_SUCCESS)
+    {
+        std::cout << "Failed to get pipeline cache data size!" << std::endl;
+        return;
+    }
+
+    std::vector<char> cacheData(dataSize);
+    if (vkGetPipelineCacheData(m_vkLogicalDevice, m_vkPipelineCache, &dataSize, cacheData.data()) != VK_SUCCESS)
+    {
+        std::cout << "Failed to get pipeline cache data!" << std::endl;
+        return;
+    }
+    cacheData.resize(dataSize);
+
+    if (!FileIO::WriteFileAsBinary(PIPELINE_CACHE_FILE_PATH, cacheData))
+    {
+        std::cout << "Failed to save pipeline cache to " << PIPELINE_CACHE_FILE_PATH << std::endl;
+    }
+}
+
+/**
+ * @brief Checks whether saved pipeline cache data was created by the current device and driver.
+ * @param[in] data Pipeline cache data
+ * @return Returns true if the data can be used with the current device. Returns false otherwise.
+ */
+bool VulkanContext::IsPipelineCacheDataCompatible(const std::vector<char>& data)
+{
+    // Layout of the header written by the driver at the start of the data (VkPipelineCacheHeaderVersionOne)
+    struct PipelineCacheHeader
+    {
+        uint32_t headerSize;
+        uint32_t headerVersion;
+        uint32_t vendorID;
+        uint32_t deviceID;
+        uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+    };
+
+    if (data.size() < sizeof(PipelineCacheHeader))
+    {
+        return false;
+    }
+
+    PipelineCacheHeader header;
+    memcpy(&header, data.data(), sizeof(PipelineCacheHeader));
+
+    // The pipeline cache UUID changes whenever the driver version changes in a way that invalidates the cache
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_vkPhysicalDevice, &properties);
+    return (header.headerSize >= sizeof(PipelineCacheHeader))
+        && (header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE)
+        && (header.vendorID == properties.vendorID)
+        && (header.deviceID == properties.deviceID)
+        && (memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0);
+}
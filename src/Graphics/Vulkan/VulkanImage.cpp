@@ -11,6 +11,7 @@
 VulkanImage::VulkanImage()
     : m_vkImage(VK_NULL_HANDLE)
     , m_vkMemory(VK_NULL_HANDLE)
+    , m_memorySize(0)
 {
 }
 
@@ -30,9 +31,10 @@ VulkanImage::~VulkanImage()
  * @param[in] tiling Image tiling type
  * @param[in] usageFlags Vulkan flags indicating how the image will be used
  * @param[in] memoryProperties Properties describing how to allocate memory for this image
+ * @param[in] mipLevels Number of mip levels
  * @reutnr Returns true if the creation was successful. Returns false otherwise.
  */
-bool VulkanImage::Create(const uint32_t& width, const uint32_t& height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usageFlags, VkMemoryPropertyFlags memoryProperties)
+bool VulkanImage::Create(const uint32_t& width, const uint32_t& height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usageFlags, VkMemoryPropertyFlags memoryProperties, const uint32_t& mipLevels)
 {
     VkImageCreateInfo imageInfo = {};
     imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -40,7 +42,7 @@ bool VulkanImage::Create(const uint32_t& width, const uint32_t& height, VkFormat
     imageInfo.extent.width = width;
     imageInfo.extent.height = height;
     imageInfo.extent.depth = 1;
-    imageInfo.mipLevels = 1;
+    imageInfo.mipLevels = mipLevels;
     imageInfo.arrayLayers = 1;
     imageInfo.format = format;
     imageInfo.tiling = tiling;
@@ -67,6 +69,7 @@ bool VulkanImage::Create(const uint32_t& width, const uint32_t& height, VkFormat
         std::cout << "Failed to allocate memory for the image!" << std::endl;
         return false;
     }
+    m_memorySize = memoryRequirements.size;
 
     vkBindImageMemory(VulkanContext::GetLogicalDevice(), m_vkImage, m_vkMemory, 0);
 
@@ -88,6 +91,8 @@ void VulkanImage::Cleanup()
         vkFreeMemory(VulkanContext::GetLogicalDevice(), m_vkMemory, nullptr);
         m_vkMemory = VK_NULL_HANDLE;
     }
+
+    m_memorySize = 0;
 }
 
 /**
@@ -99,6 +104,15 @@ VkImage VulkanImage::GetHandle()
     return m_vkImage;
 }
 
+/**
+ * @brief Gets the size of the GPU memory allocated for this image.
+ * @return Size of the allocated memory in bytes. Returns 0 if the image has not been created.
+ */
+VkDeviceSize VulkanImage::GetMemorySize() const
+{
+    return m_memorySize;
+}
+
 /**
  * @brief Find the index of a suitable memory type given the requirements
  * @param[in] memoryTypeBits Flag containing the supported memory types
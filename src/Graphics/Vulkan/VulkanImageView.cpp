@@ -24,9 +24,12 @@ VulkanImageView::~VulkanImageView()
  * @param[in] image Vulkan image
  * @param[in] format Vulkan image format
  * @param[in] imageAspectFlags Vulkan image aspect flags
+ * @param[in] baseMipLevel First mip level accessible to the view
+ * @param[in] mipLevelCount Number of mip levels accessible to the view
+ * @param[in] components Component swizzle applied when the view is sampled
  * @return Returns true if the creation was successful. Returns false otherwise.
  */
-bool VulkanImageView::Create(VkImage image, VkFormat format, VkImageAspectFlags imageAspectFlags)
+bool VulkanImageView::Create(VkImage image, VkFormat format, VkImageAspectFlags imageAspectFlags, const uint32_t& baseMipLevel, const uint32_t& mipLevelCount, const VkComponentMapping& components)
 {
     VkImageViewCreateInfo imageViewCreateInfo = {};
     imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -34,14 +37,11 @@ bool VulkanImageView::Create(VkImage image, VkFormat format, VkImageAspectFlags
     imageViewCreateInfo.format = format;
     imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
 
-    imageViewCreateInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
-    imageViewCreateInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
-    imageViewCreateInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
-    imageViewCreateInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+    imageViewCreateInfo.components = components;
 
     imageViewCreateInfo.subresourceRange.aspectMask = imageAspectFlags;
-    imageViewCreateInfo.subresourceRange.baseMipLevel = 0;
-    imageViewCreateInfo.subresourceRange.levelCount = 1;
+    imageViewCreateInfo.subresourceRange.baseMipLevel = baseMipLevel;
+    imageViewCreateInfo.subresourceRange.levelCount = mipLevelCount;
     imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
     imageViewCreateInfo.subresourceRange.layerCount = 1;
 
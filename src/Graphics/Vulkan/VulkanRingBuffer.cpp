@@ -0,0 +1,120 @@
+#include "Graphics/Vulkan/VulkanRingBuffer.hpp"
+
+#include <iostream>
+
+/**
+ * @brief Constructor
+ */
+VulkanRingBuffer::VulkanRingBuffer()
+    : m_buffer()
+    , m_mappedData(nullptr)
+    , m_frameSize(0)
+    , m_frameEnd(0)
+    , m_head(0)
+{
+}
+
+/**
+ * @brief Destructor
+ */
+VulkanRingBuffer::~VulkanRingBuffer()
+{
+}
+
+/**
+ * @brief Creates and maps the buffer.
+ * @param[in] frameSize Size in bytes of the region of each frame in flight, including alignment padding
+ * @param[in] numFramesInFlight Number of frames in flight
+ * @param[in] usageFlags Vulkan flags describing how the buffer will be used
+ * @return Returns true if the creation was successful. Returns false otherwise.
+ */
+bool VulkanRingBuffer::Create(const VkDeviceSize& frameSize, const uint32_t& numFramesInFlight, VkBufferUsageFlags usageFlags)
+{
+    VkDeviceSize bufferSize = frameSize * numFramesInFlight;
+    if (!m_buffer.Create(bufferSize, usageFlags, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+    {
+        std::cout << "Failed to create ring buffer!" << std::endl;
+        return false;
+    }
+
+    // The memory is coherent, so it stays mapped instead of being mapped and unmapped every frame
+    m_mappedData = static_cast<uint8_t*>(m_buffer.MapMemory(0, bufferSize));
+    if (m_mappedData == nullptr)
+    {
+        std::cout << "Failed to map ring buffer!" << std::endl;
+        return false;
+    }
+
+    m_frameSize = frameSize;
+    m_frameEnd = 0;
+    m_head = 0;
+
+    return true;
+}
+
+/**
+ * @brief Unmaps and destroys the buffer.
+ */
+void VulkanRingBuffer::Cleanup()
+{
+    if (m_mappedData != nullptr)
+    {
+        m_buffer.UnmapMemory();
+        m_mappedData = nullptr;
+    }
+    m_buffer.Cleanup();
+
+    m_frameSize = 0;
+    m_frameEnd = 0;
+    m_head = 0;
+}
+
+/**
+ * @brief Starts allocating from the region of a frame in flight, discarding its previous allocations.
+ * The previous submission of the frame must have completed.
+ * @param[in] frameIndex Index of the frame in flight
+ */
+void VulkanRingBuffer::BeginFrame(const uint32_t& frameIndex)
+{
+    m_head = m_frameSize * frameIndex;
+    m_frameEnd = m_head + m_frameSize;
+}
+
+/**
+ * @brief Allocates memory from the current frame's region.
+ * @param[in] size Size in bytes
+ * @param[in] alignment Required alignment of the offset (e.g., minUniformBufferOffsetAlignment)
+ * @param[out] outOffset Offset of the allocation from the start of the buffer
+ * @return Pointer to the mapped memory of the allocation. Returns nullptr if the region is full.
+ */
+void* VulkanRingBuffer::Allocate(const VkDeviceSize& size, const VkDeviceSize& alignment, uint32_t& outOffset)
+{
+    // Vulkan guarantees that the offset alignment limits are powers of two
+    VkDeviceSize offset = (m_head + alignment - 1) & ~(alignment - 1);
+    if ((m_mappedData == nullptr) || (offset + size > m_frameEnd))
+    {
+        return nullptr;
+    }
+
+    m_head = offset + size;
+    outOffset = static_cast<uint32_t>(offset);
+    return m_mappedData + offset;
+}
+
+/**
+ * @brief Gets the Vulkan buffer handle.
+ * @return Vulkan buffer handle
+ */
+VkBuffer VulkanRingBuffer::GetHandle()
+{
+    return m_buffer.GetHandle();
+}
+
+/**
+ * @brief Gets the size of the GPU memory allocated for the buffer.
+ * @return Size of the allocated memory in bytes. Returns 0 if the buffer has not been created.
+ */
+VkDeviceSize VulkanRingBuffer::GetMemorySize() const
+{
+    return m_buffer.GetMemorySize();
+}
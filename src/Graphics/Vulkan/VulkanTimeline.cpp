@@ -0,0 +1,277 @@
+#include "Graphics/Vulkan/VulkanTimeline.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#define MAX_SIGNAL_SEMAPHORES 8
+
+/**
+ * @brief Constructor
+ */
+VulkanTimeline::VulkanTimeline()
+    : m_vkDevice(VK_NULL_HANDLE)
+    , m_vkTimelineSemaphore(VK_NULL_HANDLE)
+    , m_pfnWaitSemaphores(nullptr)
+    , m_pfnGetSemaphoreCounterValue(nullptr)
+    , m_lastSubmittedValue(0)
+    , m_completedValue(0)
+    , m_pendingFences()
+    , m_freeFences()
+{
+}
+
+/**
+ * @brief Destructor
+ */
+VulkanTimeline::~VulkanTimeline()
+{
+}
+
+/**
+ * @brief Creates the timeline.
+ * @param[in] device Logical device
+ * @param[in] useTimelineSemaphore Flag indicating whether the timelineSemaphore feature is enabled on the device
+ * @param[in] useExtensionEntryPoints Flag indicating whether the feature comes from VK_KHR_timeline_semaphore instead of Vulkan 1.2
+ * @return Returns true if the creation was successful. Returns false otherwise.
+ */
+bool VulkanTimeline::Create(VkDevice device, const bool& useTimelineSemaphore, const bool& useExtensionEntryPoints)
+{
+    m_vkDevice = device;
+    m_lastSubmittedValue = 0;
+    m_completedValue = 0;
+
+    if (!useTimelineSemaphore)
+    {
+        return true;
+    }
+
+    m_pfnWaitSemaphores = reinterpret_cast<PFN_vkWaitSemaphores>(
+        vkGetDeviceProcAddr(device, useExtensionEntryPoints ? "vkWaitSemaphoresKHR" : "vkWaitSemaphores"));
+    m_pfnGetSemaphoreCounterValue = reinterpret_cast<PFN_vkGetSemaphoreCounterValue>(
+        vkGetDeviceProcAddr(device, useExtensionEntryPoints ? "vkGetSemaphoreCounterValueKHR" : "vkGetSemaphoreCounterValue"));
+    if ((m_pfnWaitSemaphores == nullptr) || (m_pfnGetSemaphoreCounterValue == nullptr))
+    {
+        // Fences still work, so this is not an error
+        std::cout << "Failed to load the timeline semaphore functions, falling back to fences" << std::endl;
+        m_pfnWaitSemaphores = nullptr;
+        m_pfnGetSemaphoreCounterValue = nullptr;
+        return true;
+    }
+
+    VkSemaphoreTypeCreateInfo semaphoreTypeCreateInfo = {};
+    semaphoreTypeCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    semaphoreTypeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    semaphoreTypeCreateInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreCreateInfo = {};
+    semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreCreateInfo.pNext = &semaphoreTypeCreateInfo;
+
+    if (vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &m_vkTimelineSemaphore) != VK_SUCCESS)
+    {
+        std::cout << "Failed to create timeline semaphore!" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Cleans up the resources used by the timeline. No submission may be pending.
+ */
+void VulkanTimeline::Cleanup()
+{
+    if (m_vkTimelineSemaphore != VK_NULL_HANDLE)
+    {
+        vkDestroySemaphore(m_vkDevice, m_vkTimelineSemaphore, nullptr);
+        m_vkTimelineSemaphore = VK_NULL_HANDLE;
+    }
+
+    for (const PendingFence& pendingFence : m_pendingFences)
+    {
+        vkDestroyFence(m_vkDevice, pendingFence.fence, nullptr);
+    }
+    m_pendingFences.clear();
+
+    for (VkFence fence : m_freeFences)
+    {
+        vkDestroyFence(m_vkDevice, fence, nullptr);
+    }
+    m_freeFences.clear();
+
+    m_pfnWaitSemaphores = nullptr;
+    m_pfnGetSemaphoreCounterValue = nullptr;
+    m_vkDevice = VK_NULL_HANDLE;
+}
+
+/**
+ * @brief Submits a batch to a queue and signals the next timeline value when it completes.
+ * @param[in] queue Queue to submit to
+ * @param[in] submitInfo Batch to submit. Its wait and signal semaphores must be binary semaphores,
+ * and it may signal at most 7 of them.
+ * @param[out] outValue Timeline value signaled when the batch completes
+ * @return Returns true if the submission was successful. Returns false otherwise.
+ */
+bool VulkanTimeline::Submit(VkQueue queue, const VkSubmitInfo& submitInfo, uint64_t& outValue)
+{
+    uint64_t value = m_lastSubmittedValue + 1;
+
+    if (m_vkTimelineSemaphore != VK_NULL_HANDLE)
+    {
+        // The timeline semaphore is signaled along with the caller's binary semaphores, whose values are ignored.
+        // The lists live on the stack, since this runs for every submission.
+        if (submitInfo.signalSemaphoreCount >= MAX_SIGNAL_SEMAPHORES)
+        {
+            std::cout << "Failed to submit: too many signal semaphores (" << submitInfo.signalSemaphoreCount << ")" << std::endl;
+            return false;
+        }
+
+        const uint32_t numSignalSemaphores = submitInfo.signalSemaphoreCount + 1;
+        VkSemaphore signalSemaphores[MAX_SIGNAL_SEMAPHORES];
+        uint64_t signalValues[MAX_SIGNAL_SEMAPHORES] = {};
+        std::copy(submitInfo.pSignalSemaphores, submitInfo.pSignalSemaphores + submitInfo.signalSemaphoreCount, signalSemaphores);
+        signalSemaphores[numSignalSemaphores - 1] = m_vkTimelineSemaphore;
+        signalValues[numSignalSemaphores - 1] = value;
+
+        VkTimelineSemaphoreSubmitInfo timelineSubmitInfo = {};
+        timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineSubmitInfo.pNext = submitInfo.pNext;
+        timelineSubmitInfo.signalSemaphoreValueCount = numSignalSemaphores;
+        timelineSubmitInfo.pSignalSemaphoreValues = signalValues;
+
+        VkSubmitInfo timelineSubmit = submitInfo;
+        timelineSubmit.pNext = &timelineSubmitInfo;
+        timelineSubmit.signalSemaphoreCount = numSignalSemaphores;
+        timelineSubmit.pSignalSemaphores = signalSemaphores;
+
+        if (vkQueueSubmit(queue, 1, &timelineSubmit, VK_NULL_HANDLE) != VK_SUCCESS)
+        {
+            return false;
+        }
+    }
+    else
+    {
+        VkFence fence = AcquireFence();
+        if (fence == VK_NULL_HANDLE)
+        {
+            return false;
+        }
+
+        if (vkQueueSubmit(queue, 1, &submitInfo, fence) != VK_SUCCESS)
+        {
+            m_freeFences.push_back(fence);
+            return false;
+        }
+        m_pendingFences.push_back({ fence, value });
+    }
+
+    m_lastSubmittedValue = value;
+    outValue = value;
+    return true;
+}
+
+/**
+ * @brief Gets the highest timeline value whose submission has completed, without blocking.
+ * @return Completed timeline value
+ */
+uint64_t VulkanTimeline::GetCompletedValue()
+{
+    if (m_vkTimelineSemaphore != VK_NULL_HANDLE)
+    {
+        uint64_t value = 0;
+        if (m_pfnGetSemaphoreCounterValue(m_vkDevice, m_vkTimelineSemaphore, &value) == VK_SUCCESS)
+        {
+            m_completedValue = std::max(m_completedValue, value);
+        }
+        return m_completedValue;
+    }
+
+    // Submissions to a queue complete in order, so only the oldest pending fences need to be checked
+    while (!m_pendingFences.empty() && (vkGetFenceStatus(m_vkDevice, m_pendingFences.front().fence) == VK_SUCCESS))
+    {
+        m_completedValue = m_pendingFences.front().value;
+        vkResetFences(m_vkDevice, 1, &m_pendingFences.front().fence);
+        m_freeFences.push_back(m_pendingFences.front().fence);
+        m_pendingFences.pop_front();
+    }
+    return m_completedValue;
+}
+
+/**
+ * @brief Gets the timeline value of the last submission.
+ * @return Last submitted timeline value
+ */
+uint64_t VulkanTimeline::GetLastSubmittedValue() const
+{
+    return m_lastSubmittedValue;
+}
+
+/**
+ * @brief Blocks until the submission with the given timeline value has completed.
+ * Values that were never submitted (e.g., 0) return immediately.
+ * @param[in] value Timeline value
+ */
+void VulkanTimeline::Wait(const uint64_t& value)
+{
+    uint64_t targetValue = std::min(value, m_lastSubmittedValue);
+    if (targetValue <= m_completedValue)
+    {
+        return;
+    }
+
+    if (m_vkTimelineSemaphore != VK_NULL_HANDLE)
+    {
+        VkSemaphoreWaitInfo waitInfo = {};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &m_vkTimelineSemaphore;
+        waitInfo.pValues = &targetValue;
+        if (m_pfnWaitSemaphores(m_vkDevice, &waitInfo, UINT64_MAX) == VK_SUCCESS)
+        {
+            m_completedValue = std::max(m_completedValue, targetValue);
+        }
+        return;
+    }
+
+    // Values are consecutive, so the pending fence of the target value is found by its distance from the oldest one
+    if (!m_pendingFences.empty() && (targetValue >= m_pendingFences.front().value))
+    {
+        const PendingFence& pendingFence = m_pendingFences[targetValue - m_pendingFences.front().value];
+        vkWaitForFences(m_vkDevice, 1, &pendingFence.fence, VK_TRUE, UINT64_MAX);
+    }
+    GetCompletedValue();
+}
+
+/**
+ * @brief Checks whether submissions are tracked with a timeline semaphore.
+ * @return Returns true if a timeline semaphore is used. Returns false if fences are used instead.
+ */
+bool VulkanTimeline::IsUsingTimelineSemaphore() const
+{
+    return (m_vkTimelineSemaphore != VK_NULL_HANDLE);
+}
+
+/**
+ * @brief Takes a fence from the free list, or creates a new one if the list is empty.
+ * @return Fence, or VK_NULL_HANDLE if the creation failed
+ */
+VkFence VulkanTimeline::AcquireFence()
+{
+    if (!m_freeFences.empty())
+    {
+        VkFence fence = m_freeFences.back();
+        m_freeFences.pop_back();
+        return fence;
+    }
+
+    VkFenceCreateInfo fenceCreateInfo = {};
+    fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+    VkFence fence = VK_NULL_HANDLE;
+    if (vkCreateFence(m_vkDevice, &fenceCreateInfo, nullptr, &fence) != VK_SUCCESS)
+    {
+        std::cout << "Failed to create submission fence!" << std::endl;
+        return VK_NULL_HANDLE;
+    }
+    return fence;
+}
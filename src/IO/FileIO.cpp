@@ -27,5 +27,25 @@ namespace FileIO
 
         return true;
     }
+
+    /**
+     * @brief Write the provided contents to the specified file as binary, replacing the file if it exists.
+     * @param[in] filePath File path
+     * @param[in] fileContents Contents to write
+     * @return Returns true if the file was successfully written. Returns false otherwise.
+     */
+    bool WriteFileAsBinary(const std::string& filePath, const std::vector<char>& fileContents)
+    {
+        std::ofstream file(filePath, std::ios::trunc | std::ios::binary);
+        if (file.fail())
+        {
+            return false;
+        }
+
+        file.write(fileContents.data(), fileContents.size());
+        file.close();
+
+        return !file.fail();
+    }
 }
 
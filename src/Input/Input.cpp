@@ -15,6 +15,7 @@ Input::Input()
     , m_mouseDeltaY(0)
     , m_mouseScrollX(0)
     , m_mouseScrollY(0)
+    , m_hasEvents(false)
 {
 }
 
@@ -150,11 +151,31 @@ int Input::GetMouseScrollY()
     return GetInstance().m_mouseScrollY;
 }
 
+/**
+ * @brief Has any input event been received since the input manager was last prepared?
+ * @return True if an input event was received. False otherwise.
+ */
+bool Input::HasEvents()
+{
+    return GetInstance().m_hasEvents;
+}
+
+/**
+ * @brief Is any key or button being held down?
+ * @return True if at least one key or button is held down. False otherwise.
+ */
+bool Input::IsAnyDown()
+{
+    return !GetInstance().m_heldKeys.empty();
+}
+
 /**
  * @brief Prepare the input manager for polling its new state
  */
 void Input::Prepare()
 {
+    GetInstance().m_hasEvents = false;
+
     GetInstance().m_pressedKeys.clear();
     GetInstance().m_releasedKeys.clear();
 
@@ -175,6 +196,8 @@ void Input::Prepare()
  */
 void Input::KeyCallback(GLFWwindow* window, int key, int scanCode, int action, int mods)
 {
+    GetInstance().m_hasEvents = true;
+
     if (action == GLFW_PRESS)
     {
         GetInstance().m_pressedKeys.insert(key);
@@ -198,6 +221,8 @@ void Input::KeyCallback(GLFWwindow* window, int key, int scanCode, int action, i
  */
 void Input::MouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
 {
+    GetInstance().m_hasEvents = true;
+
     if (action == GLFW_PRESS)
     {
         GetInstance().m_pressedKeys.insert(button);
@@ -220,6 +245,8 @@ void Input::MouseButtonCallback(GLFWwindow* window, int button, int action, int
  */
 void Input::MouseScrollCallback(GLFWwindow* window, double xOffset, double yOffset)
 {
+    GetInstance().m_hasEvents = true;
+
     GetInstance().m_mouseScrollX = static_cast<int>(xOffset);
     GetInstance().m_mouseScrollY = static_cast<int>(yOffset);
 }
@@ -232,6 +259,8 @@ void Input::MouseScrollCallback(GLFWwindow* window, double xOffset, double yOffs
  */
 void Input::CursorCallback(GLFWwindow* window, double xPos, double yPos)
 {
+    GetInstance().m_hasEvents = true;
+
     int currentMouseX = static_cast<int>(floor(xPos));
     int currentMouseY = static_cast<int>(floor(yPos));
 
@@ -251,6 +280,8 @@ void Input::CursorCallback(GLFWwindow* window, double xPos, double yPos)
  */
 void Input::CursorEnterCallback(GLFWwindow* window, int entered)
 {
+    GetInstance().m_hasEvents = true;
+
     if (entered)
     {
         double mouseX, mouseY;
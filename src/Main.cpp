@@ -1,11 +1,18 @@
 #include "Application.hpp"
 
-int main()
+int main(int argc, char** argv)
 {
+    Application::LaunchOptions launchOptions;
+    if (!Application::ParseLaunchOptions(argc, argv, launchOptions))
     {
-        Application application;
+        Application::PrintUsage(argv[0]);
+        return 1;
+    }
+
+    {
+        Application application(launchOptions);
         application.Run();
     }
-    
+
     return 0;
 }
@@ -0,0 +1,287 @@
+#include "Profiling/CpuProfiler.hpp"
+
+#include "Benchmark/BenchmarkReport.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+/**
+ * @brief Constructor. Starts the zone.
+ * @param[in] name Zone name. Must point to a string that outlives the profiler (e.g., a string literal).
+ */
+CpuProfiler::ScopedZone::ScopedZone(const char* name)
+    : m_name(nullptr)
+    , m_startTime(0)
+{
+    CpuProfiler& profiler = GetSingletonInstance();
+    if (!profiler.m_isEnabled.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    m_name = name;
+    ++profiler.GetThreadBuffer().depth;
+    m_startTime = GetTime();
+}
+
+/**
+ * @brief Destructor. Ends the zone.
+ */
+CpuProfiler::ScopedZone::~ScopedZone()
+{
+    if (m_name == nullptr)
+    {
+        return;
+    }
+
+    uint64_t endTime = GetTime();
+    ThreadBuffer& threadBuffer = GetSingletonInstance().GetThreadBuffer();
+    --threadBuffer.depth;
+
+    uint64_t numWrittenZones = threadBuffer.numWrittenZones.load(std::memory_order_relaxed);
+    threadBuffer.zones[numWrittenZones % ZONES_PER_THREAD] = { m_name, m_startTime, endTime, threadBuffer.depth };
+    threadBuffer.numWrittenZones.store(numWrittenZones + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Destructor. Releases the ring buffer.
+ */
+CpuProfiler::ThreadBufferOwner::~ThreadBufferOwner()
+{
+    if (threadBuffer != nullptr)
+    {
+        GetSingletonInstance().ReleaseThreadBuffer(*threadBuffer);
+    }
+}
+
+/**
+ * @brief Constructor
+ */
+CpuProfiler::CpuProfiler()
+    : m_threadBuffers()
+    , m_threadBuffersMutex()
+    , m_isEnabled(true)
+    , m_epoch(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count())
+{
+}
+
+/**
+ * @brief Destructor
+ */
+CpuProfiler::~CpuProfiler()
+{
+}
+
+/**
+ * @brief Enables or disables recording. Zones that start while recording is disabled are dropped.
+ * @param[in] isEnabled Flag indicating whether to record zones
+ */
+void CpuProfiler::SetEnabled(const bool& isEnabled)
+{
+    GetSingletonInstance().m_isEnabled.store(isEnabled, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Checks whether zones are being recorded.
+ * @return Returns true if zones are being recorded. Returns false otherwise.
+ */
+bool CpuProfiler::IsEnabled()
+{
+    return GetSingletonInstance().m_isEnabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Names the calling thread in the flame chart and in exported traces.
+ * @param[in] threadName Thread name
+ */
+void CpuProfiler::SetThreadName(const std::string& threadName)
+{
+    CpuProfiler& profiler = GetSingletonInstance();
+    ThreadBuffer& threadBuffer = profiler.GetThreadBuffer();
+
+    std::lock_guard<std::mutex> lock(profiler.m_threadBuffersMutex);
+    threadBuffer.threadName = threadName;
+}
+
+/**
+ * @brief Gets the current time on the profiler's clock.
+ * @return Time (in nanoseconds since the profiler was created)
+ */
+uint64_t CpuProfiler::GetTime()
+{
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    return static_cast<uint64_t>(now - GetSingletonInstance().m_epoch);
+}
+
+/**
+ * @brief Copies the zones of every thread that finished within a time range. Zones that were overwritten
+ * in a thread's ring buffer are missing.
+ * @param[in] startTime Start of the time range (in nanoseconds since the profiler was created)
+ * @param[in] endTime End of the time range (in nanoseconds since the profiler was created)
+ * @param[out] outThreadZones Zones of each thread
+ */
+void CpuProfiler::GetZones(const uint64_t& startTime, const uint64_t& endTime, std::vector<ThreadZones>& outThreadZones)
+{
+    CpuProfiler& profiler = GetSingletonInstance();
+    std::lock_guard<std::mutex> lock(profiler.m_threadBuffersMutex);
+
+    outThreadZones.clear();
+    std::vector<Zone> zones;
+    for (const std::unique_ptr<ThreadBuffer>& threadBuffer : profiler.m_threadBuffers)
+    {
+        CopyZones(*threadBuffer, zones);
+
+        ThreadZones threadZones = {};
+        threadZones.threadName = threadBuffer->threadName;
+        threadZones.threadId = threadBuffer->threadId;
+        for (const Zone& zone : zones)
+        {
+            if ((zone.endTime >= startTime) && (zone.startTime <= endTime))
+            {
+                threadZones.zones.push_back(zone);
+            }
+        }
+        outThreadZones.push_back(std::move(threadZones));
+    }
+}
+
+/**
+ * @brief Finds the most recent zone with the specified name recorded on the calling thread.
+ * @param[in] name Zone name
+ * @param[out] outZone Zone
+ * @return Returns true if a zone was found. Returns false otherwise.
+ */
+bool CpuProfiler::FindLatestZone(const std::string& name, Zone& outZone)
+{
+    // The calling thread is the only writer of its own buffer, so it can read it without copying
+    const ThreadBuffer& threadBuffer = GetSingletonInstance().GetThreadBuffer();
+    uint64_t numWrittenZones = threadBuffer.numWrittenZones.load(std::memory_order_relaxed);
+    uint64_t numZones = std::min<uint64_t>(numWrittenZones, ZONES_PER_THREAD);
+    for (uint64_t i = 1; i <= numZones; ++i)
+    {
+        const Zone& zone = threadBuffer.zones[(numWrittenZones - i) % ZONES_PER_THREAD];
+        if (name == zone.name)
+        {
+            outZone = zone;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Writes all the zones that are still in the ring buffers into a Chrome trace JSON file.
+ * @param[in] filePath Output file path
+ * @return Returns true if the file was written successfully. Returns false otherwise.
+ */
+bool CpuProfiler::WriteChromeTrace(const std::string& filePath)
+{
+    std::vector<ThreadZones> threadZones;
+    GetZones(0, UINT64_MAX, threadZones);
+
+    std::ofstream file(filePath);
+    if (file.fail())
+    {
+        std::cout << "Failed to open " << filePath << " for writing!" << std::endl;
+        return false;
+    }
+
+    // Complete ("X") events with microsecond timestamps, plus a metadata event naming each thread
+    file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [" << std::endl;
+    bool isFirstEvent = true;
+    for (const ThreadZones& thread : threadZones)
+    {
+        file << (isFirstEvent ? "" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << thread.threadId
+            << ", \"args\": {\"name\": \"" << BenchmarkReport::EscapeJSON(thread.threadName) << "\"}}";
+        isFirstEvent = false;
+
+        for (const Zone& zone : thread.zones)
+        {
+            file << ",\n{\"name\": \"" << BenchmarkReport::EscapeJSON(zone.name) << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << thread.threadId
+                << ", \"ts\": " << zone.startTime / 1000.0 << ", \"dur\": " << (zone.endTime - zone.startTime) / 1000.0 << "}";
+        }
+    }
+    file << std::endl << "]}" << std::endl;
+
+    return true;
+}
+
+/**
+ * @brief Gets the singleton instance for this class.
+ * @return Returns the singleton instance for this class.
+ */
+CpuProfiler& CpuProfiler::GetSingletonInstance()
+{
+    static CpuProfiler instance;
+    return instance;
+}
+
+/**
+ * @brief Gets the ring buffer of the calling thread, taking a free one or creating one the first time.
+ * @return Ring buffer of the calling thread
+ */
+CpuProfiler::ThreadBuffer& CpuProfiler::GetThreadBuffer()
+{
+    thread_local ThreadBufferOwner owner;
+    if (owner.threadBuffer != nullptr)
+    {
+        return *owner.threadBuffer;
+    }
+
+    std::lock_guard<std::mutex> lock(m_threadBuffersMutex);
+
+    // The zones of the exited thread stay in the reused buffer until they are overwritten. They do not overlap
+    // with the new thread's zones in time, so they share its row in the flame chart and in traces.
+    for (const std::unique_ptr<ThreadBuffer>& threadBuffer : m_threadBuffers)
+    {
+        if (!threadBuffer->isInUse)
+        {
+            threadBuffer->isInUse = true;
+            threadBuffer->depth = 0;
+            threadBuffer->threadName = "Thread " + std::to_string(threadBuffer->threadId);
+            owner.threadBuffer = threadBuffer.get();
+            return *owner.threadBuffer;
+        }
+    }
+
+    std::unique_ptr<ThreadBuffer> newThreadBuffer = std::make_unique<ThreadBuffer>();
+    newThreadBuffer->threadId = static_cast<uint32_t>(m_threadBuffers.size());
+    newThreadBuffer->threadName = "Thread " + std::to_string(newThreadBuffer->threadId);
+    newThreadBuffer->depth = 0;
+    newThreadBuffer->zones.resize(ZONES_PER_THREAD);
+    newThreadBuffer->numWrittenZones.store(0, std::memory_order_relaxed);
+    newThreadBuffer->isInUse = true;
+    owner.threadBuffer = newThreadBuffer.get();
+    m_threadBuffers.push_back(std::move(newThreadBuffer));
+    return *owner.threadBuffer;
+}
+
+/**
+ * @brief Marks the ring buffer of a thread that exits as free, so that another thread can reuse it.
+ * @param[in] threadBuffer Ring buffer
+ */
+void CpuProfiler::ReleaseThreadBuffer(ThreadBuffer& threadBuffer)
+{
+    std::lock_guard<std::mutex> lock(m_threadBuffersMutex);
+    threadBuffer.isInUse = false;
+}
+
+/**
+ * @brief Copies the zones of a ring buffer that have not been overwritten and are not being written.
+ * @param[in] threadBuffer Ring buffer
+ * @param[out] outZones Zones, in the order they finished
+ */
+void CpuProfiler::CopyZones(const ThreadBuffer& threadBuffer, std::vector<Zone>& outZones)
+{
+    // Only the most recent half of the ring is copied, so that the slots the owning thread writes next are not being read
+    uint64_t numWrittenZones = threadBuffer.numWrittenZones.load(std::memory_order_acquire);
+    uint64_t numZones = std::min<uint64_t>(numWrittenZones, ZONES_PER_THREAD / 2);
+
+    outZones.resize(numZones);
+    for (uint64_t i = 0; i < numZones; ++i)
+    {
+        outZones[i] = threadBuffer.zones[(numWrittenZones - numZones + i) % ZONES_PER_THREAD];
+    }
+}
@@ -0,0 +1,140 @@
+#include "Profiling/LatencyTracker.hpp"
+
+#include <algorithm>
+
+/**
+ * @brief Constructor
+ */
+LatencyTracker::LatencyTracker()
+    : m_pendingFrames()
+    , m_inputToSubmitHistory({ std::vector<float>(HISTORY_LENGTH, 0.0f), 0, 0.0f, 0.0f })
+    , m_submitToPresentHistory({ std::vector<float>(HISTORY_LENGTH, 0.0f), 0, 0.0f, 0.0f })
+    , m_numSamples(0)
+{
+}
+
+/**
+ * @brief Destructor
+ */
+LatencyTracker::~LatencyTracker()
+{
+}
+
+/**
+ * @brief Prepares tracking for the given number of frames in flight, discarding all samples.
+ * @param[in] numFramesInFlight Number of frames in flight
+ */
+void LatencyTracker::Initialize(const uint32_t& numFramesInFlight)
+{
+    m_pendingFrames.assign(numFramesInFlight, { 0, 0.0, 0.0f });
+    m_inputToSubmitHistory = { std::vector<float>(HISTORY_LENGTH, 0.0f), 0, 0.0f, 0.0f };
+    m_submitToPresentHistory = { std::vector<float>(HISTORY_LENGTH, 0.0f), 0, 0.0f, 0.0f };
+    m_numSamples = 0;
+}
+
+/**
+ * @brief Records the submission of a frame.
+ * @param[in] frameIndex Index of the frame in flight
+ * @param[in] submission Graphics queue submission of the frame
+ * @param[in] inputTime Time at which the input used by the frame was sampled (in seconds)
+ * @param[in] submitTime Time at which the frame was submitted (in seconds)
+ */
+void LatencyTracker::RecordSubmit(const uint32_t& frameIndex, const uint64_t& submission, const double& inputTime, const double& submitTime)
+{
+    if (frameIndex >= m_pendingFrames.size())
+    {
+        return;
+    }
+
+    // The previous frame of the slot has completed by the time the slot is reused, so it is completed now
+    // in case no update observed it
+    PendingFrame& pendingFrame = m_pendingFrames[frameIndex];
+    if (pendingFrame.submission != 0)
+    {
+        Update(pendingFrame.submission, submitTime);
+    }
+
+    pendingFrame.submission = submission;
+    pendingFrame.submitTime = submitTime;
+    pendingFrame.inputToSubmit = static_cast<float>((submitTime - inputTime) * 1000.0);
+}
+
+/**
+ * @brief Completes the samples of the frames whose submissions have completed.
+ * @param[in] completedSubmission Last completed graphics queue submission
+ * @param[in] currentTime Current time (in seconds)
+ */
+void LatencyTracker::Update(const uint64_t& completedSubmission, const double& currentTime)
+{
+    // Complete the frames in submission order, so the histories stay in frame order
+    while (true)
+    {
+        PendingFrame* oldestFrame = nullptr;
+        for (PendingFrame& pendingFrame : m_pendingFrames)
+        {
+            if ((pendingFrame.submission != 0) && (pendingFrame.submission <= completedSubmission)
+                && ((oldestFrame == nullptr) || (pendingFrame.submission < oldestFrame->submission)))
+            {
+                oldestFrame = &pendingFrame;
+            }
+        }
+        if (oldestFrame == nullptr)
+        {
+            break;
+        }
+
+        AddToHistory(oldestFrame->inputToSubmit, m_inputToSubmitHistory);
+        AddToHistory(static_cast<float>((currentTime - oldestFrame->submitTime) * 1000.0), m_submitToPresentHistory);
+        ++m_numSamples;
+
+        oldestFrame->submission = 0;
+    }
+}
+
+/**
+ * @brief Gets the input-to-submit latencies of the most recent frames.
+ * @return Input-to-submit latency history
+ */
+const LatencyTracker::LatencyHistory& LatencyTracker::GetInputToSubmitHistory() const
+{
+    return m_inputToSubmitHistory;
+}
+
+/**
+ * @brief Gets the submit-to-present latencies of the most recent frames.
+ * @return Submit-to-present latency history
+ */
+const LatencyTracker::LatencyHistory& LatencyTracker::GetSubmitToPresentHistory() const
+{
+    return m_submitToPresentHistory;
+}
+
+/**
+ * @brief Gets the number of frames whose latencies were fully measured.
+ * @return Number of completed samples
+ */
+uint64_t LatencyTracker::GetSampleCount() const
+{
+    return m_numSamples;
+}
+
+/**
+ * @brief Adds a latency to a history and updates its average.
+ * @param[in] time Latency (in milliseconds)
+ * @param[in,out] history History to add the latency to
+ */
+void LatencyTracker::AddToHistory(const float& time, LatencyHistory& history)
+{
+    history.times[history.offset] = time;
+    history.offset = (history.offset + 1) % HISTORY_LENGTH;
+    history.latest = time;
+
+    // Until the ring buffer is full, only the recorded latencies count towards the average
+    uint64_t numRecordedTimes = std::min<uint64_t>(m_numSamples + 1, HISTORY_LENGTH);
+    float total = 0.0f;
+    for (float recordedTime : history.times)
+    {
+        total += recordedTime;
+    }
+    history.average = total / numRecordedTimes;
+}